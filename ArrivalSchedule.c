@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * FILE NAME    : ArrivalSchedule.c
+ * DATE         : January 13 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "ArrivalSchedule.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : ArrivalScheduleParse
+ *  poisson:<operations per second> or fixed:<operations per second>
+ *****************************************************************************/
+bool
+ArrivalScheduleParse
+(string InSpec, ArrivalScheduleType* InType, double* InRate)
+{
+  char*                                 end;
+  char*                                 rate;
+
+  if ( strncmp(InSpec, "poisson:", 8) == 0 ) {
+    *InType = ARRIVAL_SCHEDULE_POISSON;
+    rate = InSpec + 8;
+  } else if ( strncmp(InSpec, "fixed:", 6) == 0 ) {
+    *InType = ARRIVAL_SCHEDULE_FIXED;
+    rate = InSpec + 6;
+  } else {
+    return false;
+  }
+  *InRate = strtod(rate, &end);
+  return end != rate && *end == 0x00 && *InRate > 0.0;
+}
+
+/*****************************************************************************!
+ * Function : ArrivalScheduleInit
+ *****************************************************************************/
+void
+ArrivalScheduleInit
+(ArrivalSchedule* InSchedule, ArrivalScheduleType InType, double InRate, uint64_t InStart)
+{
+  InSchedule->type     = InType;
+  InSchedule->interval = InRate > 0.0 ? 1000000.0 / InRate : 0.0;
+  InSchedule->next     = (double)InStart;
+}
+
+/*****************************************************************************!
+ * Function : ArrivalScheduleGetNext
+ *  Intended start of the next operation, 0 when there is no schedule
+ *****************************************************************************/
+uint64_t
+ArrivalScheduleGetNext
+(ArrivalSchedule* InSchedule)
+{
+  if ( InSchedule->type == ARRIVAL_SCHEDULE_NONE ) {
+    return 0;
+  }
+  return (uint64_t)InSchedule->next;
+}
+
+/*****************************************************************************!
+ * Function : ArrivalScheduleAdvance
+ *  Poisson arrivals are exponentially distributed intervals around the mean
+ *****************************************************************************/
+void
+ArrivalScheduleAdvance
+(ArrivalSchedule* InSchedule, Random* InRandom)
+{
+  double                                u;
+
+  if ( InSchedule->type == ARRIVAL_SCHEDULE_FIXED ) {
+    InSchedule->next += InSchedule->interval;
+  } else if ( InSchedule->type == ARRIVAL_SCHEDULE_POISSON ) {
+    u = RandomDouble(InRandom);
+    InSchedule->next += -log(u) * InSchedule->interval;
+  }
+}
@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * FILE NAME    : ArrivalSchedule.h
+ * DATE         : January 13 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _arrivalschedule_h_
+#define _arrivalschedule_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "Random.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : ArrivalScheduleType
+ *****************************************************************************/
+enum _ArrivalScheduleType
+{
+  ARRIVAL_SCHEDULE_NONE,
+  ARRIVAL_SCHEDULE_FIXED,
+  ARRIVAL_SCHEDULE_POISSON
+};
+typedef enum _ArrivalScheduleType ArrivalScheduleType;
+
+/*****************************************************************************!
+ * Exported Type : ArrivalSchedule
+ *  Open loop timeline of intended operation start times (microseconds).  The
+ *  timeline does not wait for operations to complete.
+ *****************************************************************************/
+struct _ArrivalSchedule
+{
+  ArrivalScheduleType                   type;
+  double                                interval;
+  double                                next;
+};
+typedef struct _ArrivalSchedule ArrivalSchedule;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+bool
+ArrivalScheduleParse
+(string InSpec, ArrivalScheduleType* InType, double* InRate);
+
+void
+ArrivalScheduleInit
+(ArrivalSchedule* InSchedule, ArrivalScheduleType InType, double InRate, uint64_t InStart);
+
+uint64_t
+ArrivalScheduleGetNext
+(ArrivalSchedule* InSchedule);
+
+void
+ArrivalScheduleAdvance
+(ArrivalSchedule* InSchedule, Random* InRandom);
+
+#endif // _arrivalschedule_h_
@@ -0,0 +1,324 @@
+/*****************************************************************************
+ * FILE NAME    : BlockTarget.c
+ * DATE         : January 19 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/falloc.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "BlockTarget.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define BlockTargetCounterAdd(c, n)     __atomic_fetch_add(&(c), (n), __ATOMIC_RELAXED)
+#define BlockTargetCounterGet(c)        __atomic_load_n(&(c), __ATOMIC_RELAXED)
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+BlockTargetDiscard
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength);
+
+static bool
+BlockTargetZero
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength);
+
+/*****************************************************************************!
+ * Function : BlockTargetOpen
+ *  A device holds as many extents as fit, up to InExtentCount when that is
+ *  set.  An image file is extended (sparse) to hold InExtentCount extents,
+ *  or holds as many as fit in its current size when InExtentCount is 0.
+ *  InFlags are added to the open flags (O_SYNC, O_DSYNC).  Only an image
+ *  named with InCreate is created, otherwise the path must already exist so
+ *  a mistyped device name is not turned into a file.
+ *****************************************************************************/
+BlockTarget*
+BlockTargetOpen
+(string InPath, uint64_t InExtentSize, uint64_t InExtentCount, bool InDirectIO, int InFlags,
+ BlockTargetRelease InRelease, bool InCreate)
+{
+  BlockTarget*                          target;
+  struct stat                           statbuf;
+  int                                   fd, flags, sectorSize;
+  uint64_t                              size, capacity;
+  uint32_t                              alignment;
+  void*                                 zeros;
+
+  if ( NULL == InPath || InExtentSize == 0 ) {
+    return NULL;
+  }
+  flags = O_RDWR | InFlags;
+  if ( InCreate ) {
+    flags |= O_CREAT;
+  }
+  if ( InDirectIO ) {
+    flags |= O_DIRECT;
+  }
+  fd = open(InPath, flags, 0644);
+  if ( fd < 0 && InDirectIO && errno == EINVAL ) {
+    fprintf(stderr, "O_DIRECT not supported for %s : using buffered I/O\n", InPath);
+    InDirectIO = false;
+    fd = open(InPath, flags & ~O_DIRECT, 0644);
+  }
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not open target %s : %s\n", InPath, strerror(errno));
+    return NULL;
+  }
+  if ( fstat(fd, &statbuf) ) {
+    fprintf(stderr, "Could not stat target %s : %s\n", InPath, strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  if ( S_ISBLK(statbuf.st_mode) ) {
+    if ( ioctl(fd, BLKGETSIZE64, &size) || ioctl(fd, BLKSSZGET, &sectorSize) ) {
+      fprintf(stderr, "Could not get the size of %s : %s\n", InPath, strerror(errno));
+      close(fd);
+      return NULL;
+    }
+    alignment = (uint32_t)sectorSize;
+  } else if ( S_ISREG(statbuf.st_mode) ) {
+    size = (uint64_t)statbuf.st_size;
+    alignment = statbuf.st_blksize > 0 ? (uint32_t)statbuf.st_blksize : 4096;
+  } else {
+    fprintf(stderr, "Target %s is not a block device or a regular file\n", InPath);
+    close(fd);
+    return NULL;
+  }
+
+  //! Extents start on an alignment boundary so O_DIRECT, discards and hole
+  //  punches never straddle two slots
+  if ( InExtentSize % alignment ) {
+    InExtentSize += alignment - (InExtentSize % alignment);
+  }
+  capacity = size / InExtentSize;
+  if ( S_ISBLK(statbuf.st_mode) ) {
+    if ( InExtentCount == 0 || InExtentCount > capacity ) {
+      InExtentCount = capacity;
+    }
+  } else {
+    if ( InExtentCount == 0 ) {
+      InExtentCount = capacity;
+    }
+    if ( InExtentCount * InExtentSize > size ) {
+      size = InExtentCount * InExtentSize;
+      if ( ftruncate(fd, (off_t)size) ) {
+        fprintf(stderr, "Could not size image %s : %s\n", InPath, strerror(errno));
+        close(fd);
+        return NULL;
+      }
+    }
+  }
+  if ( InExtentCount == 0 ) {
+    fprintf(stderr, "Target %s is too small for one %llu byte extent\n", InPath,
+            (unsigned long long)InExtentSize);
+    close(fd);
+    return NULL;
+  }
+  if ( posix_memalign(&zeros, alignment, BLOCK_TARGET_ZERO_SIZE) ) {
+    close(fd);
+    return NULL;
+  }
+  memset(zeros, 0x00, BLOCK_TARGET_ZERO_SIZE);
+
+  target = (BlockTarget*)GetMemory(sizeof(BlockTarget));
+  memset(target, 0x00, sizeof(BlockTarget));
+  target->path        = StringCopy(InPath);
+  target->fd          = fd;
+  target->device      = S_ISBLK(statbuf.st_mode);
+  target->directIO    = InDirectIO;
+  target->alignment   = alignment;
+  target->size        = size;
+  target->extentSize  = InExtentSize;
+  target->extentCount = InExtentCount;
+  target->release     = InRelease;
+  target->zeros       = (uint8_t*)zeros;
+  return target;
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetClose
+ *****************************************************************************/
+void
+BlockTargetClose
+(BlockTarget* InTarget)
+{
+  if ( NULL == InTarget ) {
+    return;
+  }
+  close(InTarget->fd);
+  free(InTarget->zeros);
+  FreeMemory(InTarget->path);
+  FreeMemory(InTarget);
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetParseRelease
+ *****************************************************************************/
+bool
+BlockTargetParseRelease
+(string InName, BlockTargetRelease* InRelease)
+{
+  if ( StringEqual(InName, "discard") ) {
+    *InRelease = BLOCK_TARGET_RELEASE_DISCARD;
+    return true;
+  }
+  if ( StringEqual(InName, "zero") ) {
+    *InRelease = BLOCK_TARGET_RELEASE_ZERO;
+    return true;
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetGetReleaseName
+ *****************************************************************************/
+string
+BlockTargetGetReleaseName
+(BlockTargetRelease InRelease)
+{
+  return InRelease == BLOCK_TARGET_RELEASE_DISCARD ? "discard" : "zero";
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetGetOffset
+ *****************************************************************************/
+uint64_t
+BlockTargetGetOffset
+(BlockTarget* InTarget, int64_t InIndex)
+{
+  return (uint64_t)InIndex * InTarget->extentSize;
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetReleaseExtent
+ *  The target side of removing a file.  A target that turns out not to
+ *  support discards switches to zero writes for the rest of the run, the
+ *  workers share it so only the one that makes the switch reports it.
+ *****************************************************************************/
+bool
+BlockTargetReleaseExtent
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength)
+{
+  BlockTargetRelease                    release;
+
+  if ( NULL == InTarget || InLength == 0 ) {
+    return false;
+  }
+  if ( InLength % InTarget->alignment ) {
+    InLength += InTarget->alignment - (InLength % InTarget->alignment);
+  }
+  release = __atomic_load_n(&(InTarget->release), __ATOMIC_RELAXED);
+  if ( release == BLOCK_TARGET_RELEASE_DISCARD ) {
+    if ( BlockTargetDiscard(InTarget, InOffset, InLength) ) {
+      BlockTargetCounterAdd(InTarget->discards, 1);
+      return true;
+    }
+    if ( errno != EOPNOTSUPP && errno != ENOTTY && errno != EINVAL ) {
+      fprintf(stderr, "Could not discard %s at %llu : %s\n", InTarget->path,
+              (unsigned long long)InOffset, strerror(errno));
+      return false;
+    }
+    if ( __atomic_compare_exchange_n(&(InTarget->release), &release, BLOCK_TARGET_RELEASE_ZERO, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+      fprintf(stderr, "Discard not supported for %s : using zero writes\n", InTarget->path);
+    }
+  }
+  return BlockTargetZero(InTarget, InOffset, InLength);
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetDiscard
+ *  BLKDISCARD on a device, a punched hole in an image file
+ *****************************************************************************/
+static bool
+BlockTargetDiscard
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength)
+{
+  uint64_t                              range[2];
+
+  if ( InTarget->device ) {
+    range[0] = InOffset;
+    range[1] = InLength;
+    return ioctl(InTarget->fd, BLKDISCARD, range) == 0;
+  }
+  return fallocate(InTarget->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                   (off_t)InOffset, (off_t)InLength) == 0;
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetZero
+ *****************************************************************************/
+static bool
+BlockTargetZero
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength)
+{
+  uint64_t                              total;
+  ssize_t                               n;
+
+  for ( total = 0 ; total < InLength ; total += n ) {
+    n = InLength - total < BLOCK_TARGET_ZERO_SIZE ? InLength - total : BLOCK_TARGET_ZERO_SIZE;
+    n = pwrite(InTarget->fd, InTarget->zeros, n, (off_t)(InOffset + total));
+    if ( n < 0 ) {
+      if ( errno == EINTR ) {
+        n = 0;
+        continue;
+      }
+      fprintf(stderr, "Could not zero %s at %llu : %s\n", InTarget->path,
+              (unsigned long long)(InOffset + total), strerror(errno));
+      return false;
+    }
+  }
+  BlockTargetCounterAdd(InTarget->bytesZeroed, total);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : BlockTargetToJSON
+ *****************************************************************************/
+JSONOut*
+BlockTargetToJSON
+(string InTag, BlockTarget* InTarget)
+{
+  JSONOut*                              object;
+  BlockTargetRelease                    release;
+
+  release = __atomic_load_n(&(InTarget->release), __ATOMIC_RELAXED);
+  object = JSONOutCreateObject(InTag);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("path", InTarget->path),
+                          JSONOutCreateString("type", InTarget->device ? "device" : "image"),
+                          JSONOutCreateLongLong("size", InTarget->size),
+                          JSONOutCreateLongLong("extentsize", InTarget->extentSize),
+                          JSONOutCreateLongLong("extents", InTarget->extentCount),
+                          JSONOutCreateString("release", BlockTargetGetReleaseName(release)),
+                          JSONOutCreateLongLong("discards", BlockTargetCounterGet(InTarget->discards)),
+                          JSONOutCreateLongLong("byteszeroed", BlockTargetCounterGet(InTarget->bytesZeroed)),
+                          NULL);
+  return object;
+}
@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * FILE NAME    : BlockTarget.h
+ * DATE         : January 19 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _blocktarget_h_
+#define _blocktarget_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "JSONOut.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Size of the zero buffer used for zero-write releases
+#define BLOCK_TARGET_ZERO_SIZE          (1024 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : BlockTargetRelease
+ *  What happens to an extent when its file is removed
+ *****************************************************************************/
+enum _BlockTargetRelease
+{
+  BLOCK_TARGET_RELEASE_DISCARD,
+  BLOCK_TARGET_RELEASE_ZERO
+};
+typedef enum _BlockTargetRelease BlockTargetRelease;
+
+/*****************************************************************************!
+ * Exported Type : BlockTarget
+ *  A block device or preallocated image file used as a flat address space.
+ *  Slot n owns the extentSize bytes starting at n * extentSize.  The
+ *  descriptor is shared by every worker, all I/O on it is positional.
+ *****************************************************************************/
+struct _BlockTarget
+{
+  string                                path;
+  int                                   fd;
+  bool                                  device;
+  bool                                  directIO;
+  uint32_t                              alignment;
+  uint64_t                              size;
+  uint64_t                              extentSize;
+  uint64_t                              extentCount;
+  BlockTargetRelease                    release;
+  uint8_t*                              zeros;
+  uint64_t                              discards;
+  uint64_t                              bytesZeroed;
+};
+typedef struct _BlockTarget BlockTarget;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+BlockTarget*
+BlockTargetOpen
+(string InPath, uint64_t InExtentSize, uint64_t InExtentCount, bool InDirectIO, int InFlags,
+ BlockTargetRelease InRelease, bool InCreate);
+
+void
+BlockTargetClose
+(BlockTarget* InTarget);
+
+bool
+BlockTargetParseRelease
+(string InName, BlockTargetRelease* InRelease);
+
+string
+BlockTargetGetReleaseName
+(BlockTargetRelease InRelease);
+
+uint64_t
+BlockTargetGetOffset
+(BlockTarget* InTarget, int64_t InIndex);
+
+bool
+BlockTargetReleaseExtent
+(BlockTarget* InTarget, uint64_t InOffset, uint64_t InLength);
+
+JSONOut*
+BlockTargetToJSON
+(string InTag, BlockTarget* InTarget);
+
+#endif // _blocktarget_h_
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * FILE NAME    : Checksum.c
+ * DATE         : January 08 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "Checksum.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define CHECKSUM_OFFSET_BASIS           0xCBF29CE484222325ULL
+#define CHECKSUM_PRIME                  0x00000100000001B3ULL
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : ChecksumInit
+ *****************************************************************************/
+void
+ChecksumInit
+(Checksum* InChecksum)
+{
+  InChecksum->hash         = CHECKSUM_OFFSET_BASIS;
+  InChecksum->pending      = 0;
+  InChecksum->pendingBytes = 0;
+}
+
+/*****************************************************************************!
+ * Function : ChecksumUpdate
+ *****************************************************************************/
+void
+ChecksumUpdate
+(Checksum* InChecksum, uint8_t* InData, uint64_t InSize)
+{
+  uint64_t                              word;
+  uint64_t                              hash;
+
+  //! Finish off a word left over from the last update
+  while ( InSize > 0 && InChecksum->pendingBytes > 0 ) {
+    InChecksum->pending |= (uint64_t)*InData << (InChecksum->pendingBytes * 8);
+    InData++;
+    InSize--;
+    InChecksum->pendingBytes++;
+    if ( InChecksum->pendingBytes == 8 ) {
+      InChecksum->hash = (InChecksum->hash ^ InChecksum->pending) * CHECKSUM_PRIME;
+      InChecksum->pending = 0;
+      InChecksum->pendingBytes = 0;
+    }
+  }
+
+  hash = InChecksum->hash;
+  while ( InSize >= 8 ) {
+    memcpy(&word, InData, 8);
+    hash = (hash ^ word) * CHECKSUM_PRIME;
+    InData += 8;
+    InSize -= 8;
+  }
+  InChecksum->hash = hash;
+
+  while ( InSize > 0 ) {
+    InChecksum->pending |= (uint64_t)*InData << (InChecksum->pendingBytes * 8);
+    InChecksum->pendingBytes++;
+    InData++;
+    InSize--;
+  }
+}
+
+/*****************************************************************************!
+ * Function : ChecksumFinal
+ *****************************************************************************/
+uint32_t
+ChecksumFinal
+(Checksum* InChecksum)
+{
+  uint64_t                              hash;
+
+  hash = InChecksum->hash;
+  if ( InChecksum->pendingBytes > 0 ) {
+    hash = (hash ^ InChecksum->pending ^ ((uint64_t)InChecksum->pendingBytes << 56)) * CHECKSUM_PRIME;
+  }
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/*****************************************************************************!
+ * Function : ChecksumFillPattern
+ *  xorshift64 stream, so every seed gives a distinct, reproducible pattern
+ *****************************************************************************/
+void
+ChecksumFillPattern
+(uint8_t* InData, uint32_t InSize, uint64_t InSeed)
+{
+  uint64_t                              x;
+  uint32_t                              i;
+
+  x = InSeed ? InSeed : CHECKSUM_OFFSET_BASIS;
+  for ( i = 0 ; i + 8 <= InSize ; i += 8 ) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    memcpy(InData + i, &x, 8);
+  }
+  for ( ; i < InSize ; i++ ) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    InData[i] = (uint8_t)x;
+  }
+}
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ * FILE NAME    : Checksum.h
+ * DATE         : January 08 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _checksum_h_
+#define _checksum_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : Checksum
+ *  Streaming 64 bit word hash.  Partial words are carried between updates so
+ *  the result does not depend on how the data was split into chunks.
+ *****************************************************************************/
+struct _Checksum
+{
+  uint64_t                              hash;
+  uint64_t                              pending;
+  uint32_t                              pendingBytes;
+};
+typedef struct _Checksum Checksum;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+void
+ChecksumInit
+(Checksum* InChecksum);
+
+void
+ChecksumUpdate
+(Checksum* InChecksum, uint8_t* InData, uint64_t InSize);
+
+uint32_t
+ChecksumFinal
+(Checksum* InChecksum);
+
+void
+ChecksumFillPattern
+(uint8_t* InData, uint32_t InSize, uint64_t InSeed);
+
+#endif // _checksum_h_
@@ -33,6 +33,8 @@
 static DiskInformation
 DiskInfoRoot = { } ;
 
+//! The file system statted, the one the stress files are on once the
+//  directory is known
 static string
 DiskRootName = "/";
 
@@ -50,31 +52,56 @@ DiskInformationInitialize
   DiskInformationRefresh();
 }
 
+/*****************************************************************************!
+ * Function : DiskInformationSetPath
+ *****************************************************************************/
+void
+DiskInformationSetPath
+(string InPath)
+{
+  DiskRootName = StringCopy(InPath);
+}
+
 /*****************************************************************************!
  * Function : DiskInformationRefresh
  *****************************************************************************/
 void
 DiskInformationRefresh
 ()
+{
+  if ( !DiskInformationRead(&DiskInfoRoot, DiskRootName) ) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskInformationRead
+ *  Fills InInfo for the file system InPath is on, each stress directory
+ *  keeps its own
+ *****************************************************************************/
+bool
+DiskInformationRead
+(DiskInformation* InInfo, string InPath)
 {
   struct statvfs                        vbuf;
   
-  if ( statvfs(DiskRootName, &vbuf) ) {
-    fprintf(stderr, "Could not get the volume information for %s : %s\n", DiskRootName, strerror(errno));
-    exit(EXIT_FAILURE);
+  if ( statvfs(InPath, &vbuf) ) {
+    fprintf(stderr, "Could not get the volume information for %s : %s\n", InPath, strerror(errno));
+    return false;
   }
 
-  DiskInfoRoot.blockSize    = vbuf.f_bsize;
-  DiskInfoRoot.totalBytes   = vbuf.f_blocks;
-  DiskInfoRoot.totalBytes  *= DiskInfoRoot.blockSize;
+  InInfo->blockSize    = vbuf.f_bsize;
+  InInfo->totalBytes   = vbuf.f_blocks;
+  InInfo->totalBytes  *= InInfo->blockSize;
 
-  DiskInfoRoot.freeBytes    = vbuf.f_bfree;
-  DiskInfoRoot.freeBytes   *= DiskInfoRoot.blockSize;
+  InInfo->freeBytes    = vbuf.f_bfree;
+  InInfo->freeBytes   *= InInfo->blockSize;
 
-  DiskInfoRoot.totalInodes  = vbuf.f_files;
-  DiskInfoRoot.freeInodes   = vbuf.f_favail;
-  DiskInfoRoot.totalBlocks  = vbuf.f_blocks;
-  DiskInfoRoot.freeBlocks   = vbuf.f_bfree;
+  InInfo->totalInodes  = vbuf.f_files;
+  InInfo->freeInodes   = vbuf.f_favail;
+  InInfo->totalBlocks  = vbuf.f_blocks;
+  InInfo->freeBlocks   = vbuf.f_bfree;
+  return true;
 }
 
 /*****************************************************************************!
@@ -98,39 +125,49 @@ DiskInformationDisplay
 JSONOut*
 DiskInformationToJSON
 ()
+{
+  return DiskInformationInstanceToJSON("diskinfo", &DiskInfoRoot);
+}
+
+/*****************************************************************************!
+ * Function : DiskInformationInstanceToJSON
+ *****************************************************************************/
+JSONOut*
+DiskInformationInstanceToJSON
+(string InName, DiskInformation* InInfo)
 {
   JSONOut*                              jsonOut;
   char                                  s1[32];
   uint64_t                              n;
 
-  jsonOut = JSONOutCreateObject("diskinfo");
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalbytes", DiskInfoRoot.totalBytes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalinodes", DiskInfoRoot.totalInodes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalblocks", DiskInfoRoot.totalBlocks));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("blocksize", DiskInfoRoot.blockSize));
+  jsonOut = JSONOutCreateObject(InName);
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalbytes", InInfo->totalBytes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalinodes", InInfo->totalInodes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("totalblocks", InInfo->totalBlocks));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("blocksize", InInfo->blockSize));
 
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freebytes", DiskInfoRoot.freeBytes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freeinodes", DiskInfoRoot.freeInodes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freeblocks", DiskInfoRoot.freeBlocks));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freebytes", InInfo->freeBytes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freeinodes", InInfo->freeInodes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("freeblocks", InInfo->freeBlocks));
 
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedbytes", DiskInfoRoot.totalBytes - DiskInfoRoot.freeBytes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedinodes", DiskInfoRoot.totalInodes - DiskInfoRoot.freeInodes));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedblocks", DiskInfoRoot.totalBlocks - DiskInfoRoot.freeBlocks));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedbytes", InInfo->totalBytes - InInfo->freeBytes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedinodes", InInfo->totalInodes - InInfo->freeInodes));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("usedblocks", InInfo->totalBlocks - InInfo->freeBlocks));
 
-  n = (int)DiskInfoRoot.totalBlocks - DiskInfoRoot.freeBlocks;
-  n = (int)((n * 100) / DiskInfoRoot.totalBlocks);
+  n = (int)InInfo->totalBlocks - InInfo->freeBlocks;
+  n = (int)((n * 100) / InInfo->totalBlocks);
   JSONOutObjectAddObject(jsonOut, JSONOutCreateInt("usedpercent", n));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalbytesstring", ConvertLongLongToCommaString(DiskInfoRoot.totalBytes, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freebytesstring", ConvertLongLongToCommaString(DiskInfoRoot.freeBytes , s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalblocksstring", ConvertLongLongToCommaString(DiskInfoRoot.totalBlocks, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeblocksstring", ConvertLongLongToCommaString(DiskInfoRoot.freeBlocks, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeblocksstring", ConvertLongLongToCommaString(DiskInfoRoot.freeBlocks, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalinodesstring", ConvertLongLongToCommaString(DiskInfoRoot.totalInodes, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeinodesstring", ConvertLongLongToCommaString(DiskInfoRoot.freeInodes, s1)));
-
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedbytesstring", ConvertLongLongToCommaString(DiskInfoRoot.totalBytes - DiskInfoRoot.freeBytes, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedinodesstring", ConvertLongLongToCommaString(DiskInfoRoot.totalInodes - DiskInfoRoot.freeInodes, s1)));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedblocksstring", ConvertLongLongToCommaString(DiskInfoRoot.totalBlocks - DiskInfoRoot.freeBlocks, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalbytesstring", ConvertLongLongToCommaString(InInfo->totalBytes, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freebytesstring", ConvertLongLongToCommaString(InInfo->freeBytes , s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalblocksstring", ConvertLongLongToCommaString(InInfo->totalBlocks, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeblocksstring", ConvertLongLongToCommaString(InInfo->freeBlocks, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeblocksstring", ConvertLongLongToCommaString(InInfo->freeBlocks, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("totalinodesstring", ConvertLongLongToCommaString(InInfo->totalInodes, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("freeinodesstring", ConvertLongLongToCommaString(InInfo->freeInodes, s1)));
+
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedbytesstring", ConvertLongLongToCommaString(InInfo->totalBytes - InInfo->freeBytes, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedinodesstring", ConvertLongLongToCommaString(InInfo->totalInodes - InInfo->freeInodes, s1)));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateString("usedblocksstring", ConvertLongLongToCommaString(InInfo->totalBlocks - InInfo->freeBlocks, s1)));
   
   return jsonOut;
 }
@@ -165,3 +202,12 @@ DiskInformationGetUsedBytes
   return DiskInfoRoot.totalBytes - DiskInfoRoot.freeBytes;
 }
 
+/*****************************************************************************!
+ * Function : DiskInformationGetUsedInodes
+ *****************************************************************************/
+uint64_t
+DiskInformationGetUsedInodes
+()
+{
+  return DiskInfoRoot.totalInodes - DiskInfoRoot.freeInodes;
+}
@@ -10,12 +10,14 @@
 /*****************************************************************************!
  * Global Headers
  *****************************************************************************/
+#include <stdbool.h>
 #include <sys/statvfs.h>
 
 /*****************************************************************************!
  * Local Headers
  *****************************************************************************/
 #include "JSONOut.h"
+#include "GeneralUtilities/String.h"
 
 /*****************************************************************************!
  * Exported Macros
@@ -71,4 +73,20 @@ uint64_t
 DiskInformationGetUsedBytes
 ();
 
+uint64_t
+DiskInformationGetUsedInodes
+();
+
+void
+DiskInformationSetPath
+(string InPath);
+
+bool
+DiskInformationRead
+(DiskInformation* InInfo, string InPath);
+
+JSONOut*
+DiskInformationInstanceToJSON
+(string InName, DiskInformation* InInfo);
+
 #endif // _diskinformation_h_
@@ -8,6 +8,7 @@
 /*****************************************************************************!
  * Global Headers
  *****************************************************************************/
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +18,9 @@
 #include <dirent.h>
 #include <errno.h>
 #include <time.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
 
 /*****************************************************************************!
  * Local Headers
@@ -28,10 +32,52 @@
 #include "GeneralUtilities/MemoryManager.h"
 #include "DiskInformation.h"
 #include "Log.h"
+#include "TimeStamp.h"
+#include "IOURingEngine.h"
+#include "LatencyHistogram.h"
+#include "FileSizeDistribution.h"
+#include "RateLimiter.h"
+#include "ArrivalSchedule.h"
+#include "BlockTarget.h"
+#include "Random.h"
+#include "Trace.h"
+#include "ThreadAffinity.h"
 
 /*****************************************************************************!
  * Local Macros
  *****************************************************************************/
+#define DISK_STRESS_MONITOR_PERIOD      250000
+
+//! Monitor periods between samples of the slot set's resident memory
+#define DISK_STRESS_RESIDENT_PERIODS    40
+#define DISK_STRESS_PHASES_MAX          64
+#define DISK_STRESS_VOLUMES_MAX         FILE_INFO_BLOCK_NAMESPACES_MAX
+
+//! Draws before giving up on finding a slot that is not pending
+#define DISK_STRESS_PENDING_TRIES       8
+
+//! Worker counters are read by the web socket thread while being updated
+#define DiskStressCounterAdd(c, n)      __atomic_fetch_add(&(c), (n), __ATOMIC_RELAXED)
+#define DiskStressCounterGet(c)         __atomic_load_n(&(c), __ATOMIC_RELAXED)
+#define DiskStressCounterSet(c, n)      __atomic_store_n(&(c), (n), __ATOMIC_RELAXED)
+
+//! Settings a phase or the user can change while the workers read them
+#define DiskStressSettingGet(s)         __atomic_load_n(&(s), __ATOMIC_RELAXED)
+#define DiskStressSettingSet(s, n)      __atomic_store_n(&(s), (n), __ATOMIC_RELAXED)
+
+//! The phase settings, a bit each in diskStressPhaseOverrides
+#define DISK_STRESS_SETTING_READ        0x0001
+#define DISK_STRESS_SETTING_OVERWRITE   0x0002
+#define DISK_STRESS_SETTING_OVERSIZE    0x0004
+#define DISK_STRESS_SETTING_HOTSET      0x0008
+#define DISK_STRESS_SETTING_HIGH        0x0010
+#define DISK_STRESS_SETTING_LOW         0x0020
+#define DISK_STRESS_SETTING_SLEEP       0x0040
+#define DISK_STRESS_SETTING_RATEMBPS    0x0080
+#define DISK_STRESS_SETTING_RATEIOPS    0x0100
+
+//! Extent counts kept exactly, the last bucket holds that many or more
+#define DISK_STRESS_EXTENT_BUCKETS      17
 
 /*****************************************************************************!
  * Local Type : DiskStressUsageTrend 
@@ -44,12 +90,186 @@ enum _DiskStressUsageTrend
 };
 typedef enum _DiskStressUsageTrend DiskStressUsageTrend;
 
+/*****************************************************************************!
+ * Local Type : DiskStressEngine
+ *****************************************************************************/
+enum _DiskStressEngine
+{
+  DISK_STRESS_ENGINE_SYNC,
+  DISK_STRESS_ENGINE_IOURING
+};
+typedef enum _DiskStressEngine DiskStressEngine;
+
+/*****************************************************************************!
+ * Local Type : DiskStressOp
+ *  What a worker does next, DISK_STRESS_OP_WRITE creates or removes a file
+ *  depending on the trend
+ *****************************************************************************/
+enum _DiskStressOp
+{
+  DISK_STRESS_OP_WRITE,
+  DISK_STRESS_OP_READ,
+  DISK_STRESS_OP_OVERWRITE
+};
+typedef enum _DiskStressOp DiskStressOp;
+
+/*****************************************************************************!
+ * Local Type : DiskStressMetaOp
+ *  The operations of the metadata workload, in --metadata mix order
+ *****************************************************************************/
+enum _DiskStressMetaOp
+{
+  DISK_STRESS_META_CREATE,
+  DISK_STRESS_META_STAT,
+  DISK_STRESS_META_RENAME,
+  DISK_STRESS_META_SETATTR,
+  DISK_STRESS_META_UNLINK,
+  DISK_STRESS_META_COUNT
+};
+typedef enum _DiskStressMetaOp DiskStressMetaOp;
+
+/*****************************************************************************!
+ * Local Type : DiskStressPhase
+ *  A stretch of a job file run, the runtime settings in force while it lasts.
+ *  A duration of 0 lasts until the end of the run.
+ *****************************************************************************/
+struct _DiskStressPhase
+{
+  string                                name;
+  uint32_t                              duration;
+  int                                   readPercent;
+  int                                   overwritePercent;
+  uint32_t                              overwriteSize;
+  int                                   hotSetPercent;
+  int                                   hotSetSize;
+  int                                   highPercent;
+  int                                   lowPercent;
+  int                                   sleepPeriod;
+  uint32_t                              rateMBps;
+  uint32_t                              rateIOPS;
+};
+typedef struct _DiskStressPhase DiskStressPhase;
+
+/*****************************************************************************!
+ * Local Type : DiskStressExtentCounts
+ *  How many extents the finished append files ended up in.  files[n] is the
+ *  number of fully allocated files with n extents.  Files with ranges still
+ *  in delayed allocation have no final layout yet, they are only counted in
+ *  pendingFiles and their delayed extents in pendingExtents.
+ *****************************************************************************/
+struct _DiskStressExtentCounts
+{
+  uint64_t                              files[DISK_STRESS_EXTENT_BUCKETS];
+  uint64_t                              count;
+  uint64_t                              total;
+  uint64_t                              min;
+  uint64_t                              max;
+  uint64_t                              pendingFiles;
+  uint64_t                              pendingExtents;
+};
+typedef struct _DiskStressExtentCounts DiskStressExtentCounts;
+
+/*****************************************************************************!
+ * Local Type : DiskStressWorker
+ *  Each worker owns the slots [firstIndex, lastIndex) of the file info block
+ *  set, so no two workers ever touch the same file
+ *****************************************************************************/
+struct _DiskStressVolume;
+
+struct _DiskStressWorker
+{
+  int                                   id;
+  struct _DiskStressVolume*             volume;
+  pthread_t                             threadID;
+  int64_t                               firstIndex;
+  int64_t                               lastIndex;
+  Random                                random;
+  FileInfoBlockBuffer*                  writeBuffer;
+  IOURingEngine*                        engine;
+  uint64_t                              filesCreated;
+  uint64_t                              filesRemoved;
+  uint64_t                              bytesWritten;
+  uint64_t                              writeTime;
+  uint64_t                              lastWriteBytes;
+  uint64_t                              lastWriteTime;
+  uint64_t                              filesVerified;
+  uint64_t                              verifyErrors;
+  uint64_t                              bytesVerified;
+  uint64_t                              verifyTime;
+  uint64_t                              filesRead;
+  uint64_t                              bytesRead;
+  uint64_t                              readTime;
+  LatencyHistogram                      readLatency;
+  uint64_t                              syncs;
+  uint64_t                              syncTime;
+  LatencyHistogram                      syncLatency;
+  uint32_t                              unsyncedFiles;
+  uint64_t                              lastSyncTime;
+  int                                   directoryFD;
+  ArrivalSchedule                       arrival;
+  LatencyHistogram                      responseLatency;
+  FileInfoBlockAppender*                appenders;
+  int                                   appendCount;
+  int                                   appendNext;
+  uint64_t                              appends;
+  LatencyHistogram                      appendLatency;
+  DiskStressExtentCounts                extents;
+  uint64_t                              overwrites;
+  uint64_t                              bytesOverwritten;
+  uint64_t                              overwriteTime;
+  LatencyHistogram                      overwriteLatency;
+  int64_t                               liveFiles;
+  uint64_t                              metaOps[DISK_STRESS_META_COUNT];
+  uint64_t                              metaErrors;
+  LatencyHistogram                      metaLatency[DISK_STRESS_META_COUNT];
+  uint64_t                              iterations;
+  uint64_t                              idleIterations;
+};
+typedef struct _DiskStressWorker DiskStressWorker;
+
+/*****************************************************************************!
+ * Local Type : DiskStressVolume
+ *  One stress directory, usually a mount of its own.  It owns the slots
+ *  [firstIndex, lastIndex) and the workers [firstWorker, firstWorker +
+ *  workerCount), and fills and drains on its own trend so each device
+ *  cycles at its own pace.
+ *****************************************************************************/
+struct _DiskStressVolume
+{
+  int                                   id;
+  string                                directory;
+  FileNamespace*                        namespace;
+  DiskInformation                       info;
+  uint64_t                              availableBytes;
+  uint32_t                              alignment;
+  int64_t                               firstIndex;
+  int64_t                               lastIndex;
+  int                                   firstWorker;
+  int                                   workerCount;
+  DiskStressUsageTrend                  trend;
+  int                                   cycleCount;
+  uint64_t                              inodesStart;
+  uint64_t                              inodesPeak;
+};
+typedef struct _DiskStressVolume DiskStressVolume;
+
 /*****************************************************************************!
  * Local Data
  *****************************************************************************/
+//! The first stress directory, the one the global disk information follows
 static string
 diskStressDirectory = NULL;
 
+//! --directory as given, a comma separated list of stress directories
+static string
+diskStressDirectorySpec = NULL;
+
+static DiskStressVolume
+diskStressVolumes[DISK_STRESS_VOLUMES_MAX];
+
+static int
+diskStressVolumeCount = 0;
+
 static string
 diskStressDirectoryDefault = "./DiskStressFiles/";
 
@@ -74,12 +294,6 @@ diskStressThreadAvailableBytes;
 static uint64_t
 diskStressThreadMaxFiles = 0;
 
-static uint64_t
-diskStressThreadFilesRemovedCount = 0;
-
-static uint64_t
-diskStressThreadFilesCreatedCount = 0;
-
 static int
 diskStressThreadSleepPeriod = 250000;
 
@@ -101,11 +315,198 @@ diskStressLowUsagePercent = 0;
 int
 diskStressLowUsagePercentDefault = 4;
 
-DiskStressUsageTrend
-diskStressTrend = DISK_STRESS_TREND_NONE;
+static uint32_t
+diskStressWriteBlockSize = 65536;
 
-int
-diskStressCycleCount = 0;
+static uint32_t
+diskStressWriteBlockSizeMin = 512;
+
+static uint32_t
+diskStressWriteBlockSizeMax = 16 * 1024 * 1024;
+
+static bool
+diskStressDirectIO = false;
+
+static bool
+diskStressVerify = false;
+
+static int
+diskStressReadPercent = 0;
+
+static uint64_t
+diskStressReadSize = 0;
+
+static FileInfoBlockSync
+diskStressSync = FILE_INFO_BLOCK_SYNC_NONE;
+
+static string
+diskStressSyncPolicy = NULL;
+
+static uint32_t
+diskStressSyncEveryFiles = 0;
+
+static uint32_t
+diskStressSyncEveryMS = 0;
+
+static FileSizeDistribution*
+diskStressSizeDistribution = NULL;
+
+static uint32_t
+diskStressRateMBps = 0;
+
+static uint32_t
+diskStressRateIOPS = 0;
+
+static RateLimiter*
+diskStressRateLimiter = NULL;
+
+static ArrivalScheduleType
+diskStressArrivalType = ARRIVAL_SCHEDULE_NONE;
+
+static double
+diskStressArrivalRate = 0.0;
+
+static string
+diskStressArrivalSpec = NULL;
+
+static DiskStressEngine
+diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+
+static uint32_t
+diskStressIODepth = 1;
+
+static uint32_t
+diskStressIODepthMax = 256;
+
+static uint32_t
+diskStressAlignment = FILE_INFO_BLOCK_DEFAULT_ALIGNMENT;
+
+static string
+diskStressTargetPath = NULL;
+
+//! The target is an image file, created when it does not exist
+static bool
+diskStressTargetCreate = false;
+
+static BlockTargetRelease
+diskStressTargetRelease = BLOCK_TARGET_RELEASE_DISCARD;
+
+static BlockTarget*
+diskStressTarget = NULL;
+
+//! Bytes per append, 0 writes each file in one go
+static uint32_t
+diskStressAppendChunk = 0;
+
+//! Files each worker keeps growing at once
+static int
+diskStressAppendFiles = 8;
+
+static int
+diskStressOverwritePercent = 0;
+
+static uint32_t
+diskStressOverwriteSize = 4096;
+
+//! diskStressHotSetPercent of the overwrites go to the first
+//  diskStressHotSetSize percent of each worker's slots, 0 is uniform
+static int
+diskStressHotSetPercent = 0;
+
+static int
+diskStressHotSetSize = 0;
+
+//! Levels and width of the subdirectories the files are spread over, 0
+//  levels keeps every file in the stress directory itself
+static int
+diskStressFanoutLevels = 0;
+
+static int
+diskStressFanoutWidth = 256;
+
+//! Metadata workload, zero length files and no data I/O
+static bool
+diskStressMetadata = false;
+
+static int
+diskStressMetaMix[DISK_STRESS_META_COUNT] = { 30, 30, 10, 10, 20 };
+
+static string
+diskStressMetaOpNames[DISK_STRESS_META_COUNT] = { "create", "stat", "rename", "setattr", "unlink" };
+
+//! Used inodes on the stress file system, refreshed with the disk
+//  information
+static uint64_t
+diskStressInodesStart = 0;
+
+//! Seeds every worker's generator, picked from the clock and logged when
+//  not given so a run can be repeated with --seed
+static uint64_t
+diskStressSeed = 0;
+
+static bool
+diskStressSeedSet = false;
+
+static uint64_t
+diskStressInodesPeak = 0;
+
+//! Seconds the run lasts, 0 runs until it is stopped
+static uint32_t
+diskStressDuration = 0;
+
+//! Phases from a job file, switched by the monitor loop
+static DiskStressPhase
+diskStressPhases[DISK_STRESS_PHASES_MAX];
+
+static int
+diskStressPhaseCount = 0;
+
+static int
+diskStressPhaseCurrent = -1;
+
+static string
+diskStressJobFile = NULL;
+
+//! Set while main reads the job file, its options make the phases
+static bool
+diskStressJobFileLoading = false;
+
+//! Phase settings given after the job file, which every phase leaves alone
+static uint32_t
+diskStressPhaseOverrides = 0;
+
+//! Every operation is recorded to diskStressTracePath, or the operations
+//  are replayed from diskStressReplayPath instead of being generated.
+//  diskStressTrace is the recording or the replay.
+static string
+diskStressTracePath = NULL;
+
+static string
+diskStressReplayPath = NULL;
+
+static bool
+diskStressReplayFast = false;
+
+static Trace*
+diskStressTrace = NULL;
+
+static uint64_t
+diskStressReplayStart = 0;
+
+static int
+diskStressReplayFinished = 0;
+
+static DiskStressWorker*
+diskStressWorkers = NULL;
+
+static int
+diskStressWorkerCount = 1;
+
+static int
+diskStressWorkerCountMax = 64;
+
+static pthread_mutex_t
+diskStressTrendMutex = PTHREAD_MUTEX_INITIALIZER;
 
 /*****************************************************************************!
  * Local Functions
@@ -118,415 +519,3754 @@ static void
 DiskStressThreadCleanFiles
 ();
 
+static uint32_t
+DiskStressThreadGetDirectoryAlignment
+(string InDirectory);
+
+static void
+DiskStressThreadOpenTarget
+();
+
+static void*
+DiskStressWorkerThread
+(void* InParameters);
+
+static void
+DiskStressWorkerSyncLoop
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerIOURingLoop
+(DiskStressWorker* InWorker);
+
+static FileInfoBlock*
+DiskStressWorkerGetRandomBlock
+(DiskStressWorker* InWorker, int64_t InFirst, int64_t InLast, bool InOccupied);
+
+static void
+DiskStressThreadUpdateTrend
+(DiskStressVolume* InVolume);
+
+static void
+DiskStressWorkerRecordWrite
+(DiskStressWorker* InWorker, uint64_t InBytes, uint64_t InElapsed);
+
+static void
+DiskStressWorkerVerifyFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock);
+
+static DiskStressOp
+DiskStressWorkerGetOp
+(DiskStressWorker* InWorker);
+
+static FileInfoBlock*
+DiskStressWorkerGetOverwriteBlock
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerOverwriteFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock);
+
+static FileInfoBlock*
+DiskStressWorkerGetOccupiedBlock
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerGetReadRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t* InOffset, uint64_t* InLength);
+
+static void
+DiskStressWorkerReadFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock);
+
+static void
+DiskStressWorkerRecordRead
+(DiskStressWorker* InWorker, uint64_t InBytes, uint64_t InElapsed);
+
+static void
+DiskStressWorkerRecordSync
+(DiskStressWorker* InWorker, uint64_t InElapsed);
+
+static void
+DiskStressThreadNoteOverride
+(uint32_t InSetting);
+
+static void
+DiskStressExtentCountsAdd
+(DiskStressExtentCounts* InCounts, uint64_t InExtents, uint64_t InPending);
+
+static void
+DiskStressExtentCountsMerge
+(DiskStressExtentCounts* InCounts, DiskStressExtentCounts* InSource);
+
+static JSONOut*
+DiskStressExtentCountsToJSON
+(string InTag, DiskStressExtentCounts* InCounts);
+
+static void
+DiskStressWorkerCheckSync
+(DiskStressWorker* InWorker, uint64_t InSyncElapsed);
+
+static uint64_t
+DiskStressWorkerGetFileSize
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerThrottle
+(uint64_t InBytes);
+
+static bool
+DiskStressWorkerRateReady
+(IOURingEngine* InEngine);
+
+static void
+DiskStressWorkerPace
+();
+
+static bool
+DiskStressWorkerSyncOperation
+(DiskStressWorker* InWorker);
+
+static uint64_t
+DiskStressWorkerWaitForArrival
+(DiskStressWorker* InWorker);
+
+static bool
+DiskStressWorkerArrivalReady
+(DiskStressWorker* InWorker);
+
+static bool
+DiskStressWorkerAppend
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerStartAppend
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerFinishAppend
+(DiskStressWorker* InWorker, FileInfoBlockAppender* InAppender, bool InWritten);
+
+static JSONOut*
+DiskStressWorkerToJSON
+(DiskStressWorker* InWorker);
+
+static JSONOut*
+DiskStressVolumeToJSON
+(DiskStressVolume* InVolume, time_t InElapsed);
+
+static void
+DiskStressThreadSetupVolumes
+();
+
+static bool
+DiskStressWorkerMetadataOperation
+(DiskStressWorker* InWorker);
+
+static DiskStressMetaOp
+DiskStressWorkerGetMetaOp
+(DiskStressWorker* InWorker);
+
+static FileInfoBlock*
+DiskStressWorkerGetMetaBlock
+(DiskStressWorker* InWorker, bool InOccupied);
+
+static JSONOut*
+DiskStressThreadMetadataToJSON
+(time_t InElapsed);
+
+static void
+DiskStressThreadApplyPhase
+(int InPhase);
+
+static void
+DiskStressThreadCheckSchedule
+(time_t InElapsed);
+
+static bool
+DiskStressThreadRateLimited
+();
+
+static void
+DiskStressThreadSaveSettings
+(DiskStressPhase* InPhase);
+
+static JSONOut*
+DiskStressPhaseToJSON
+(string InName, DiskStressPhase* InPhase);
+
+static void
+DiskStressThreadFinish
+(time_t InElapsed);
+
+static void
+DiskStressThreadOpenReplay
+();
+
+static void
+DiskStressThreadCloseTrace
+();
+
+static void
+DiskStressWorkerTrace
+(DiskStressWorker* InWorker, TraceOp InOp, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InSize,
+ uint64_t InElapsed, int32_t InResult);
+
+static void
+DiskStressWorkerReplayLoop
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerReplayOperation
+(DiskStressWorker* InWorker, TraceRecord* InRecord, FileInfoBlock* InBlock);
+
+static FileInfoBlockAppender*
+DiskStressWorkerFindAppender
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock);
+
+static bool
+DiskStressWorkerMetadataApply
+(DiskStressWorker* InWorker, DiskStressMetaOp InOp, FileInfoBlock* InBlock, FileInfoBlock* InTarget, mode_t InMode);
+
+static void
+DiskStressWorkerOverwriteRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InLength);
+
+static void
+DiskStressWorkerReadRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InLength);
+
+static void
+DiskStressWorkerSyncNow
+(DiskStressWorker* InWorker);
+
+static void
+DiskStressWorkerAppendChunk
+(DiskStressWorker* InWorker, FileInfoBlockAppender* InAppender, uint32_t InChunkSize);
+
+/*****************************************************************************!
+ * Function : DiskStressThreadInit
+
+ *****************************************************************************/
+void
+DiskStressThreadInit
+()
+{
+  diskStressHighUsagePercent = diskStressHighUsagePercentDefault;
+  diskStressLowUsagePercent  = diskStressLowUsagePercentDefault;
+  diskStressFileHead = NULL;
+  DiskStressThreadSetDirectory(diskStressDirectoryDefault);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadStart
+ *****************************************************************************/
+void
+DiskStressThreadStart
+()
+{
+  DiskStressVolume*                     volume;
+  int                                   i;
+
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    volume->namespace = FileNamespaceCreate(volume->directory, diskStressFanoutLevels, diskStressFanoutWidth);
+    if ( NULL == volume->namespace ) {
+      fprintf(stderr, "%sCould not create the file directories under %s%s\n", ColorRed, volume->directory, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+    if ( !DiskInformationRead(&(volume->info), volume->directory) ) {
+      exit(EXIT_FAILURE);
+    }
+  }
+  DiskStressThreadCleanFiles();
+  DiskInformationSetPath(diskStressDirectory);
+  DiskInformationInitialize();
+
+  if ( pthread_create(&DiskStressThreadID, NULL, DiskStressThread, NULL) ) {
+    fprintf(stderr, "%sCould not start \"DiskStress Thread\"%s\n", ColorRed, ColorReset);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThread
+ *  Sets up the file set and the workers, then stays around to refresh the
+ *  disk information while the workers do the I/O
+ *****************************************************************************/
+void*
+DiskStressThread
+(void* InParameters)
+{
+  DiskStressWorker*                     worker;
+  DiskStressVolume*                     volume;
+  int                                   i, j, periods;
+  int64_t                               sliceSize;
+  uint64_t                              maxFiles, maxChainSize;
+  char                                  spec[32];
+  Random                                streams;
+  JSONOut*                              config;
+  string                                s;
+
+  ThreadAffinityApplyServer("stress");
+  if ( diskStressVolumeCount > 1 && (diskStressTargetPath || diskStressReplayPath) ) {
+    fprintf(stderr, "%sBlock targets and replays use a single directory%s\n", ColorRed, ColorReset);
+    exit(EXIT_FAILURE);
+  }
+  diskStressThreadAvailableBytes = 0;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    diskStressVolumes[i].availableBytes = diskStressVolumes[i].info.freeBytes;
+    diskStressThreadAvailableBytes += diskStressVolumes[i].availableBytes;
+  }
+  if ( diskStressReplayPath ) {
+    DiskStressThreadOpenReplay();
+  }
+
+  //! Without a size distribution every file is diskStressMaxFileSize bytes,
+  //  with one the largest size it can pick becomes the maximum
+  if ( NULL == diskStressSizeDistribution ) {
+    sprintf(spec, "fixed:%llu", (unsigned long long)diskStressMaxFileSize);
+    diskStressSizeDistribution = FileSizeDistributionCreate(spec);
+  }
+  diskStressMaxFileSize = FileSizeDistributionGetMax(diskStressSizeDistribution);
+
+  //! The maximum number of files is per directory, each one sized from its
+  //  own free space when the user has not set it
+  maxFiles = diskStressThreadMaxFiles;
+  diskStressThreadMaxFiles = 0;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    volume->firstIndex = (int64_t)diskStressThreadMaxFiles;
+    if ( maxFiles ) {
+      diskStressThreadMaxFiles += maxFiles;
+    } else {
+      diskStressThreadMaxFiles += volume->availableBytes / FileSizeDistributionGetMean(diskStressSizeDistribution) + 1;
+    }
+    volume->lastIndex = (int64_t)diskStressThreadMaxFiles;
+  }
+  if ( diskStressTargetPath ) {
+    DiskStressThreadOpenTarget();
+    diskStressVolumes[0].lastIndex      = (int64_t)diskStressThreadMaxFiles;
+    diskStressVolumes[0].availableBytes = diskStressThreadAvailableBytes;
+  }
+  if ( diskStressAppendChunk && diskStressTarget ) {
+    LogAppend("Append                  : block targets have no files to grow, appends are off");
+    diskStressAppendChunk = 0;
+  }
+  if ( diskStressMetadata && diskStressTarget ) {
+    LogAppend("Metadata                : block targets have no files, metadata operations are off");
+    diskStressMetadata = false;
+  }
+  if ( diskStressMetadata && diskStressEngine == DISK_STRESS_ENGINE_IOURING ) {
+    LogAppend("Metadata                : metadata operations are synchronous, using sync");
+    diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+  }
+  if ( diskStressAppendChunk && diskStressEngine == DISK_STRESS_ENGINE_IOURING ) {
+    LogAppend("Append                  : appends are synchronous, using sync");
+    diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+  }
+  if ( diskStressReplayPath && diskStressEngine == DISK_STRESS_ENGINE_IOURING ) {
+    LogAppend("Replay                  : replays are synchronous, using sync");
+    diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+  }
+
+  //! Every create is one io_uring chain, a log-normal tail is cut off where
+  //  the chain runs out, any other size that does not fit is an error
+  maxChainSize = IOURingEngineGetMaxFileSize(diskStressWriteBlockSize);
+  if ( diskStressEngine == DISK_STRESS_ENGINE_IOURING && diskStressMaxFileSize > maxChainSize ) {
+    if ( !FileSizeDistributionCapMax(diskStressSizeDistribution, maxChainSize) ) {
+      fprintf(stderr, "%sFiles of %llu bytes need more than %llu bytes of io_uring writes, "
+              "raise --blocksize or use --engine sync%s\n", ColorRed,
+              (unsigned long long)diskStressMaxFileSize, (unsigned long long)maxChainSize, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+    LogAppend("Size Distribution       : largest file cut to %llu bytes, one io_uring chain",
+              (unsigned long long)maxChainSize);
+    diskStressMaxFileSize = maxChainSize;
+  }
+  FileInfoBlockSetCreate(diskStressThreadMaxFiles, diskStressVerify);
+  //! One buffer alignment has to suit every directory, the largest does
+  diskStressAlignment = 0;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    volume->alignment = diskStressTarget ? diskStressTarget->alignment : DiskStressThreadGetDirectoryAlignment(volume->directory);
+    if ( volume->alignment > diskStressAlignment ) {
+      diskStressAlignment = volume->alignment;
+    }
+    FileInfoBlockAddNamespace(volume->namespace, volume->firstIndex);
+  }
+  //! A phase may turn the rate limit on part way through the run
+  if ( diskStressPhaseCount ) {
+    DiskStressThreadApplyPhase(0);
+  }
+  if ( diskStressRateMBps || diskStressRateIOPS || diskStressPhaseCount ) {
+    diskStressRateLimiter = RateLimiterCreate((uint64_t)diskStressRateMBps * 1000000, diskStressRateIOPS);
+  }
+
+  DiskStressThreadSetupVolumes();
+  diskStressWorkers = (DiskStressWorker*)GetMemory(sizeof(DiskStressWorker) * diskStressWorkerCount);
+  memset(diskStressWorkers, 0x00, sizeof(DiskStressWorker) * diskStressWorkerCount);
+  if ( !diskStressSeedSet ) {
+    diskStressSeed = RandomGetTimeSeed();
+  }
+  RandomInit(&streams, diskStressSeed);
+  for ( i = 0 ; i < diskStressWorkerCount ; i++ ) {
+    worker = &(diskStressWorkers[i]);
+    for ( volume = diskStressVolumes ; i >= volume->firstWorker + volume->workerCount ; volume++ ) {
+    }
+    j = i - volume->firstWorker;
+    sliceSize = (volume->lastIndex - volume->firstIndex) / volume->workerCount;
+    worker->id          = i;
+    worker->volume      = volume;
+    worker->firstIndex  = volume->firstIndex + j * sliceSize;
+    worker->lastIndex   = j + 1 == volume->workerCount ? volume->lastIndex : worker->firstIndex + sliceSize;
+    worker->random      = streams;
+    FileInfoBlockAddRange(worker->firstIndex, worker->lastIndex);
+    RandomJump(&streams);
+    LatencyHistogramInit(&(worker->readLatency));
+    LatencyHistogramInit(&(worker->syncLatency));
+    LatencyHistogramInit(&(worker->responseLatency));
+    LatencyHistogramInit(&(worker->appendLatency));
+    LatencyHistogramInit(&(worker->overwriteLatency));
+    for ( j = 0 ; j < DISK_STRESS_META_COUNT ; j++ ) {
+      LatencyHistogramInit(&(worker->metaLatency[j]));
+    }
+    if ( diskStressAppendChunk || (diskStressReplayPath && diskStressAppendFiles) ) {
+      worker->appenders = (FileInfoBlockAppender*)GetMemory(sizeof(FileInfoBlockAppender) * diskStressAppendFiles);
+    }
+    worker->directoryFD = -1;
+    //! A replay syncs whenever the recording did, whatever the policy
+    if ( diskStressSyncEveryFiles || diskStressSyncEveryMS || diskStressReplayPath ) {
+      worker->directoryFD  = diskStressTarget ? diskStressTarget->fd : open(volume->directory, O_RDONLY | O_DIRECTORY);
+      worker->lastSyncTime = TimeStampGetMicroseconds();
+    }
+    worker->writeBuffer = FileInfoBlockBufferCreate(diskStressWriteBlockSize, diskStressAlignment,
+                                                    diskStressDirectIO, diskStressVerify, diskStressSync);
+    if ( NULL == worker->writeBuffer ) {
+      fprintf(stderr, "%sCould not allocate the write buffer%s\n", ColorRed, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if ( diskStressTracePath && NULL == diskStressReplayPath && diskStressThreadMaxFiles > UINT32_MAX ) {
+    LogAppend("Trace                   : slots past 2^32 do not fit a trace record, not recording");
+    diskStressTracePath = NULL;
+  }
+  if ( diskStressTracePath && NULL == diskStressReplayPath ) {
+    diskStressTrace = TraceCreate(diskStressTracePath, diskStressWorkerCount, diskStressThreadMaxFiles,
+                                  diskStressMaxFileSize, diskStressAppendChunk ? diskStressAppendFiles : 0);
+    if ( NULL == diskStressTrace ) {
+      exit(EXIT_FAILURE);
+    }
+    atexit(DiskStressThreadCloseTrace);
+  }
+
+  LogAppend("Disk Stress Thread      : started");
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    LogAppend("  Files Directory       : %s, slots %lld to %lld, workers %d to %d, %lld bytes available", volume->directory,
+              (long long)volume->firstIndex, (long long)volume->lastIndex - 1, volume->firstWorker,
+              volume->firstWorker + volume->workerCount - 1, volume->availableBytes);
+  }
+  if ( diskStressTarget ) {
+    LogAppend("  Block Target          : %s, %s, %llu extents of %llu, %s on delete", diskStressTarget->path,
+              diskStressTarget->device ? "device" : "image", (unsigned long long)diskStressTarget->extentCount,
+              (unsigned long long)diskStressTarget->extentSize, BlockTargetGetReleaseName(diskStressTarget->release));
+  }
+  LogAppend("  Available Bytes       : %lld", diskStressThreadAvailableBytes);
+  LogAppend("  Max Files             : %lld", diskStressThreadMaxFiles);
+  FileInfoBlockSetUpdateResident();
+  LogAppend("  Slot Set Memory       : %llu reserved, %llu resident%s", (unsigned long long)FileInfoBlockSetGetMemory(),
+            (unsigned long long)FileInfoBlockSetGetResident(), SlotMemoryGetHugePages() ? ", huge pages" : "");
+  LogAppend("  Max File Size         : %lld", diskStressMaxFileSize);
+  LogAppend("  File Sizes            : %s", diskStressSizeDistribution->spec);
+  LogAppend("  Write Block Size      : %d", diskStressWorkers[0].writeBuffer->size);
+  LogAppend("  Direct I/O            : %s", diskStressDirectIO ? "on" : "off");
+  LogAppend("  I/O Alignment         : %d", diskStressAlignment);
+  LogAppend("  Verify                : %s", diskStressVerify ? "on" : "off");
+  LogAppend("  Read Percent          : %d", diskStressReadPercent);
+  LogAppend("  Read Size             : %lld", diskStressReadSize);
+  LogAppend("  Overwrite Percent     : %d", diskStressOverwritePercent);
+  LogAppend("  Overwrite Size        : %d", diskStressOverwriteSize);
+  LogAppend("  Hot Set               : %d%% of overwrites to %d%% of slots", diskStressHotSetPercent, diskStressHotSetSize);
+  LogAppend("  Sync Policy           : %s", DiskStressThreadGetSyncPolicy());
+  LogAppend("  Rate Limit            : %d MB/s %d IOPS", diskStressRateMBps, diskStressRateIOPS);
+  LogAppend("  Arrivals              : %s", DiskStressThreadGetArrival());
+  LogAppend("  Append                : %d bytes, %d files per worker", diskStressAppendChunk, diskStressAppendFiles);
+  LogAppend("  Fan Out               : %s, %d directories each", DiskStressThreadGetFanout(), diskStressVolumes[0].namespace->dirCount);
+  LogAppend("  Metadata              : %s", DiskStressThreadGetMetadata());
+  LogAppend("  Workers               : %d", diskStressWorkerCount);
+  LogAppend("  Seed                  : %llu", (unsigned long long)diskStressSeed);
+  LogAppend("  Duration              : %d seconds, %d phases", diskStressDuration, diskStressPhaseCount);
+  if ( diskStressReplayPath ) {
+    LogAppend("  Replay                : %s, %s", diskStressReplayPath, diskStressReplayFast ? "as fast as possible" : "original timing");
+  } else {
+    LogAppend("  Trace                 : %s", diskStressTracePath ? diskStressTracePath : "off");
+  }
+  config = DiskStressThreadConfigToJSON();
+  s = JSONOutToString(config, 0);
+  LogAppend("  Configuration         : %s", s);
+  FreeMemory(s);
+  JSONOutDestroy(config);
+
+  printf("%sDisk Stress Thread       :%s started%s\n"
+       "  %sFiles Directory        : %s%s%s\n"
+     "  %sAvailable Bytes        : %s%llu%s\n" 
+     "  %sMax Files              : %s%llu%s\n"
+     "  %sMax File Size          : %s%llu%s\n"
+     "  %sWorkers                : %s%d%s\n"
+     "  %sSeed                   : %s%llu%s\n",
+
+     ColorGreen, ColorYellow, ColorReset, 
+     ColorCyan, ColorYellow, diskStressDirectorySpec, ColorReset,
+     ColorCyan, ColorYellow, diskStressThreadAvailableBytes, ColorReset,
+     ColorCyan, ColorYellow, diskStressThreadMaxFiles, ColorReset,
+     ColorCyan, ColorYellow, diskStressMaxFileSize, ColorReset,
+     ColorCyan, ColorYellow, diskStressWorkerCount, ColorReset,
+     ColorCyan, ColorYellow, (unsigned long long)diskStressSeed, ColorReset);
+  UserInputServerThreadStart();
+
+  diskStressThreadStartTime = time(NULL);
+  diskStressInodesStart = DiskInformationGetUsedInodes();
+  diskStressInodesPeak  = diskStressInodesStart;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    volume->trend       = DISK_STRESS_TREND_INCREASE;
+    volume->inodesStart = volume->info.totalInodes - volume->info.freeInodes;
+    volume->inodesPeak  = volume->inodesStart;
+  }
+
+  diskStressReplayStart = TimeStampGetMicroseconds();
+  for ( i = 0 ; i < diskStressWorkerCount ; i++ ) {
+    worker = &(diskStressWorkers[i]);
+    ArrivalScheduleInit(&(worker->arrival), diskStressArrivalType, diskStressArrivalRate / diskStressWorkerCount,
+                        TimeStampGetMicroseconds());
+    if ( pthread_create(&(worker->threadID), NULL, DiskStressWorkerThread, worker) ) {
+      fprintf(stderr, "%sCould not start \"DiskStress Worker %d\"%s\n", ColorRed, i, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  periods = 0;
+  while ( true ) {
+    usleep(DISK_STRESS_MONITOR_PERIOD);
+    if ( ++periods % DISK_STRESS_RESIDENT_PERIODS == 0 ) {
+      FileInfoBlockSetUpdateResident();
+    }
+    DiskInformationRefresh();
+    if ( DiskInformationGetUsedInodes() > diskStressInodesPeak ) {
+      diskStressInodesPeak = DiskInformationGetUsedInodes();
+    }
+    for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+      volume = &(diskStressVolumes[i]);
+      if ( DiskInformationRead(&(volume->info), volume->directory) &&
+           volume->info.totalInodes - volume->info.freeInodes > volume->inodesPeak ) {
+        volume->inodesPeak = volume->info.totalInodes - volume->info.freeInodes;
+      }
+    }
+    DiskStressThreadCheckSchedule(time(NULL) - diskStressThreadStartTime);
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadApplyPhase
+ *  Settings given on the command line after the job file stay as given
+ *****************************************************************************/
+static void
+DiskStressThreadApplyPhase
+(int InPhase)
+{
+  DiskStressPhase*                      phase;
+
+  phase = &(diskStressPhases[InPhase]);
+  diskStressPhaseCurrent = InPhase;
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_READ) ) {
+    DiskStressSettingSet(diskStressReadPercent, phase->readPercent);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_OVERWRITE) ) {
+    DiskStressSettingSet(diskStressOverwritePercent, phase->overwritePercent);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_OVERSIZE) ) {
+    DiskStressSettingSet(diskStressOverwriteSize, phase->overwriteSize);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_HOTSET) ) {
+    DiskStressSettingSet(diskStressHotSetPercent, phase->hotSetPercent);
+    DiskStressSettingSet(diskStressHotSetSize, phase->hotSetSize);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_HIGH) ) {
+    DiskStressSettingSet(diskStressHighUsagePercent, phase->highPercent);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_LOW) ) {
+    DiskStressSettingSet(diskStressLowUsagePercent, phase->lowPercent);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_SLEEP) ) {
+    DiskStressSettingSet(diskStressThreadSleepPeriod, phase->sleepPeriod);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_RATEMBPS) ) {
+    DiskStressSettingSet(diskStressRateMBps, phase->rateMBps);
+  }
+  if ( !(diskStressPhaseOverrides & DISK_STRESS_SETTING_RATEIOPS) ) {
+    DiskStressSettingSet(diskStressRateIOPS, phase->rateIOPS);
+  }
+  if ( diskStressRateLimiter ) {
+    RateLimiterSetRates(diskStressRateLimiter, (uint64_t)DiskStressSettingGet(diskStressRateMBps) * 1000000, DiskStressSettingGet(diskStressRateIOPS));
+  }
+  LogAppend("Phase                   : %s, %d of %d, %d seconds", phase->name, InPhase + 1, diskStressPhaseCount,
+            phase->duration);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSaveSettings
+ *  Copies the settings a phase can change into InPhase
+ *****************************************************************************/
+static void
+DiskStressThreadSaveSettings
+(DiskStressPhase* InPhase)
+{
+  InPhase->name             = NULL;
+  InPhase->duration         = 0;
+  InPhase->readPercent      = diskStressReadPercent;
+  InPhase->overwritePercent = diskStressOverwritePercent;
+  InPhase->overwriteSize    = diskStressOverwriteSize;
+  InPhase->hotSetPercent    = diskStressHotSetPercent;
+  InPhase->hotSetSize       = diskStressHotSetSize;
+  InPhase->highPercent      = diskStressHighUsagePercent;
+  InPhase->lowPercent       = diskStressLowUsagePercent;
+  InPhase->sleepPeriod      = diskStressThreadSleepPeriod;
+  InPhase->rateMBps         = diskStressRateMBps;
+  InPhase->rateIOPS         = diskStressRateIOPS;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadCheckSchedule
+ *  Moves on to the phase InElapsed seconds falls in and ends the run once
+ *  its duration is up.  Without --duration a run with phases lasts as long
+ *  as the phases, unless the last one is open ended.
+ *****************************************************************************/
+static void
+DiskStressThreadCheckSchedule
+(time_t InElapsed)
+{
+  time_t                                start, end;
+  int                                   i, phase;
+
+  phase = 0;
+  start = 0;
+  for ( i = 0 ; i + 1 < diskStressPhaseCount && diskStressPhases[i].duration ; i++ ) {
+    start += diskStressPhases[i].duration;
+    if ( InElapsed < start ) {
+      break;
+    }
+    phase = i + 1;
+  }
+  if ( diskStressPhaseCount && phase != diskStressPhaseCurrent ) {
+    DiskStressThreadApplyPhase(phase);
+  }
+
+  end = diskStressDuration;
+  if ( end == 0 && diskStressPhaseCount ) {
+    for ( i = 0 ; i < diskStressPhaseCount && diskStressPhases[i].duration ; i++ ) {
+      end += diskStressPhases[i].duration;
+    }
+    if ( i < diskStressPhaseCount ) {
+      end = 0;
+    }
+  }
+  if ( diskStressReplayPath && DiskStressCounterGet(diskStressReplayFinished) == diskStressWorkerCount ) {
+    DiskStressThreadFinish(InElapsed);
+  }
+  if ( end == 0 || InElapsed < end ) {
+    return;
+  }
+  DiskStressThreadFinish(InElapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadFinish
+ *  Logs the final results and ends the program, a trace being recorded is
+ *  closed on the way out
+ *****************************************************************************/
+static void
+DiskStressThreadFinish
+(time_t InElapsed)
+{
+  JSONOut*                              info;
+  string                                s;
+
+  LogAppend("Disk Stress Thread      : finished after %d seconds", (int)InElapsed);
+  info = DiskStressThreadStressInfoToJSON();
+  s = JSONOutToString(info, 0);
+  LogAppend("  Results               : %s", s);
+  FreeMemory(s);
+  JSONOutDestroy(info);
+  printf("%sDisk Stress Thread       :%s finished after %d seconds%s\n", ColorGreen, ColorYellow, (int)InElapsed, ColorReset);
+  exit(EXIT_SUCCESS);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadOpenReplay
+ *  The file set is sized from the trace header, so every recorded slot
+ *  exists and belongs to the worker that recorded it
+ *****************************************************************************/
+static void
+DiskStressThreadOpenReplay
+()
+{
+  TraceHeader*                          header;
+
+  diskStressTrace = TraceOpen(diskStressReplayPath);
+  if ( NULL == diskStressTrace ) {
+    exit(EXIT_FAILURE);
+  }
+  header = &(diskStressTrace->header);
+  diskStressWorkerCount    = (int)header->workers;
+  diskStressThreadMaxFiles = header->maxFiles;
+  diskStressMaxFileSize    = header->maxFileSize;
+  diskStressAppendFiles    = (int)header->appendFiles;
+  if ( diskStressSizeDistribution ) {
+    FileSizeDistributionDestroy(diskStressSizeDistribution);
+    diskStressSizeDistribution = NULL;
+  }
+  if ( diskStressMetadata || diskStressAppendChunk ) {
+    LogAppend("Replay                  : the trace decides the operations, metadata and append modes are off");
+    diskStressMetadata    = false;
+    diskStressAppendChunk = 0;
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadCloseTrace
+ *  Registered with atexit() so the records still in the rings are written
+ *****************************************************************************/
+static void
+DiskStressThreadCloseTrace
+()
+{
+  TraceClose(diskStressTrace);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerThread
+ *****************************************************************************/
+static void*
+DiskStressWorkerThread
+(void* InParameters)
+{
+  DiskStressWorker*                     worker;
+  char                                  name[32];
+
+  worker = (DiskStressWorker*)InParameters;
+  sprintf(name, "worker%d", worker->id);
+  ThreadAffinityApplyWorker(name, worker->id);
+  if ( diskStressReplayPath ) {
+    DiskStressWorkerReplayLoop(worker);
+    return NULL;
+  }
+  if ( diskStressEngine == DISK_STRESS_ENGINE_IOURING ) {
+    worker->engine = IOURingEngineCreate(diskStressIODepth, worker->writeBuffer->size,
+                                         worker->writeBuffer->alignment,
+                                         worker->writeBuffer->directIO, diskStressVerify,
+                                         diskStressSync, diskStressMaxFileSize);
+    if ( NULL == worker->engine ) {
+      LogAppend("Worker %d I/O Engine     : io_uring unavailable, using sync", worker->id);
+      fprintf(stderr, "%sio_uring engine unavailable : using synchronous I/O%s\n", ColorRed, ColorReset);
+    } else {
+      LogAppend("Worker %d I/O Engine     : io_uring, depth %d", worker->id, worker->engine->depth);
+      DiskStressWorkerIOURingLoop(worker);
+    }
+  }
+  DiskStressWorkerSyncLoop(worker);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerSyncLoop
+ *  With an arrival schedule each pass waits for the next intended start,
+ *  a pass that falls behind runs late rather than pushing the schedule back
+ *****************************************************************************/
+static void
+DiskStressWorkerSyncLoop
+(DiskStressWorker* InWorker)
+{
+  uint64_t                              intended;
+  bool                                  done;
+  int                                   tries;
+
+  while ( true ) {
+    DiskStressThreadUpdateTrend(InWorker->volume);
+    intended = DiskStressWorkerWaitForArrival(InWorker);
+    done = DiskStressWorkerSyncOperation(InWorker);
+
+    //! An arrival stands for one operation, keep looking for a slot to act on
+    for ( tries = 0 ; intended && !done && tries < 16 ; tries++ ) {
+      done = DiskStressWorkerSyncOperation(InWorker);
+    }
+    DiskStressCounterAdd(InWorker->iterations, 1);
+    if ( !done ) {
+      DiskStressCounterAdd(InWorker->idleIterations, 1);
+    }
+    if ( intended && done ) {
+      LatencyHistogramAdd(&(InWorker->responseLatency), TimeStampGetMicroseconds() - intended);
+    }
+    DiskStressWorkerPace();
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerSyncOperation
+ *  Returns true when a file was read, overwritten, created, appended to or
+ *  removed.  In append mode files are only created by DiskStressWorkerAppend,
+ *  and the ones still growing are pending so they are not read or removed.
+ *****************************************************************************/
+static bool
+DiskStressWorkerSyncOperation
+(DiskStressWorker* InWorker)
+{
+  FileInfoBlock*                        infoBlock;
+  uint64_t                              elapsed, syncElapsed, startTime;
+  DiskStressOp                          op;
+  DiskStressUsageTrend                  trend;
+  bool                                  done;
+
+  if ( diskStressMetadata ) {
+    return DiskStressWorkerMetadataOperation(InWorker);
+  }
+  op = DiskStressWorkerGetOp(InWorker);
+  if ( op == DISK_STRESS_OP_READ ) {
+    infoBlock = DiskStressWorkerGetOccupiedBlock(InWorker);
+    if ( NULL == infoBlock ) {
+      return false;
+    }
+    DiskStressWorkerReadFile(InWorker, infoBlock);
+    return true;
+  }
+  if ( op == DISK_STRESS_OP_OVERWRITE ) {
+    infoBlock = DiskStressWorkerGetOverwriteBlock(InWorker);
+    if ( NULL == infoBlock ) {
+      return false;
+    }
+    DiskStressWorkerOverwriteFile(InWorker, infoBlock);
+    return true;
+  }
+  if ( diskStressAppendChunk && DiskStressWorkerAppend(InWorker) ) {
+    return true;
+  }
+  trend = InWorker->volume->trend;
+  if ( trend == DISK_STRESS_TREND_INCREASE && diskStressAppendChunk ) {
+    return false;
+  }
+  infoBlock = DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, InWorker->lastIndex,
+                                             trend == DISK_STRESS_TREND_DECREASE);
+  if ( NULL == infoBlock ) {
+    return false;
+  }
+
+  if ( trend == DISK_STRESS_TREND_INCREASE ) {
+    FileInfoBlockSetBlock(infoBlock, DiskStressWorkerGetFileSize(InWorker));
+    DiskStressWorkerThrottle(infoBlock->filesize);
+    syncElapsed = 0;
+    elapsed = 0;
+    done = FileInfoBlockCreateFile(infoBlock, InWorker->volume->directory, InWorker->writeBuffer, &elapsed, &syncElapsed);
+    DiskStressWorkerTrace(InWorker, TRACE_OP_CREATE, infoBlock, 0, infoBlock->filesize, elapsed, done ? 0 : -1);
+    if ( done ) {
+      DiskStressWorkerRecordWrite(InWorker, infoBlock->filesize, elapsed);
+      DiskStressWorkerCheckSync(InWorker, syncElapsed);
+    }
+    DiskStressCounterAdd(InWorker->filesCreated, 1);
+    return true;
+  }
+  if ( diskStressVerify && infoBlock->filesize > 0 ) {
+    DiskStressWorkerVerifyFile(InWorker, infoBlock);
+  }
+  DiskStressWorkerThrottle(0);
+  startTime = TimeStampGetMicroseconds();
+  done = FileInfoBlockRemoveFile(infoBlock, InWorker->volume->directory);
+  DiskStressWorkerTrace(InWorker, TRACE_OP_REMOVE, infoBlock, 0, infoBlock->filesize,
+                        TimeStampGetMicroseconds() - startTime, done ? 0 : -1);
+  FileInfoBlockClearBlock(infoBlock);
+  DiskStressCounterAdd(InWorker->filesRemoved, 1);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerMetadataOperation
+ *  One create, stat, rename, setattr or unlink of a zero length file.  The
+ *  worker's slice is kept between the low and high percentages by turning a
+ *  create into an unlink at the top and an unlink into a create at the
+ *  bottom, the rest of the mix is taken as given.  Returns false when no
+ *  suitable slot turned up.
+ *****************************************************************************/
+static bool
+DiskStressWorkerMetadataOperation
+(DiskStressWorker* InWorker)
+{
+  FileInfoBlock*                        infoBlock;
+  FileInfoBlock*                        target;
+  DiskStressMetaOp                      op;
+  int                                   percent, roll;
+  mode_t                                mode;
+
+  op = DiskStressWorkerGetMetaOp(InWorker);
+  percent = (int)(InWorker->liveFiles * 100 / (InWorker->lastIndex - InWorker->firstIndex));
+  if ( op == DISK_STRESS_META_CREATE && percent >= DiskStressSettingGet(diskStressHighUsagePercent) ) {
+    op = DISK_STRESS_META_UNLINK;
+  } else if ( op == DISK_STRESS_META_UNLINK && percent <= DiskStressSettingGet(diskStressLowUsagePercent) ) {
+    op = DISK_STRESS_META_CREATE;
+  }
+
+  target = NULL;
+  infoBlock = DiskStressWorkerGetMetaBlock(InWorker, op != DISK_STRESS_META_CREATE);
+  if ( NULL == infoBlock ) {
+    return false;
+  }
+  if ( op == DISK_STRESS_META_RENAME ) {
+    target = DiskStressWorkerGetMetaBlock(InWorker, false);
+    if ( NULL == target ) {
+      return false;
+    }
+  }
+
+  mode = 0;
+  if ( op == DISK_STRESS_META_SETATTR ) {
+    //! Half mode changes, flipping between two modes, half time stamps
+    roll = RandomBounded(&(InWorker->random), 4);
+    mode = roll == 0 ? 0600 : roll == 1 ? 0644 : 0;
+  }
+  DiskStressWorkerMetadataApply(InWorker, op, infoBlock, target, mode);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerMetadataApply
+ *  Carries out one metadata operation on slots already chosen, by
+ *  DiskStressWorkerMetadataOperation or by a replay.  A zero InMode sets the
+ *  time stamps instead of the mode.
+ *****************************************************************************/
+static bool
+DiskStressWorkerMetadataApply
+(DiskStressWorker* InWorker, DiskStressMetaOp InOp, FileInfoBlock* InBlock, FileInfoBlock* InTarget, mode_t InMode)
+{
+  uint64_t                              startTime, elapsed;
+  bool                                  done;
+
+  DiskStressWorkerThrottle(0);
+  startTime = TimeStampGetMicroseconds();
+  if ( InOp == DISK_STRESS_META_CREATE ) {
+    done = FileInfoBlockCreateEmptyFile(InBlock, InWorker->volume->directory);
+  } else if ( InOp == DISK_STRESS_META_STAT ) {
+    done = FileInfoBlockStatFile(InBlock, InWorker->volume->directory);
+  } else if ( InOp == DISK_STRESS_META_RENAME ) {
+    done = FileInfoBlockRenameFile(InBlock, InTarget, InWorker->volume->directory);
+  } else if ( InOp == DISK_STRESS_META_SETATTR ) {
+    done = FileInfoBlockSetAttributes(InBlock, InWorker->volume->directory, InMode);
+  } else {
+    done = FileInfoBlockRemoveFile(InBlock, InWorker->volume->directory);
+  }
+  elapsed = TimeStampGetMicroseconds() - startTime;
+  DiskStressWorkerTrace(InWorker, TRACE_OP_CREATE_EMPTY + InOp, InBlock,
+                        InOp == DISK_STRESS_META_RENAME ? FileInfoBlockGetIndex(InTarget) - 1 : InOp == DISK_STRESS_META_SETATTR ? InMode : 0,
+                        0, elapsed, done ? 0 : -1);
+
+  //! A failed unlink still frees the slot, the file is gone either way
+  if ( InOp == DISK_STRESS_META_UNLINK ) {
+    FileInfoBlockClearBlock(InBlock);
+    InWorker->liveFiles--;
+    DiskStressCounterAdd(InWorker->filesRemoved, 1);
+  }
+  if ( !done ) {
+    DiskStressCounterAdd(InWorker->metaErrors, 1);
+    return false;
+  }
+  if ( InOp == DISK_STRESS_META_CREATE ) {
+    FileInfoBlockSetEmptyBlock(InBlock);
+    InWorker->liveFiles++;
+    DiskStressCounterAdd(InWorker->filesCreated, 1);
+  } else if ( InOp == DISK_STRESS_META_RENAME ) {
+    FileInfoBlockSetEmptyBlock(InTarget);
+    FileInfoBlockClearBlock(InBlock);
+  }
+  DiskStressCounterAdd(InWorker->metaOps[InOp], 1);
+  LatencyHistogramAdd(&(InWorker->metaLatency[InOp]), elapsed);
+
+  //! Only the batched policies apply, there is no data to fsync
+  if ( InWorker->directoryFD >= 0 && InOp != DISK_STRESS_META_STAT ) {
+    DiskStressWorkerCheckSync(InWorker, 0);
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetMetaOp
+ *****************************************************************************/
+static DiskStressMetaOp
+DiskStressWorkerGetMetaOp
+(DiskStressWorker* InWorker)
+{
+  int                                   i, total, roll;
+
+  total = 0;
+  for ( i = 0 ; i < DISK_STRESS_META_COUNT ; i++ ) {
+    total += diskStressMetaMix[i];
+  }
+  roll = RandomBounded(&(InWorker->random), total);
+  for ( i = 0 ; i < DISK_STRESS_META_COUNT - 1 ; i++ ) {
+    if ( roll < diskStressMetaMix[i] ) {
+      break;
+    }
+    roll -= diskStressMetaMix[i];
+  }
+  return (DiskStressMetaOp)i;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetMetaBlock
+ *  A random slot whose file exists when InOccupied is set, an empty one
+ *  otherwise
+ *****************************************************************************/
+static FileInfoBlock*
+DiskStressWorkerGetMetaBlock
+(DiskStressWorker* InWorker, bool InOccupied)
+{
+  return DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, InWorker->lastIndex, InOccupied);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerAppend
+ *  Appends one chunk to the next growing file, round robin, after starting a
+ *  new one if there is room.  Returns false when nothing is growing.
+ *****************************************************************************/
+static bool
+DiskStressWorkerAppend
+(DiskStressWorker* InWorker)
+{
+  FileInfoBlockAppender*                appender;
+
+  if ( InWorker->appendCount < diskStressAppendFiles && InWorker->volume->trend == DISK_STRESS_TREND_INCREASE ) {
+    DiskStressWorkerStartAppend(InWorker);
+  }
+  if ( InWorker->appendCount == 0 ) {
+    return false;
+  }
+  InWorker->appendNext %= InWorker->appendCount;
+  appender = &(InWorker->appenders[InWorker->appendNext++]);
+  DiskStressWorkerAppendChunk(InWorker, appender, diskStressAppendChunk);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerAppendChunk
+ *  Shared by generated and replayed appends, the file is finished once it
+ *  reaches its size
+ *****************************************************************************/
+static void
+DiskStressWorkerAppendChunk
+(DiskStressWorker* InWorker, FileInfoBlockAppender* InAppender, uint32_t InChunkSize)
+{
+  int64_t                               n;
+  uint64_t                              elapsed;
+
+  DiskStressWorkerThrottle(InChunkSize);
+  elapsed = 0;
+  n = FileInfoBlockAppendChunk(InAppender, InWorker->writeBuffer, InChunkSize, &elapsed);
+  DiskStressWorkerTrace(InWorker, TRACE_OP_APPEND, InAppender->block, InAppender->written - (n < 0 ? 0 : n),
+                        n < 0 ? InChunkSize : (uint64_t)n, elapsed, n < 0 ? -1 : 0);
+  if ( n < 0 ) {
+    DiskStressWorkerFinishAppend(InWorker, InAppender, false);
+    return;
+  }
+  DiskStressWorkerRecordWrite(InWorker, (uint64_t)n, elapsed);
+  DiskStressCounterAdd(InWorker->appends, 1);
+  LatencyHistogramAdd(&(InWorker->appendLatency), elapsed);
+  if ( InAppender->written >= InAppender->block->filesize ) {
+    DiskStressWorkerFinishAppend(InWorker, InAppender, true);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerStartAppend
+ *****************************************************************************/
+static void
+DiskStressWorkerStartAppend
+(DiskStressWorker* InWorker)
+{
+  FileInfoBlock*                        infoBlock;
+  FileInfoBlockAppender*                appender;
+  uint64_t                              size;
+
+  infoBlock = DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, InWorker->lastIndex, false);
+  if ( NULL == infoBlock ) {
+    return;
+  }
+  size = DiskStressWorkerGetFileSize(InWorker);
+  if ( size == 0 ) {
+    return;
+  }
+  FileInfoBlockSetBlock(infoBlock, size);
+  appender = &(InWorker->appenders[InWorker->appendCount]);
+  if ( !FileInfoBlockAppendOpen(appender, infoBlock, InWorker->volume->directory, InWorker->writeBuffer) ) {
+    FileInfoBlockClearBlock(infoBlock);
+    return;
+  }
+  infoBlock->pending = true;
+  InWorker->appendCount++;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerFinishAppend
+ *  Closes a file that has reached its size, or removes one that could not
+ *  be written, and drops it from the growing set
+ *****************************************************************************/
+static void
+DiskStressWorkerFinishAppend
+(DiskStressWorker* InWorker, FileInfoBlockAppender* InAppender, bool InWritten)
+{
+  FileInfoBlock*                        infoBlock;
+  uint64_t                              syncElapsed;
+  uint32_t                              extents, pending;
+
+  infoBlock = InAppender->block;
+  syncElapsed = 0;
+  extents = 0;
+  pending = 0;
+  if ( !FileInfoBlockAppendClose(InAppender, InWorker->writeBuffer, &syncElapsed, &extents, &pending) ) {
+    InWritten = false;
+  }
+  DiskStressWorkerTrace(InWorker, TRACE_OP_CLOSE, infoBlock, 0, InAppender->written, syncElapsed, InWritten ? 0 : -1);
+  infoBlock->pending = false;
+  if ( InWritten ) {
+    DiskStressWorkerCheckSync(InWorker, syncElapsed);
+    DiskStressExtentCountsAdd(&(InWorker->extents), extents, pending);
+    DiskStressCounterAdd(InWorker->filesCreated, 1);
+  } else {
+    FileInfoBlockRemoveFile(infoBlock, InWorker->volume->directory);
+    FileInfoBlockClearBlock(infoBlock);
+  }
+  *InAppender = InWorker->appenders[--InWorker->appendCount];
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerIOURingLoop
+ *  Keeps up to diskStressIODepth create/remove chains in flight.  Blocks with
+ *  a chain in flight are marked pending so they are not picked twice.  With
+ *  an arrival schedule a chain is only submitted once its intended start has
+ *  passed, and its response time is taken from that intended start.
+ *****************************************************************************/
+static void
+DiskStressWorkerIOURingLoop
+(DiskStressWorker* InWorker)
+{
+  IOURingEngine*                        engine;
+  IOURingEngineCompletion*              completions;
+  IOURingEngineCompletion*              completion;
+  FileInfoBlock*                        infoBlock;
+  int                                   i, n, tries;
+  uint64_t                              offset, length, intended;
+  DiskStressOp                          op;
+  DiskStressUsageTrend                  trend;
+
+  engine = InWorker->engine;
+  completions = (IOURingEngineCompletion*)GetMemory(sizeof(IOURingEngineCompletion) * engine->depth);
+
+  while ( true ) {
+    DiskStressThreadUpdateTrend(InWorker->volume);
+    for ( tries = 0 ; tries < engine->depth * 4 && IOURingEngineHasFreeSlot(engine) ; tries++ ) {
+      if ( !DiskStressWorkerRateReady(engine) || !DiskStressWorkerArrivalReady(InWorker) ) {
+        break;
+      }
+      intended = ArrivalScheduleGetNext(&(InWorker->arrival));
+      op = DiskStressWorkerGetOp(InWorker);
+      DiskStressCounterAdd(InWorker->iterations, 1);
+      if ( op == DISK_STRESS_OP_OVERWRITE ) {
+        //! Overwrites are small and done in place, the block is not pending
+        //  so no chain is using the file
+        infoBlock = DiskStressWorkerGetOverwriteBlock(InWorker);
+        if ( NULL == infoBlock ) {
+          DiskStressCounterAdd(InWorker->idleIterations, 1);
+        } else {
+          DiskStressWorkerOverwriteFile(InWorker, infoBlock);
+          ArrivalScheduleAdvance(&(InWorker->arrival), &(InWorker->random));
+        }
+        continue;
+      }
+      if ( op == DISK_STRESS_OP_READ ) {
+        infoBlock = DiskStressWorkerGetOccupiedBlock(InWorker);
+        if ( NULL == infoBlock ) {
+          DiskStressCounterAdd(InWorker->idleIterations, 1);
+        } else {
+          DiskStressWorkerGetReadRange(InWorker, infoBlock, &offset, &length);
+          DiskStressWorkerThrottle(length);
+          //! The submission queue is full, reap and come back to it
+          if ( !IOURingEngineSubmitRead(engine, infoBlock, InWorker->volume->directory, offset, length, intended) ) {
+            break;
+          }
+          infoBlock->pending = true;
+          ArrivalScheduleAdvance(&(InWorker->arrival), &(InWorker->random));
+        }
+        continue;
+      }
+      trend = InWorker->volume->trend;
+      infoBlock = DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, InWorker->lastIndex,
+                                                 trend == DISK_STRESS_TREND_DECREASE);
+      //! The slice is full, or empty, until the other workers catch up and
+      //  the trend turns
+      if ( NULL == infoBlock ) {
+        DiskStressCounterAdd(InWorker->idleIterations, 1);
+        break;
+      }
+      if ( trend == DISK_STRESS_TREND_INCREASE ) {
+        FileInfoBlockSetBlock(infoBlock, DiskStressWorkerGetFileSize(InWorker));
+        DiskStressWorkerThrottle(infoBlock->filesize);
+        if ( !IOURingEngineSubmitCreate(engine, infoBlock, InWorker->volume->directory, intended) ) {
+          FileInfoBlockClearBlock(infoBlock);
+          break;
+        }
+        infoBlock->pending = true;
+        ArrivalScheduleAdvance(&(InWorker->arrival), &(InWorker->random));
+      } else {
+        //! Read back synchronously, the block is not pending yet so no chain
+        //  can be touching the file
+        if ( diskStressVerify ) {
+          DiskStressWorkerVerifyFile(InWorker, infoBlock);
+        }
+        DiskStressWorkerThrottle(0);
+        if ( !IOURingEngineSubmitRemove(engine, infoBlock, InWorker->volume->directory, intended) ) {
+          break;
+        }
+        infoBlock->pending = true;
+        ArrivalScheduleAdvance(&(InWorker->arrival), &(InWorker->random));
+      }
+    }
+
+    //! Nothing in flight and nothing to submit, wait instead of spinning
+    n = IOURingEngineReap(engine, completions, engine->depth);
+    if ( n == 0 && engine->inFlight == 0 ) {
+      DiskStressWorkerPace();
+    }
+    for ( i = 0 ; i < n ; i++ ) {
+      completion = &(completions[i]);
+      infoBlock = completion->block;
+      infoBlock->pending = false;
+      if ( diskStressArrivalType != ARRIVAL_SCHEDULE_NONE && completion->result == 0 ) {
+        LatencyHistogramAdd(&(InWorker->responseLatency), completion->responseTime);
+      }
+      if ( completion->op == IOURING_ENGINE_OP_READ ) {
+        DiskStressWorkerTrace(InWorker, TRACE_OP_READ, infoBlock, completion->offset, completion->bytes,
+                              completion->elapsed, completion->result);
+        if ( completion->result == 0 ) {
+          DiskStressWorkerRecordRead(InWorker, completion->bytes, completion->elapsed);
+        }
+        continue;
+      }
+      if ( completion->op == IOURING_ENGINE_OP_CREATE ) {
+        DiskStressWorkerTrace(InWorker, TRACE_OP_CREATE, infoBlock, 0, infoBlock->filesize,
+                              completion->elapsed, completion->result);
+        if ( completion->result < 0 ) {
+          FileInfoBlockClearBlock(infoBlock);
+          continue;
+        }
+        DiskStressWorkerRecordWrite(InWorker, completion->bytes, completion->elapsed);
+        DiskStressWorkerCheckSync(InWorker, completion->syncElapsed);
+        DiskStressCounterAdd(InWorker->filesCreated, 1);
+        continue;
+      }
+      DiskStressWorkerTrace(InWorker, TRACE_OP_REMOVE, infoBlock, 0, infoBlock->filesize,
+                            completion->elapsed, completion->result);
+      FileInfoBlockClearBlock(infoBlock);
+      DiskStressCounterAdd(InWorker->filesRemoved, 1);
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetRandomBlock
+ *  A uniformly chosen occupied, or empty, slot in [InFirst, InLast) that no
+ *  chain or append is using, NULL when there is none.  Only a handful of
+ *  slots are ever pending so a few draws step around them.
+ *****************************************************************************/
+static FileInfoBlock*
+DiskStressWorkerGetRandomBlock
+(DiskStressWorker* InWorker, int64_t InFirst, int64_t InLast, bool InOccupied)
+{
+  FileInfoBlock*                        infoBlock;
+  int                                   tries;
+
+  for ( tries = 0 ; tries < DISK_STRESS_PENDING_TRIES ; tries++ ) {
+    infoBlock = FileInfoBlockGetRandomBlock(InFirst, InLast, InOccupied, &(InWorker->random));
+    if ( NULL == infoBlock ) {
+      return NULL;
+    }
+    if ( !infoBlock->pending ) {
+      return infoBlock;
+    }
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadUpdateTrend
+ *  Shared by all workers, the lock keeps the cycle count from being bumped
+ *  more than once per turn around
+ *****************************************************************************/
+static void
+DiskStressThreadUpdateTrend
+(DiskStressVolume* InVolume)
+{
+  uint64_t                              diskTotalFileSize;
+  uint64_t                              diskCurrentFileSize;
+  int                                   diskUsedPercent;
+
+  diskTotalFileSize   = InVolume->lastIndex - InVolume->firstIndex;
+  diskCurrentFileSize = FileInfoBlockGetRangeCount(InVolume->firstIndex, InVolume->lastIndex);
+  diskUsedPercent     = (int)(diskCurrentFileSize * 100 / diskTotalFileSize);
+  pthread_mutex_lock(&diskStressTrendMutex);
+  if ( InVolume->trend == DISK_STRESS_TREND_INCREASE ) {
+    if ( diskUsedPercent >= DiskStressSettingGet(diskStressHighUsagePercent) ) {
+      InVolume->trend = DISK_STRESS_TREND_DECREASE;
+    }
+  } else {
+    if ( diskUsedPercent <= DiskStressSettingGet(diskStressLowUsagePercent) ) {
+      InVolume->trend = DISK_STRESS_TREND_INCREASE;
+      InVolume->cycleCount++;
+    }
+  }
+  pthread_mutex_unlock(&diskStressTrendMutex);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerRecordWrite
+ *  Each worker keeps its own last write, lastwriterate combines them
+ *****************************************************************************/
+static void
+DiskStressWorkerRecordWrite
+(DiskStressWorker* InWorker, uint64_t InBytes, uint64_t InElapsed)
+{
+  DiskStressCounterAdd(InWorker->bytesWritten, InBytes);
+  DiskStressCounterAdd(InWorker->writeTime, InElapsed);
+  DiskStressCounterSet(InWorker->lastWriteBytes, InBytes);
+  DiskStressCounterSet(InWorker->lastWriteTime, InElapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerVerifyFile
+ *  Reads the file back before it is removed and checks it against the
+ *  checksum recorded when it was written
+ *****************************************************************************/
+static void
+DiskStressWorkerVerifyFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock)
+{
+  uint64_t                              elapsed;
+  uint32_t                              checksum;
+  bool                                  verified;
+
+  elapsed = 0;
+  verified = FileInfoBlockVerifyFile(InBlock, InWorker->volume->directory, InWorker->writeBuffer, &elapsed, &checksum);
+  DiskStressWorkerTrace(InWorker, TRACE_OP_VERIFY, InBlock, 0, InBlock->filesize, elapsed, verified ? 0 : -EIO);
+  if ( verified ) {
+    DiskStressCounterAdd(InWorker->filesVerified, 1);
+    DiskStressCounterAdd(InWorker->bytesVerified, InBlock->filesize);
+    DiskStressCounterAdd(InWorker->verifyTime, elapsed);
+    return;
+  }
+  DiskStressCounterAdd(InWorker->verifyErrors, 1);
+  LogAppend("Verify Error            : slot %d generation %d expected %08x read %08x",
+            FileInfoBlockGetIndex(InBlock), InBlock->generation, FileInfoBlockGetChecksum(InBlock), checksum);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetFileSize
+ *****************************************************************************/
+static uint64_t
+DiskStressWorkerGetFileSize
+(DiskStressWorker* InWorker)
+{
+  uint64_t                              size;
+
+  size = FileSizeDistributionSample(diskStressSizeDistribution, &(InWorker->random));
+  FileSizeDistributionRecord(diskStressSizeDistribution, size);
+  return size;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerThrottle
+ *  Waits for the rate limiter before an operation moving InBytes
+ *****************************************************************************/
+static void
+DiskStressWorkerThrottle
+(uint64_t InBytes)
+{
+  uint64_t                              delay;
+
+  if ( !DiskStressThreadRateLimited() ) {
+    return;
+  }
+  delay = RateLimiterAcquire(diskStressRateLimiter, InBytes);
+  if ( delay ) {
+    usleep(delay);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerRateReady
+ *  With chains in flight the io_uring loop goes back to reaping rather than
+ *  sleeping on the rate limiter, so completions are not held up
+ *****************************************************************************/
+static bool
+DiskStressWorkerRateReady
+(IOURingEngine* InEngine)
+{
+  uint64_t                              delay;
+
+  if ( !DiskStressThreadRateLimited() ) {
+    return true;
+  }
+  delay = RateLimiterGetDelay(diskStressRateLimiter);
+  if ( delay == 0 ) {
+    return true;
+  }
+  if ( InEngine->inFlight > 0 ) {
+    return false;
+  }
+  usleep(delay);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerPace
+ *  The fixed sleep between operations is only used without a rate limit or
+ *  an arrival schedule
+ *****************************************************************************/
+static void
+DiskStressWorkerPace
+()
+{
+  if ( DiskStressThreadRateLimited() || diskStressArrivalType != ARRIVAL_SCHEDULE_NONE ) {
+    return;
+  }
+  usleep(DiskStressSettingGet(diskStressThreadSleepPeriod));
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadRateLimited
+ *  The limiter outlives a phase that turns the rates off, so check them too
+ *****************************************************************************/
+static bool
+DiskStressThreadRateLimited
+()
+{
+  return diskStressRateLimiter && (DiskStressSettingGet(diskStressRateMBps) || DiskStressSettingGet(diskStressRateIOPS));
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerWaitForArrival
+ *  Sleeps until the next intended start and returns it, 0 without a schedule
+ *****************************************************************************/
+static uint64_t
+DiskStressWorkerWaitForArrival
+(DiskStressWorker* InWorker)
+{
+  uint64_t                              intended, now;
+
+  intended = ArrivalScheduleGetNext(&(InWorker->arrival));
+  if ( intended == 0 ) {
+    return 0;
+  }
+  ArrivalScheduleAdvance(&(InWorker->arrival), &(InWorker->random));
+  now = TimeStampGetMicroseconds();
+  if ( intended > now ) {
+    usleep(intended - now);
+  }
+  return intended;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerArrivalReady
+ *  io_uring version, goes back to reaping instead of sleeping while chains
+ *  are in flight
+ *****************************************************************************/
+static bool
+DiskStressWorkerArrivalReady
+(DiskStressWorker* InWorker)
+{
+  uint64_t                              intended, now;
+
+  intended = ArrivalScheduleGetNext(&(InWorker->arrival));
+  if ( intended == 0 ) {
+    return true;
+  }
+  now = TimeStampGetMicroseconds();
+  if ( intended <= now ) {
+    return true;
+  }
+  if ( InWorker->engine->inFlight > 0 ) {
+    return false;
+  }
+  usleep(intended - now);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetOp
+ *  Rolls the read/overwrite/write mix for the next operation.  Overwrites
+ *  get whatever is left of diskStressOverwritePercent after the reads.
+ *****************************************************************************/
+static DiskStressOp
+DiskStressWorkerGetOp
+(DiskStressWorker* InWorker)
+{
+  int                                   roll, readPercent, overwritePercent;
+
+  readPercent      = DiskStressSettingGet(diskStressReadPercent);
+  overwritePercent = DiskStressSettingGet(diskStressOverwritePercent);
+  if ( readPercent == 0 && overwritePercent == 0 ) {
+    return DISK_STRESS_OP_WRITE;
+  }
+  roll = RandomBounded(&(InWorker->random), 100);
+  if ( roll < readPercent ) {
+    return DISK_STRESS_OP_READ;
+  }
+  if ( roll < readPercent + overwritePercent ) {
+    return DISK_STRESS_OP_OVERWRITE;
+  }
+  return DISK_STRESS_OP_WRITE;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetOverwriteBlock
+ *  Picks an occupied slot, from the hot set diskStressHotSetPercent of the
+ *  time when one is configured
+ *****************************************************************************/
+static FileInfoBlock*
+DiskStressWorkerGetOverwriteBlock
+(DiskStressWorker* InWorker)
+{
+  FileInfoBlock*                        infoBlock;
+  int64_t                               slots, hotSlots, hotLast;
+  int                                   hotPercent;
+
+  hotPercent = DiskStressSettingGet(diskStressHotSetPercent);
+  if ( hotPercent == 0 ) {
+    return DiskStressWorkerGetOccupiedBlock(InWorker);
+  }
+  slots = InWorker->lastIndex - InWorker->firstIndex;
+  hotSlots = slots * DiskStressSettingGet(diskStressHotSetSize) / 100;
+  if ( hotSlots < 1 ) {
+    hotSlots = 1;
+  }
+  hotLast = InWorker->firstIndex + hotSlots;
+  if ( hotSlots >= slots || (int)RandomBounded(&(InWorker->random), 100) < hotPercent ) {
+    infoBlock = DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, hotLast, true);
+  } else {
+    infoBlock = DiskStressWorkerGetRandomBlock(InWorker, hotLast, InWorker->lastIndex, true);
+  }
+
+  //! The chosen side may have no files yet, the rest of the slice may
+  if ( NULL == infoBlock ) {
+    infoBlock = DiskStressWorkerGetOccupiedBlock(InWorker);
+  }
+  return infoBlock;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerOverwriteFile
+ *  Rewrites one diskStressOverwriteSize block at a random block aligned
+ *  offset inside the file
+ *****************************************************************************/
+static void
+DiskStressWorkerOverwriteFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock)
+{
+  uint64_t                              offset, length, blocks;
+
+  length = DiskStressSettingGet(diskStressOverwriteSize);
+  offset = 0;
+  if ( length >= InBlock->filesize ) {
+    length = InBlock->filesize;
+  } else {
+    blocks = InBlock->filesize / length;
+    offset = RandomBounded64(&(InWorker->random), blocks) * length;
+  }
+  DiskStressWorkerOverwriteRange(InWorker, InBlock, offset, length);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerOverwriteRange
+ *  Shared by generated and replayed overwrites
+ *****************************************************************************/
+static void
+DiskStressWorkerOverwriteRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InLength)
+{
+  uint64_t                              elapsed, syncElapsed;
+  bool                                  done;
+
+  DiskStressWorkerThrottle(InLength);
+  elapsed = 0;
+  syncElapsed = 0;
+  done = FileInfoBlockOverwriteFile(InBlock, InWorker->volume->directory, InWorker->writeBuffer, InOffset, InLength,
+                                    &elapsed, &syncElapsed);
+  DiskStressWorkerTrace(InWorker, TRACE_OP_OVERWRITE, InBlock, InOffset, InLength, elapsed, done ? 0 : -1);
+  if ( !done ) {
+    return;
+  }
+  DiskStressCounterAdd(InWorker->overwrites, 1);
+  DiskStressCounterAdd(InWorker->bytesOverwritten, InLength);
+  DiskStressCounterAdd(InWorker->overwriteTime, elapsed);
+  LatencyHistogramAdd(&(InWorker->overwriteLatency), elapsed);
+  DiskStressWorkerCheckSync(InWorker, syncElapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetOccupiedBlock
+ *****************************************************************************/
+static FileInfoBlock*
+DiskStressWorkerGetOccupiedBlock
+(DiskStressWorker* InWorker)
+{
+  return DiskStressWorkerGetRandomBlock(InWorker, InWorker->firstIndex, InWorker->lastIndex, true);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerGetReadRange
+ *  The whole file when no read size is set, otherwise diskStressReadSize
+ *  bytes from a random offset, aligned down for direct I/O
+ *****************************************************************************/
+static void
+DiskStressWorkerGetReadRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t* InOffset, uint64_t* InLength)
+{
+  uint64_t                              offset;
+
+  if ( diskStressReadSize == 0 || diskStressReadSize >= InBlock->filesize ) {
+    *InOffset = 0;
+    *InLength = InBlock->filesize;
+    return;
+  }
+  offset = RandomBounded64(&(InWorker->random), InBlock->filesize - diskStressReadSize + 1);
+  if ( InWorker->writeBuffer->directIO ) {
+    offset -= offset % InWorker->writeBuffer->alignment;
+  }
+  *InOffset = offset;
+  *InLength = diskStressReadSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerReadFile
+ *****************************************************************************/
+static void
+DiskStressWorkerReadFile
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock)
+{
+  uint64_t                              offset, length;
+
+  DiskStressWorkerGetReadRange(InWorker, InBlock, &offset, &length);
+  DiskStressWorkerReadRange(InWorker, InBlock, offset, length);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerReadRange
+ *  Shared by generated and replayed reads
+ *****************************************************************************/
+static void
+DiskStressWorkerReadRange
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InLength)
+{
+  uint64_t                              elapsed;
+  int64_t                               bytesRead;
+
+  DiskStressWorkerThrottle(InLength);
+  elapsed = 0;
+  bytesRead = FileInfoBlockReadFile(InBlock, InWorker->volume->directory, InWorker->writeBuffer, InOffset, InLength, &elapsed);
+  DiskStressWorkerTrace(InWorker, TRACE_OP_READ, InBlock, InOffset, bytesRead < 0 ? InLength : (uint64_t)bytesRead,
+                        elapsed, bytesRead < 0 ? -1 : 0);
+  if ( bytesRead < 0 ) {
+    return;
+  }
+  DiskStressWorkerRecordRead(InWorker, (uint64_t)bytesRead, elapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerRecordRead
+ *****************************************************************************/
+static void
+DiskStressWorkerRecordRead
+(DiskStressWorker* InWorker, uint64_t InBytes, uint64_t InElapsed)
+{
+  DiskStressCounterAdd(InWorker->filesRead, 1);
+  DiskStressCounterAdd(InWorker->bytesRead, InBytes);
+  DiskStressCounterAdd(InWorker->readTime, InElapsed);
+  LatencyHistogramAdd(&(InWorker->readLatency), InElapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerRecordSync
+ *****************************************************************************/
+static void
+DiskStressWorkerRecordSync
+(DiskStressWorker* InWorker, uint64_t InElapsed)
+{
+  DiskStressCounterAdd(InWorker->syncs, 1);
+  DiskStressCounterAdd(InWorker->syncTime, InElapsed);
+  LatencyHistogramAdd(&(InWorker->syncLatency), InElapsed);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressExtentCountsAdd
+ *  Only the owning worker adds, the stores are atomic for the readers
+ *****************************************************************************/
+static void
+DiskStressExtentCountsAdd
+(DiskStressExtentCounts* InCounts, uint64_t InExtents, uint64_t InPending)
+{
+  int                                   bucket;
+
+  if ( InPending ) {
+    DiskStressCounterAdd(InCounts->pendingFiles, 1);
+    DiskStressCounterAdd(InCounts->pendingExtents, InPending);
+    return;
+  }
+
+  bucket = InExtents < DISK_STRESS_EXTENT_BUCKETS - 1 ? (int)InExtents : DISK_STRESS_EXTENT_BUCKETS - 1;
+  if ( InCounts->count == 0 || InExtents < InCounts->min ) {
+    __atomic_store_n(&(InCounts->min), InExtents, __ATOMIC_RELAXED);
+  }
+  if ( InExtents > InCounts->max ) {
+    __atomic_store_n(&(InCounts->max), InExtents, __ATOMIC_RELAXED);
+  }
+  DiskStressCounterAdd(InCounts->files[bucket], 1);
+  DiskStressCounterAdd(InCounts->total, InExtents);
+  DiskStressCounterAdd(InCounts->count, 1);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressExtentCountsMerge
+ *****************************************************************************/
+static void
+DiskStressExtentCountsMerge
+(DiskStressExtentCounts* InCounts, DiskStressExtentCounts* InSource)
+{
+  uint64_t                              count, min, max;
+  int                                   i;
+
+  InCounts->pendingFiles   += DiskStressCounterGet(InSource->pendingFiles);
+  InCounts->pendingExtents += DiskStressCounterGet(InSource->pendingExtents);
+  count = DiskStressCounterGet(InSource->count);
+  if ( count == 0 ) {
+    return;
+  }
+  min = DiskStressCounterGet(InSource->min);
+  max = DiskStressCounterGet(InSource->max);
+  if ( InCounts->count == 0 || min < InCounts->min ) {
+    InCounts->min = min;
+  }
+  if ( max > InCounts->max ) {
+    InCounts->max = max;
+  }
+  for ( i = 0 ; i < DISK_STRESS_EXTENT_BUCKETS ; i++ ) {
+    InCounts->files[i] += DiskStressCounterGet(InSource->files[i]);
+  }
+  InCounts->total += DiskStressCounterGet(InSource->total);
+  InCounts->count += count;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressExtentCountsToJSON
+ *  Extents per file, not a latency.  Only the counts in use are listed, the
+ *  last one as "or more".  Files still in delayed allocation are reported
+ *  apart as pending.
+ *****************************************************************************/
+static JSONOut*
+DiskStressExtentCountsToJSON
+(string InTag, DiskStressExtentCounts* InCounts)
+{
+  JSONOut*                              object;
+  JSONOut*                              histogram;
+  JSONOut*                              bucket;
+  int                                   i;
+
+  histogram = JSONOutCreateArray("histogram");
+  for ( i = 0 ; i < DISK_STRESS_EXTENT_BUCKETS ; i++ ) {
+    if ( InCounts->files[i] == 0 ) {
+      continue;
+    }
+    bucket = JSONOutCreateObject(NULL);
+    JSONOutObjectAddObjects(bucket,
+                            JSONOutCreateInt("extents", i),
+                            JSONOutCreateBool("ormore", i == DISK_STRESS_EXTENT_BUCKETS - 1),
+                            JSONOutCreateLongLong("files", InCounts->files[i]),
+                            NULL);
+    JSONOutArrayAddObject(histogram, bucket);
+  }
+
+  object = JSONOutCreateObject(InTag);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateLongLong("files", InCounts->count),
+                          JSONOutCreateLongLong("min", InCounts->min),
+                          JSONOutCreateFloat("mean", InCounts->count ? (double)InCounts->total / InCounts->count : 0.0),
+                          JSONOutCreateLongLong("max", InCounts->max),
+                          JSONOutCreateLongLong("pendingfiles", InCounts->pendingFiles),
+                          JSONOutCreateLongLong("pendingextents", InCounts->pendingExtents),
+                          histogram,
+                          NULL);
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerCheckSync
+ *  Called after each file is written.  Per file policies just record the
+ *  fsync/fdatasync time, batched ones flush the whole file system with
+ *  syncfs() once enough files have been written or enough time has passed.
+ *  A block target has no file system of its own, the device or image is
+ *  flushed with fdatasync() instead.  With O_SYNC and O_DSYNC the flush is
+ *  part of the write time.
+ *****************************************************************************/
+static void
+DiskStressWorkerCheckSync
+(DiskStressWorker* InWorker, uint64_t InSyncElapsed)
+{
+  uint64_t                              now;
+
+  if ( diskStressSync == FILE_INFO_BLOCK_SYNC_FSYNC || diskStressSync == FILE_INFO_BLOCK_SYNC_FDATASYNC ) {
+    DiskStressWorkerRecordSync(InWorker, InSyncElapsed);
+    return;
+  }
+  //! A replay syncs where the trace says to
+  if ( InWorker->directoryFD < 0 || diskStressReplayPath ) {
+    return;
+  }
+  InWorker->unsyncedFiles++;
+  now = TimeStampGetMicroseconds();
+  if ( !(diskStressSyncEveryFiles && InWorker->unsyncedFiles >= diskStressSyncEveryFiles) &&
+       !(diskStressSyncEveryMS && now - InWorker->lastSyncTime >= (uint64_t)diskStressSyncEveryMS * 1000) ) {
+    return;
+  }
+  DiskStressWorkerSyncNow(InWorker);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerSyncNow
+ *  syncfs() on the directory, or fdatasync() on a block target
+ *****************************************************************************/
+static void
+DiskStressWorkerSyncNow
+(DiskStressWorker* InWorker)
+{
+  uint64_t                              now, startTime;
+  int                                   result;
+
+  startTime = TimeStampGetMicroseconds();
+  result = diskStressTarget ? fdatasync(InWorker->directoryFD) : syncfs(InWorker->directoryFD);
+  if ( result ) {
+    result = -errno;
+    fprintf(stderr, "%sCould not sync %s : %s%s\n", ColorRed,
+            diskStressTarget ? diskStressTarget->path : InWorker->volume->directory, strerror(-result), ColorReset);
+  }
+  now = TimeStampGetMicroseconds();
+  DiskStressWorkerTrace(InWorker, TRACE_OP_SYNC, NULL, 0, 0, now - startTime, result);
+  DiskStressWorkerRecordSync(InWorker, now - startTime);
+  InWorker->unsyncedFiles = 0;
+  InWorker->lastSyncTime  = now;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerTrace
+ *  Records one operation when a trace is being recorded.  InBlock is NULL
+ *  for operations on the whole file system.
+ *****************************************************************************/
+static void
+DiskStressWorkerTrace
+(DiskStressWorker* InWorker, TraceOp InOp, FileInfoBlock* InBlock, uint64_t InOffset, uint64_t InSize,
+ uint64_t InElapsed, int32_t InResult)
+{
+  if ( NULL == diskStressTrace || diskStressTrace->reading ) {
+    return;
+  }
+  TraceAdd(diskStressTrace, InWorker->id, InOp, InBlock ? FileInfoBlockGetIndex(InBlock) - 1 : 0, InOffset, InSize,
+           InElapsed, InResult);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerReplayLoop
+ *  Plays back this worker's records, each at its original start time unless
+ *  diskStressReplayFast is set.  Files still growing at the end of the trace
+ *  are closed at the size they reached.
+ *****************************************************************************/
+static void
+DiskStressWorkerReplayLoop
+(DiskStressWorker* InWorker)
+{
+  TraceRecord                           record;
+  FileInfoBlock*                        infoBlock;
+  FileInfoBlockAppender*                appender;
+  uint64_t                              due, now;
+
+  while ( TraceNext(diskStressTrace, InWorker->id, &record) ) {
+    infoBlock = record.op == TRACE_OP_SYNC ? NULL : FileInfoBlockGetBlock(record.slot);
+    if ( record.op >= TRACE_OP_COUNT || (record.op != TRACE_OP_SYNC && NULL == infoBlock) ) {
+      continue;
+    }
+    if ( !diskStressReplayFast ) {
+      due = diskStressReplayStart + record.timestamp;
+      now = TimeStampGetMicroseconds();
+      if ( due > now ) {
+        usleep(due - now);
+      }
+    }
+    DiskStressWorkerReplayOperation(InWorker, &record, infoBlock);
+  }
+  while ( InWorker->appendCount ) {
+    appender = &(InWorker->appenders[0]);
+    FileInfoBlockSetFileSize(appender->block, appender->written);
+    DiskStressWorkerFinishAppend(InWorker, appender, appender->written > 0);
+  }
+  DiskStressCounterAdd(diskStressReplayFinished, 1);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerReplayOperation
+ *  Operations that failed when recorded are skipped, except those that
+ *  released their slot anyway
+ *****************************************************************************/
+static void
+DiskStressWorkerReplayOperation
+(DiskStressWorker* InWorker, TraceRecord* InRecord, FileInfoBlock* InBlock)
+{
+  FileInfoBlockAppender*                appender;
+  FileInfoBlock*                        target;
+  uint64_t                              elapsed, syncElapsed;
+
+  if ( InRecord->result < 0 && InRecord->op != TRACE_OP_REMOVE && InRecord->op != TRACE_OP_UNLINK &&
+       InRecord->op != TRACE_OP_CLOSE ) {
+    return;
+  }
+  switch ( InRecord->op ) {
+    case TRACE_OP_CREATE : {
+      FileInfoBlockSetBlock(InBlock, InRecord->size);
+      DiskStressWorkerThrottle(InBlock->filesize);
+      elapsed = 0;
+      syncElapsed = 0;
+      if ( FileInfoBlockCreateFile(InBlock, InWorker->volume->directory, InWorker->writeBuffer, &elapsed, &syncElapsed) ) {
+        DiskStressWorkerRecordWrite(InWorker, InBlock->filesize, elapsed);
+        DiskStressWorkerCheckSync(InWorker, syncElapsed);
+      }
+      DiskStressCounterAdd(InWorker->filesCreated, 1);
+      break;
+    }
+    case TRACE_OP_REMOVE : {
+      DiskStressWorkerThrottle(0);
+      FileInfoBlockRemoveFile(InBlock, InWorker->volume->directory);
+      FileInfoBlockClearBlock(InBlock);
+      DiskStressCounterAdd(InWorker->filesRemoved, 1);
+      break;
+    }
+    case TRACE_OP_READ : {
+      if ( InBlock->filesize > 0 ) {
+        DiskStressWorkerReadRange(InWorker, InBlock, InRecord->offset, InRecord->size);
+      }
+      break;
+    }
+    case TRACE_OP_OVERWRITE : {
+      if ( InBlock->filesize > 0 ) {
+        DiskStressWorkerOverwriteRange(InWorker, InBlock, InRecord->offset, InRecord->size);
+      }
+      break;
+    }
+    case TRACE_OP_VERIFY : {
+      if ( InBlock->filesize == 0 ) {
+        break;
+      }
+      if ( diskStressVerify ) {
+        DiskStressWorkerVerifyFile(InWorker, InBlock);
+      } else {
+        DiskStressWorkerReadRange(InWorker, InBlock, 0, InBlock->filesize);
+      }
+      break;
+    }
+    case TRACE_OP_APPEND : {
+      appender = DiskStressWorkerFindAppender(InWorker, InBlock);
+      if ( NULL == appender ) {
+        //! Only a file's first chunk opens it, the block grows to whatever
+        //  the close record says
+        if ( InRecord->offset != 0 || InWorker->appendCount >= diskStressAppendFiles ) {
+          break;
+        }
+        FileInfoBlockSetBlock(InBlock, diskStressMaxFileSize);
+        appender = &(InWorker->appenders[InWorker->appendCount]);
+        if ( !FileInfoBlockAppendOpen(appender, InBlock, InWorker->volume->directory, InWorker->writeBuffer) ) {
+          FileInfoBlockClearBlock(InBlock);
+          break;
+        }
+        InBlock->pending = true;
+        InWorker->appendCount++;
+      }
+      DiskStressWorkerAppendChunk(InWorker, appender, (uint32_t)InRecord->size);
+      break;
+    }
+    case TRACE_OP_CLOSE : {
+      appender = DiskStressWorkerFindAppender(InWorker, InBlock);
+      if ( NULL == appender ) {
+        break;
+      }
+      FileInfoBlockSetFileSize(InBlock, appender->written);
+      DiskStressWorkerFinishAppend(InWorker, appender, InRecord->result == 0 && appender->written > 0);
+      break;
+    }
+    case TRACE_OP_SYNC : {
+      if ( InWorker->directoryFD >= 0 ) {
+        DiskStressWorkerSyncNow(InWorker);
+      }
+      break;
+    }
+    case TRACE_OP_RENAME : {
+      target = FileInfoBlockGetBlock((int64_t)InRecord->offset);
+      if ( target && FileInfoBlockIsOccupied(InBlock) && !FileInfoBlockIsOccupied(target) ) {
+        DiskStressWorkerMetadataApply(InWorker, DISK_STRESS_META_RENAME, InBlock, target, 0);
+      }
+      break;
+    }
+    case TRACE_OP_CREATE_EMPTY :
+    case TRACE_OP_STAT :
+    case TRACE_OP_SETATTR :
+    case TRACE_OP_UNLINK : {
+      DiskStressWorkerMetadataApply(InWorker, (DiskStressMetaOp)(InRecord->op - TRACE_OP_CREATE_EMPTY), InBlock,
+                                    NULL, (mode_t)InRecord->offset);
+      break;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerFindAppender
+ *****************************************************************************/
+static FileInfoBlockAppender*
+DiskStressWorkerFindAppender
+(DiskStressWorker* InWorker, FileInfoBlock* InBlock)
+{
+  int                                   i;
+
+  for ( i = 0 ; i < InWorker->appendCount ; i++ ) {
+    if ( InWorker->appenders[i].block == InBlock ) {
+      return &(InWorker->appenders[i]);
+    }
+  }
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressGetThreadID
+ *****************************************************************************/
+pthread_t
+DiskStressGetThreadID
+()
+{
+  return DiskStressThreadID;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressGenFilename
+ *****************************************************************************/
+string
+DiskStressGenFilename
+()
+{
+  int                                   n;
+  string                                s;
+  
+  DiskStressFilenameIndex++;
+
+  n = strlen(DiskStressFilenameBase) + 16;
+  s = (string)GetMemory(n);
+  sprintf(s, "%s%lld", DiskStressFilenameBase, DiskStressFilenameIndex);
+  return s;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressGetFileCount
+ *****************************************************************************/
+uint64_t
+DiskStressGetFileCount
+()
+{
+  return FileInfoBlockGetCount(diskStressFileHead);
+}
+
+
+/*****************************************************************************!
+ * Function : DiskStressFileList
+ *****************************************************************************/
+void
+DiskStressFileList
+()
+{
+  FileInfoBlockDisplay(diskStressFileHead);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetDirectory
+ *  A comma separated list drives each directory with its own slots and
+ *  workers.  Returns false for an empty name or too many directories.
+ *****************************************************************************/
+bool
+DiskStressThreadSetDirectory
+(string InDirectoryName)
+{
+  DiskStressVolume                      volumes[DISK_STRESS_VOLUMES_MAX];
+  string                                spec;
+  string                                name;
+  string                                end;
+  int                                   i, count;
+
+  spec = StringCopy(InDirectoryName);
+  count = 0;
+  for ( name = spec ; name ; name = end ) {
+    end = strchr(name, ',');
+    if ( end ) {
+      *end++ = 0x00;
+    }
+    if ( *name == 0x00 || count == DISK_STRESS_VOLUMES_MAX ) {
+      for ( i = 0 ; i < count ; i++ ) {
+        FreeMemory(volumes[i].directory);
+      }
+      FreeMemory(spec);
+      return false;
+    }
+    memset(&(volumes[count]), 0x00, sizeof(DiskStressVolume));
+    volumes[count].id        = count;
+    volumes[count].directory = StringCopy(name);
+    if ( !StringEndsWith(name, "/") ) {
+      volumes[count].directory = StringConcatTo(volumes[count].directory, "/");
+    }
+    count++;
+  }
+  FreeMemory(spec);
+
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    FreeMemory(diskStressVolumes[i].directory);
+  }
+  if ( diskStressDirectorySpec ) {
+    FreeMemory(diskStressDirectorySpec);
+  }
+  memcpy(diskStressVolumes, volumes, sizeof(DiskStressVolume) * count);
+  diskStressVolumeCount   = count;
+  diskStressDirectory     = diskStressVolumes[0].directory;
+  diskStressDirectorySpec = StringCopy(InDirectoryName);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetupVolumes
+ *  Every directory gets diskStressWorkerCount workers, fewer if it has
+ *  fewer slots, and diskStressWorkerCount becomes the total
+ *****************************************************************************/
+static void
+DiskStressThreadSetupVolumes
+()
+{
+  DiskStressVolume*                     volume;
+  int                                   i, workers;
+
+  workers = 0;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+    volume->firstWorker = workers;
+    volume->workerCount = diskStressWorkerCount;
+    if ( volume->workerCount > volume->lastIndex - volume->firstIndex ) {
+      volume->workerCount = volume->lastIndex - volume->firstIndex;
+    }
+    workers += volume->workerCount;
+  }
+  diskStressWorkerCount = workers;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressGetFileSize
+ *****************************************************************************/
+uint64_t
+DiskStressGetFileSize
+()
+{
+  return FileInfoBlockGetSize(diskStressFileHead);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadCleanFiles
+ *****************************************************************************/
+void
+DiskStressThreadCleanFiles
+()
+{
+  DIR*                                  dir;
+  struct dirent*            entry;
+  struct stat                           statbuf;
+  int                   i, n;
+  DiskStressVolume*                     volume;
+
+  n = 0;
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    volume = &(diskStressVolumes[i]);
+
+    //! Leftovers from a fanned out run, the directories themselves are kept
+    //  and reused
+    n += FileNamespaceClean(volume->namespace, FileInfoBlockGetPrefix());
+
+    dir = opendir(volume->directory);
+    if ( NULL == dir ) {
+      continue;
+    }
+
+    for ( entry = readdir(dir) ; entry ; entry = readdir(dir) ) {
+      if ( StringEqualsOneOf(entry->d_name, ".", "..", NULL) ) {
+        continue;
+      }
+      //! The fan-out directories are kept, some filesystems leave d_type
+      //  DT_UNKNOWN so those have to be looked at
+      if ( entry->d_type == DT_DIR ) {
+        continue;
+      }
+      if ( entry->d_type == DT_UNKNOWN && fstatat(dirfd(dir), entry->d_name, &statbuf, AT_SYMLINK_NOFOLLOW) == 0 &&
+           S_ISDIR(statbuf.st_mode) ) {
+        continue;
+      }
+      if ( unlinkat(dirfd(dir), entry->d_name, 0) ) {
+        fprintf(stderr, "%sCould remove file %s%s%s : %s%s%s\n", ColorRed, ColorBrightRed, volume->directory, entry->d_name, ColorRed, strerror(errno), ColorReset);
+        exit(EXIT_FAILURE);
+      }
+      n++;
+    }
+    closedir(dir);
+  }
+  if ( n > 1 ) {
+  printf("%sFiles removed            : %s%d%s\n", ColorGreen, ColorYellow, n, ColorReset);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetMaxFiles
+ *****************************************************************************/
+void
+DiskStressThreadSetMaxFiles
+(uint64_t InMaxFiles)
+{
+  if ( InMaxFiles == 0 ) {
+  return;
+  }
+
+  diskStressThreadMaxFiles = InMaxFiles;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetFilesRemovedCount
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetFilesRemovedCount
+()
+{
+  uint64_t                              count;
+  int                                   i;
+
+  count = 0;
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    count += DiskStressCounterGet(diskStressWorkers[i].filesRemoved);
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetFilesCreatedCount 
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetFilesCreatedCount
+()
+{
+  uint64_t                              count;
+  int                                   i;
+
+  count = 0;
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    count += DiskStressCounterGet(diskStressWorkers[i].filesCreated);
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetOverwriteCount
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetOverwriteCount
+()
+{
+  uint64_t                              count;
+  int                                   i;
+
+  count = 0;
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    count += DiskStressCounterGet(diskStressWorkers[i].overwrites);
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetBytesOverwritten
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetBytesOverwritten
+()
+{
+  uint64_t                              count;
+  int                                   i;
+
+  count = 0;
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    count += DiskStressCounterGet(diskStressWorkers[i].bytesOverwritten);
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetOverwriteLatency
+ *  Mean overwrite latency in microseconds
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetOverwriteLatency
+()
+{
+  LatencyHistogram                      overwriteLatency;
+  int                                   i;
+
+  LatencyHistogramInit(&overwriteLatency);
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    LatencyHistogramMerge(&overwriteLatency, &(diskStressWorkers[i].overwriteLatency));
+  }
+  return LatencyHistogramGetMean(&overwriteLatency);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetMaxFileSize
+ *****************************************************************************/
+bool
+DiskStressThreadSetMaxFileSize
+(uint64_t InMaxFileSize)
+{
+  if ( InMaxFileSize == 0 || InMaxFileSize > FILE_INFO_BLOCK_FILESIZE_MAX ) {
+    return false;
+  }
+
+  diskStressMaxFileSize = InMaxFileSize;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetMaxFileSize
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetMaxFileSize
+()
+{
+  return diskStressMaxFileSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetMaxFiles
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetMaxFiles
+()
+{
+  return diskStressThreadMaxFiles;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetStartTime
+ *****************************************************************************/
+time_t
+DiskStressThreadGetStartTime
+()
+{
+  return diskStressThreadStartTime;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetSleepPeriod
+ *****************************************************************************/
+void
+DiskStressThreadSetSleepPeriod
+(int InSleepPeriod)
+{
+  if ( InSleepPeriod < diskStressThreadSleepPeriodMin ) {
+    return;
+  }
+  DiskStressSettingSet(diskStressThreadSleepPeriod, InSleepPeriod);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_SLEEP);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadValidateSleepPeriod
+ *****************************************************************************/
+bool
+DiskStressThreadValidateSleepPeriod
+(int InSleepPeriod)
+{
+  return InSleepPeriod >= diskStressThreadSleepPeriodMin;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetSleepPeriod
+ *****************************************************************************/
+int
+DiskStressThreadGetSleepPeriod
+()
+{
+  return DiskStressSettingGet(diskStressThreadSleepPeriod);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetSleepPeriodMin
+ *****************************************************************************/
+int
+DiskStressThreadGetSleepPeriodMin
+()
+{
+  return diskStressThreadSleepPeriodMin;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadStressInfoToJSON
+ *****************************************************************************/
+JSONOut*
+DiskStressThreadStressInfoToJSON
+()
+{
+  JSONOut*                              object;
+  JSONOut*                              workers;
+  JSONOut*                              targets;
+  DiskStressWorker*                     worker;
+  uint64_t                              diskTotalFileSize, diskCurrentFileSize;
+  int                                   diskUsedPercent;
+  int                                   i, depth, inFlight, cycles, directories;
+  uint64_t                              bytesWritten, writeTime;
+  uint64_t                              lastWriteBytes, lastWriteTime;
+  uint64_t                              filesVerified, verifyErrors;
+  uint64_t                              bytesVerified, verifyTime;
+  uint64_t                              filesRead, bytesRead, readTime;
+  uint64_t                              syncs, ops, now, next, lag, appends;
+  uint64_t                              overwrites, bytesOverwritten;
+  uint64_t                              iterations, idleIterations;
+  LatencyHistogram                      readLatency, syncLatency, responseLatency;
+  LatencyHistogram                      appendLatency, overwriteLatency;
+  DiskStressExtentCounts                extents;
+  char                                  hotSet[16], seed[24];
+  time_t                                elapsed;
+  bool                                  directIO;
+  string                                engineName;
+
+  diskTotalFileSize = FileInfoBlockSetGetSize();
+  diskCurrentFileSize = FileInfoBlockGetCount();
+  diskUsedPercent     = diskTotalFileSize ? (int)(diskCurrentFileSize * 100 / diskTotalFileSize) : 0;
+  elapsed = diskStressThreadStartTime ? time(NULL) - diskStressThreadStartTime : 0;
+
+  //! Cross device interference shows up as one directory slowing down
+  //  while another is busy, so each is broken out
+  cycles = 0;
+  directories = 0;
+  targets = JSONOutCreateArray("targetinfo");
+  for ( i = 0 ; i < diskStressVolumeCount ; i++ ) {
+    cycles += diskStressVolumes[i].cycleCount;
+    directories += diskStressVolumes[i].namespace ? diskStressVolumes[i].namespace->dirCount : 1;
+    JSONOutArrayAddObject(targets, DiskStressVolumeToJSON(&(diskStressVolumes[i]), elapsed));
+  }
+
+  depth = 1;
+  inFlight = 0;
+  bytesWritten = 0;
+  writeTime = 0;
+  lastWriteBytes = 0;
+  lastWriteTime = 0;
+  filesVerified = 0;
+  verifyErrors = 0;
+  bytesVerified = 0;
+  verifyTime = 0;
+  filesRead = 0;
+  bytesRead = 0;
+  readTime = 0;
+  syncs = 0;
+  ops = 0;
+  LatencyHistogramInit(&readLatency);
+  LatencyHistogramInit(&syncLatency);
+  LatencyHistogramInit(&responseLatency);
+  LatencyHistogramInit(&appendLatency);
+  memset(&extents, 0x00, sizeof(DiskStressExtentCounts));
+  LatencyHistogramInit(&overwriteLatency);
+  appends = 0;
+  overwrites = 0;
+  bytesOverwritten = 0;
+  iterations = 0;
+  idleIterations = 0;
+  lag = 0;
+  now = TimeStampGetMicroseconds();
+  directIO = diskStressDirectIO;
+  engineName = "sync";
+  workers = JSONOutCreateArray("workerinfo");
+  for ( i = 0 ; diskStressWorkers && i < diskStressWorkerCount ; i++ ) {
+    worker = &(diskStressWorkers[i]);
+    bytesWritten += DiskStressCounterGet(worker->bytesWritten);
+    writeTime    += DiskStressCounterGet(worker->writeTime);
+    lastWriteBytes += DiskStressCounterGet(worker->lastWriteBytes);
+    lastWriteTime  += DiskStressCounterGet(worker->lastWriteTime);
+    filesVerified += DiskStressCounterGet(worker->filesVerified);
+    verifyErrors  += DiskStressCounterGet(worker->verifyErrors);
+    bytesVerified += DiskStressCounterGet(worker->bytesVerified);
+    verifyTime    += DiskStressCounterGet(worker->verifyTime);
+    filesRead     += DiskStressCounterGet(worker->filesRead);
+    bytesRead     += DiskStressCounterGet(worker->bytesRead);
+    readTime      += DiskStressCounterGet(worker->readTime);
+    syncs         += DiskStressCounterGet(worker->syncs);
+    appends       += DiskStressCounterGet(worker->appends);
+    overwrites    += DiskStressCounterGet(worker->overwrites);
+    bytesOverwritten += DiskStressCounterGet(worker->bytesOverwritten);
+    iterations    += DiskStressCounterGet(worker->iterations);
+    idleIterations += DiskStressCounterGet(worker->idleIterations);
+    ops           += DiskStressCounterGet(worker->filesCreated) + DiskStressCounterGet(worker->filesRemoved) +
+                     DiskStressCounterGet(worker->filesRead) + DiskStressCounterGet(worker->appends) +
+                     DiskStressCounterGet(worker->overwrites) +
+                     DiskStressCounterGet(worker->metaOps[DISK_STRESS_META_STAT]) +
+                     DiskStressCounterGet(worker->metaOps[DISK_STRESS_META_RENAME]) +
+                     DiskStressCounterGet(worker->metaOps[DISK_STRESS_META_SETATTR]);
+    LatencyHistogramMerge(&readLatency, &(worker->readLatency));
+    LatencyHistogramMerge(&syncLatency, &(worker->syncLatency));
+    LatencyHistogramMerge(&responseLatency, &(worker->responseLatency));
+    LatencyHistogramMerge(&appendLatency, &(worker->appendLatency));
+    DiskStressExtentCountsMerge(&extents, &(worker->extents));
+    LatencyHistogramMerge(&overwriteLatency, &(worker->overwriteLatency));
+    next = ArrivalScheduleGetNext(&(worker->arrival));
+    if ( next && now > next && now - next > lag ) {
+      lag = now - next;
+    }
+    directIO      = worker->writeBuffer->directIO;
+    if ( worker->engine ) {
+      engineName = "io_uring";
+      depth     = worker->engine->depth;
+      inFlight += worker->engine->inFlight;
+    }
+    JSONOutArrayAddObject(workers, DiskStressWorkerToJSON(worker));
+  }
+  sprintf(hotSet, "%d:%d", DiskStressSettingGet(diskStressHotSetPercent), DiskStressSettingGet(diskStressHotSetSize));
+  sprintf(seed, "%llu", (unsigned long long)diskStressSeed);
+
+  object = JSONOutCreateObject("stressinfo");
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateInt("highpercent", DiskStressSettingGet(diskStressHighUsagePercent)),
+                          JSONOutCreateInt("lowpercent",  DiskStressSettingGet(diskStressLowUsagePercent)),
+                          JSONOutCreateInt("currentpercent", diskUsedPercent),
+                          JSONOutCreateInt("sleepperiod", DiskStressSettingGet(diskStressThreadSleepPeriod)),
+                          JSONOutCreateInt("cycle", cycles),
+                          JSONOutCreateString("process", diskStressVolumes[0].trend == DISK_STRESS_TREND_DECREASE ? "Removing" : "Creation"),
+                          JSONOutCreateInt("blocksize", diskStressWriteBlockSize),
+                          JSONOutCreateString("engine", engineName),
+                          JSONOutCreateInt("iodepth", depth),
+                          JSONOutCreateInt("inflight", inFlight),
+                          JSONOutCreateBool("directio", directIO),
+                          JSONOutCreateInt("workers", diskStressWorkerCount),
+                          JSONOutCreateString("seed", seed),
+                          JSONOutCreateLongLong("byteswritten", bytesWritten),
+                          JSONOutCreateFloat("lastwriterate", TimeStampComputeRate(lastWriteBytes, lastWriteTime)),
+                          JSONOutCreateFloat("writerate", TimeStampComputeRate(bytesWritten, writeTime)),
+                          JSONOutCreateFloat("throughput", TimeStampComputeRate(bytesWritten, (uint64_t)elapsed * 1000000)),
+                          JSONOutCreateBool("verify", diskStressVerify),
+                          JSONOutCreateLongLong("verified", filesVerified),
+                          JSONOutCreateLongLong("verifyerrors", verifyErrors),
+                          JSONOutCreateLongLong("bytesverified", bytesVerified),
+                          JSONOutCreateFloat("verifyrate", TimeStampComputeRate(bytesVerified, verifyTime)),
+                          JSONOutCreateInt("readpercent", DiskStressSettingGet(diskStressReadPercent)),
+                          JSONOutCreateLongLong("readsize", diskStressReadSize),
+                          JSONOutCreateLongLong("read", filesRead),
+                          JSONOutCreateLongLong("bytesread", bytesRead),
+                          JSONOutCreateFloat("readrate", TimeStampComputeRate(bytesRead, readTime)),
+                          LatencyHistogramToJSON("readlatency", &readLatency),
+                          JSONOutCreateString("sync", DiskStressThreadGetSyncPolicy()),
+                          JSONOutCreateLongLong("syncs", syncs),
+                          LatencyHistogramToJSON("synclatency", &syncLatency),
+                          JSONOutCreateInt("targetmbps", DiskStressSettingGet(diskStressRateMBps)),
+                          JSONOutCreateInt("targetiops", DiskStressSettingGet(diskStressRateIOPS)),
+                          JSONOutCreateFloat("achievedmbps", TimeStampComputeRate(bytesWritten + bytesRead, (uint64_t)elapsed * 1000000)),
+                          JSONOutCreateFloat("achievediops", elapsed ? (double)ops / elapsed : 0.0),
+                          JSONOutCreateLongLong("iterations", iterations),
+                          JSONOutCreateLongLong("idleiterations", idleIterations),
+                          JSONOutCreateFloat("effectivepercent", iterations ? (double)(iterations - idleIterations) * 100 / iterations : 0.0),
+                          JSONOutCreateString("arrival", DiskStressThreadGetArrival()),
+                          JSONOutCreateLongLong("schedulelag", lag),
+                          LatencyHistogramToJSON("responselatency", &responseLatency),
+                          JSONOutCreateInt("append", diskStressAppendChunk),
+                          JSONOutCreateInt("appendfiles", diskStressAppendFiles),
+                          JSONOutCreateLongLong("appends", appends),
+                          LatencyHistogramToJSON("appendlatency", &appendLatency),
+                          DiskStressExtentCountsToJSON("extents", &extents),
+                          JSONOutCreateInt("overwritepercent", DiskStressSettingGet(diskStressOverwritePercent)),
+                          JSONOutCreateInt("overwritesize", DiskStressSettingGet(diskStressOverwriteSize)),
+                          JSONOutCreateString("hotset", hotSet),
+                          JSONOutCreateString("fanout", DiskStressThreadGetFanout()),
+                          JSONOutCreateInt("directories", directories),
+                          JSONOutCreateLongLong("slotsetreserved", FileInfoBlockSetGetMemory()),
+                          JSONOutCreateLongLong("slotsetresident", FileInfoBlockSetGetResident()),
+                          JSONOutCreateBool("hugepages", SlotMemoryGetHugePages()),
+                          JSONOutCreateLongLong("overwrites", overwrites),
+                          JSONOutCreateLongLong("bytesoverwritten", bytesOverwritten),
+                          LatencyHistogramToJSON("overwritelatency", &overwriteLatency),
+                          targets,
+                          workers,
+                          NULL);
+  if ( diskStressSizeDistribution ) {
+    JSONOutObjectAddObject(object, FileSizeDistributionToJSON("sizedistribution", diskStressSizeDistribution));
+  }
+  if ( diskStressTarget ) {
+    JSONOutObjectAddObject(object, BlockTargetToJSON("target", diskStressTarget));
+  }
+  if ( diskStressMetadata ) {
+    JSONOutObjectAddObject(object, DiskStressThreadMetadataToJSON(elapsed));
+  }
+  if ( diskStressTrace ) {
+    JSONOutObjectAddObject(object, TraceToJSON("trace", diskStressTrace));
+  }
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadMetadataToJSON
+ *  Count, rate over the run and latency of each metadata operation, and the
+ *  inodes in use on the file system
+ *****************************************************************************/
+static JSONOut*
+DiskStressThreadMetadataToJSON
+(time_t InElapsed)
+{
+  JSONOut*                              object;
+  JSONOut*                              opObject;
+  DiskStressWorker*                     worker;
+  LatencyHistogram                      latency;
+  uint64_t                              ops, errors;
+  int                                   i, op;
+
+  errors = 0;
+  for ( i = 0 ; i < diskStressWorkerCount ; i++ ) {
+    errors += DiskStressCounterGet(diskStressWorkers[i].metaErrors);
+  }
+  object = JSONOutCreateObject("metadata");
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("mix", DiskStressThreadGetMetadata()),
+                          JSONOutCreateLongLong("errors", errors),
+                          JSONOutCreateLongLong("inodesused", DiskInformationGetUsedInodes()),
+                          JSONOutCreateLongLong("inodesstart", diskStressInodesStart),
+                          JSONOutCreateLongLong("inodespeak", diskStressInodesPeak),
+                          NULL);
+  for ( op = 0 ; op < DISK_STRESS_META_COUNT ; op++ ) {
+    ops = 0;
+    LatencyHistogramInit(&latency);
+    for ( i = 0 ; i < diskStressWorkerCount ; i++ ) {
+      worker = &(diskStressWorkers[i]);
+      ops += DiskStressCounterGet(worker->metaOps[op]);
+      LatencyHistogramMerge(&latency, &(worker->metaLatency[op]));
+    }
+    opObject = JSONOutCreateObject(diskStressMetaOpNames[op]);
+    JSONOutObjectAddObjects(opObject,
+                            JSONOutCreateLongLong("ops", ops),
+                            JSONOutCreateFloat("rate", InElapsed ? (double)ops / InElapsed : 0.0),
+                            LatencyHistogramToJSON("latency", &latency),
+                            NULL);
+    JSONOutObjectAddObject(object, opObject);
+  }
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadConfigToJSON
+ *  The settings the run was started with, whether they came from the
+ *  command line or a job file.  runtime holds the settings a phase can
+ *  change as they were at the start.
+ *****************************************************************************/
+JSONOut*
+DiskStressThreadConfigToJSON
+()
+{
+  JSONOut*                              object;
+  JSONOut*                              phases;
+  DiskStressPhase                       runtime;
+  char                                  seed[24], sizes[32];
+  string                                sizeSpec;
+  int                                   i;
+
+  sprintf(seed, "%llu", (unsigned long long)diskStressSeed);
+  sizeSpec = diskStressSizeDistribution ? diskStressSizeDistribution->spec : NULL;
+  if ( NULL == sizeSpec ) {
+    sprintf(sizes, "fixed:%llu", (unsigned long long)diskStressMaxFileSize);
+    sizeSpec = sizes;
+  }
+  if ( diskStressPhaseCount ) {
+    runtime = diskStressPhases[0];
+  } else {
+    DiskStressThreadSaveSettings(&runtime);
+  }
+
+  phases = JSONOutCreateArray("phases");
+  for ( i = 0 ; i < diskStressPhaseCount ; i++ ) {
+    JSONOutArrayAddObject(phases, DiskStressPhaseToJSON(NULL, &(diskStressPhases[i])));
+  }
+
+  object = JSONOutCreateObject("config");
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("job", diskStressJobFile ? diskStressJobFile : ""),
+                          JSONOutCreateString("directory", diskStressDirectorySpec),
+                          JSONOutCreateString("target", diskStressTargetPath ? diskStressTargetPath : ""),
+                          JSONOutCreateString("release", BlockTargetGetReleaseName(diskStressTargetRelease)),
+                          JSONOutCreateString("engine", diskStressEngine == DISK_STRESS_ENGINE_IOURING ? "io_uring" : "sync"),
+                          JSONOutCreateInt("iodepth", diskStressIODepth),
+                          JSONOutCreateInt("workers", diskStressWorkerCount),
+                          JSONOutCreateString("seed", seed),
+                          JSONOutCreateLongLong("maxfiles", diskStressThreadMaxFiles),
+                          JSONOutCreateLongLong("maxfilesize", diskStressMaxFileSize),
+                          JSONOutCreateString("sizedist", sizeSpec),
+                          JSONOutCreateInt("blocksize", diskStressWriteBlockSize),
+                          JSONOutCreateBool("direct", diskStressDirectIO),
+                          JSONOutCreateBool("verify", diskStressVerify),
+                          JSONOutCreateLongLong("readsize", diskStressReadSize),
+                          JSONOutCreateString("sync", DiskStressThreadGetSyncPolicy()),
+                          JSONOutCreateString("arrival", DiskStressThreadGetArrival()),
+                          JSONOutCreateInt("append", diskStressAppendChunk),
+                          JSONOutCreateInt("appendfiles", diskStressAppendFiles),
+                          JSONOutCreateString("fanout", DiskStressThreadGetFanout()),
+                          JSONOutCreateString("metadata", DiskStressThreadGetMetadata()),
+                          JSONOutCreateInt("duration", diskStressDuration),
+                          JSONOutCreateString("trace", diskStressTracePath ? diskStressTracePath : ""),
+                          JSONOutCreateString("replay", diskStressReplayPath ? diskStressReplayPath : ""),
+                          JSONOutCreateBool("replayfast", diskStressReplayFast),
+                          DiskStressPhaseToJSON("runtime", &runtime),
+                          phases,
+                          NULL);
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressPhaseToJSON
+ *****************************************************************************/
+static JSONOut*
+DiskStressPhaseToJSON
+(string InName, DiskStressPhase* InPhase)
+{
+  JSONOut*                              object;
+  char                                  hotSet[16];
+
+  sprintf(hotSet, "%d:%d", InPhase->hotSetPercent, InPhase->hotSetSize);
+  object = JSONOutCreateObject(InName);
+  if ( InPhase->name ) {
+    JSONOutObjectAddObjects(object,
+                            JSONOutCreateString("name", InPhase->name),
+                            JSONOutCreateInt("duration", InPhase->duration),
+                            NULL);
+  }
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateInt("readpercent", InPhase->readPercent),
+                          JSONOutCreateInt("overwritepercent", InPhase->overwritePercent),
+                          JSONOutCreateInt("overwritesize", InPhase->overwriteSize),
+                          JSONOutCreateString("hotset", hotSet),
+                          JSONOutCreateInt("highpercent", InPhase->highPercent),
+                          JSONOutCreateInt("lowpercent", InPhase->lowPercent),
+                          JSONOutCreateInt("sleepperiod", InPhase->sleepPeriod),
+                          JSONOutCreateInt("targetmbps", InPhase->rateMBps),
+                          JSONOutCreateInt("targetiops", InPhase->rateIOPS),
+                          NULL);
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressWorkerToJSON
+ *****************************************************************************/
+static JSONOut*
+DiskStressWorkerToJSON
+(DiskStressWorker* InWorker)
+{
+  JSONOut*                              object;
+
+  object = JSONOutCreateObject(NULL);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateInt("worker", InWorker->id),
+                          JSONOutCreateInt("target", InWorker->volume->id),
+                          JSONOutCreateLongLong("firstslot", InWorker->firstIndex),
+                          JSONOutCreateLongLong("lastslot", InWorker->lastIndex - 1),
+                          JSONOutCreateLongLong("created", DiskStressCounterGet(InWorker->filesCreated)),
+                          JSONOutCreateLongLong("removed", DiskStressCounterGet(InWorker->filesRemoved)),
+                          JSONOutCreateLongLong("byteswritten", DiskStressCounterGet(InWorker->bytesWritten)),
+                          JSONOutCreateLongLong("verified", DiskStressCounterGet(InWorker->filesVerified)),
+                          JSONOutCreateLongLong("verifyerrors", DiskStressCounterGet(InWorker->verifyErrors)),
+                          JSONOutCreateLongLong("read", DiskStressCounterGet(InWorker->filesRead)),
+                          JSONOutCreateLongLong("bytesread", DiskStressCounterGet(InWorker->bytesRead)),
+                          JSONOutCreateLongLong("appends", DiskStressCounterGet(InWorker->appends)),
+                          JSONOutCreateLongLong("overwritten", DiskStressCounterGet(InWorker->overwrites)),
+                          JSONOutCreateLongLong("iterations", DiskStressCounterGet(InWorker->iterations)),
+                          JSONOutCreateLongLong("idleiterations", DiskStressCounterGet(InWorker->idleIterations)),
+                          NULL);
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressVolumeToJSON
+ *****************************************************************************/
+static JSONOut*
+DiskStressVolumeToJSON
+(DiskStressVolume* InVolume, time_t InElapsed)
+{
+  JSONOut*                              object;
+  DiskStressWorker*                     worker;
+  uint64_t                              created, removed, bytesWritten, bytesRead;
+  uint64_t                              writeTime, readTime, syncs, overwrites, verifyErrors;
+  uint64_t                              files;
+  int                                   i, percent;
+
+  created = removed = bytesWritten = bytesRead = 0;
+  writeTime = readTime = syncs = overwrites = verifyErrors = 0;
+  for ( i = 0 ; diskStressWorkers && i < InVolume->workerCount ; i++ ) {
+    worker = &(diskStressWorkers[InVolume->firstWorker + i]);
+    created      += DiskStressCounterGet(worker->filesCreated);
+    removed      += DiskStressCounterGet(worker->filesRemoved);
+    bytesWritten += DiskStressCounterGet(worker->bytesWritten);
+    writeTime    += DiskStressCounterGet(worker->writeTime);
+    bytesRead    += DiskStressCounterGet(worker->bytesRead);
+    readTime     += DiskStressCounterGet(worker->readTime);
+    syncs        += DiskStressCounterGet(worker->syncs);
+    overwrites   += DiskStressCounterGet(worker->overwrites);
+    verifyErrors += DiskStressCounterGet(worker->verifyErrors);
+  }
+  files = diskStressWorkers ? FileInfoBlockGetRangeCount(InVolume->firstIndex, InVolume->lastIndex) : 0;
+  percent = InVolume->lastIndex > InVolume->firstIndex ? (int)(files * 100ULL / (InVolume->lastIndex - InVolume->firstIndex)) : 0;
+
+  object = JSONOutCreateObject(NULL);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateInt("target", InVolume->id),
+                          JSONOutCreateString("directory", InVolume->directory),
+                          JSONOutCreateLongLong("firstslot", InVolume->firstIndex),
+                          JSONOutCreateLongLong("lastslot", InVolume->lastIndex - 1),
+                          JSONOutCreateLongLong("maxfiles", InVolume->lastIndex - InVolume->firstIndex),
+                          JSONOutCreateLongLong("files", files),
+                          JSONOutCreateInt("currentpercent", percent),
+                          JSONOutCreateString("process", InVolume->trend == DISK_STRESS_TREND_DECREASE ? "Removing" : "Creation"),
+                          JSONOutCreateInt("cycle", InVolume->cycleCount),
+                          JSONOutCreateInt("workers", InVolume->workerCount),
+                          JSONOutCreateLongLong("created", created),
+                          JSONOutCreateLongLong("removed", removed),
+                          JSONOutCreateLongLong("byteswritten", bytesWritten),
+                          JSONOutCreateFloat("writerate", TimeStampComputeRate(bytesWritten, writeTime)),
+                          JSONOutCreateFloat("throughput", TimeStampComputeRate(bytesWritten + bytesRead, (uint64_t)InElapsed * 1000000)),
+                          JSONOutCreateLongLong("bytesread", bytesRead),
+                          JSONOutCreateFloat("readrate", TimeStampComputeRate(bytesRead, readTime)),
+                          JSONOutCreateLongLong("syncs", syncs),
+                          JSONOutCreateLongLong("overwrites", overwrites),
+                          JSONOutCreateLongLong("verifyerrors", verifyErrors),
+                          JSONOutCreateLongLong("inodesstart", InVolume->inodesStart),
+                          JSONOutCreateLongLong("inodespeak", InVolume->inodesPeak),
+                          DiskInformationInstanceToJSON("diskinfo", &(InVolume->info)),
+                          NULL);
+  return object;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetHighPercent 
+ *****************************************************************************/
+int
+DiskStressThreadGetHighPercent
+()
+{
+  return DiskStressSettingGet(diskStressHighUsagePercent);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetLowPercent
+ *****************************************************************************/
+int
+DiskStressThreadGetLowPercent
+()
+{
+  return DiskStressSettingGet(diskStressLowUsagePercent);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetLowPercent
+ *****************************************************************************/
+void
+DiskStressThreadSetLowPercent
+(int InLowPercent)
+{
+  if ( InLowPercent > 0 && InLowPercent <= 100 ) {
+    DiskStressSettingSet(diskStressLowUsagePercent, InLowPercent);
+    DiskStressThreadNoteOverride(DISK_STRESS_SETTING_LOW);
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetHighPercent
+ *****************************************************************************/
+void
+DiskStressThreadSetHighPercent
+(int InHighPercent)
+{
+  if ( InHighPercent > 0 && InHighPercent <= 100 ) {
+    DiskStressSettingSet(diskStressHighUsagePercent, InHighPercent);
+    DiskStressThreadNoteOverride(DISK_STRESS_SETTING_HIGH);
+  }
+}
+
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetWriteBlockSize
+ *****************************************************************************/
+void
+DiskStressThreadSetWriteBlockSize
+(uint32_t InBlockSize)
+{
+  if ( !DiskStressThreadValidateWriteBlockSize(InBlockSize) ) {
+    return;
+  }
+  diskStressWriteBlockSize = InBlockSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadValidateWriteBlockSize
+ *****************************************************************************/
+bool
+DiskStressThreadValidateWriteBlockSize
+(uint32_t InBlockSize)
+{
+  return InBlockSize >= diskStressWriteBlockSizeMin && InBlockSize <= diskStressWriteBlockSizeMax;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetWriteBlockSize
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetWriteBlockSize
+()
+{
+  return diskStressWriteBlockSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetWriteBlockSizeMin
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetWriteBlockSizeMin
+()
+{
+  return diskStressWriteBlockSizeMin;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetWriteBlockSizeMax
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetWriteBlockSizeMax
+()
+{
+  return diskStressWriteBlockSizeMax;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetDirectIO
+ *****************************************************************************/
+void
+DiskStressThreadSetDirectIO
+(bool InDirectIO)
+{
+  diskStressDirectIO = InDirectIO;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetDirectIO
+ *****************************************************************************/
+bool
+DiskStressThreadGetDirectIO
+()
+{
+  return diskStressDirectIO;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetVerify
+ *****************************************************************************/
+void
+DiskStressThreadSetVerify
+(bool InVerify)
+{
+  diskStressVerify = InVerify;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetVerify
+ *****************************************************************************/
+bool
+DiskStressThreadGetVerify
+()
+{
+  return diskStressVerify;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetReadPercent
+ *****************************************************************************/
+void
+DiskStressThreadSetReadPercent
+(int InReadPercent)
+{
+  if ( !DiskStressThreadValidateReadPercent(InReadPercent) ) {
+    return;
+  }
+  DiskStressSettingSet(diskStressReadPercent, InReadPercent);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_READ);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadValidateReadPercent
+ *****************************************************************************/
+bool
+DiskStressThreadValidateReadPercent
+(int InReadPercent)
+{
+  return InReadPercent >= 0 && InReadPercent <= 100;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetReadPercent
+ *****************************************************************************/
+int
+DiskStressThreadGetReadPercent
+()
+{
+  return DiskStressSettingGet(diskStressReadPercent);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetReadSize
+ *  Zero reads whole files
+ *****************************************************************************/
+void
+DiskStressThreadSetReadSize
+(uint64_t InReadSize)
+{
+  diskStressReadSize = InReadSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetReadSize
+ *****************************************************************************/
+uint64_t
+DiskStressThreadGetReadSize
+()
+{
+  return diskStressReadSize;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetSyncPolicy
+ *  none, fsync, fdatasync, osync, odsync, everyn:<files> or everyms:<ms>
+ *****************************************************************************/
+bool
+DiskStressThreadSetSyncPolicy
+(string InPolicy)
+{
+  FileInfoBlockSync                     sync;
+  uint32_t                              everyFiles, everyMS;
+  long                                  n;
+  char*                                 end;
+
+  sync = FILE_INFO_BLOCK_SYNC_NONE;
+  everyFiles = 0;
+  everyMS = 0;
+  if ( StringEqual(InPolicy, "fsync") ) {
+    sync = FILE_INFO_BLOCK_SYNC_FSYNC;
+  } else if ( StringEqual(InPolicy, "fdatasync") ) {
+    sync = FILE_INFO_BLOCK_SYNC_FDATASYNC;
+  } else if ( StringEqual(InPolicy, "osync") ) {
+    sync = FILE_INFO_BLOCK_SYNC_OSYNC;
+  } else if ( StringEqual(InPolicy, "odsync") ) {
+    sync = FILE_INFO_BLOCK_SYNC_ODSYNC;
+  } else if ( strncmp(InPolicy, "everyn:", 7) == 0 || strncmp(InPolicy, "everyms:", 8) == 0 ) {
+    n = strtol(strchr(InPolicy, ':') + 1, &end, 10);
+    if ( *end || n <= 0 ) {
+      return false;
+    }
+    if ( InPolicy[5] == 'n' ) {
+      everyFiles = (uint32_t)n;
+    } else {
+      everyMS = (uint32_t)n;
+    }
+  } else if ( !StringEqual(InPolicy, "none") ) {
+    return false;
+  }
+
+  diskStressSync           = sync;
+  diskStressSyncEveryFiles = everyFiles;
+  diskStressSyncEveryMS    = everyMS;
+  if ( diskStressSyncPolicy ) {
+    FreeMemory(diskStressSyncPolicy);
+  }
+  diskStressSyncPolicy = StringCopy(InPolicy);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetSyncPolicy
+ *****************************************************************************/
+string
+DiskStressThreadGetSyncPolicy
+()
+{
+  return diskStressSyncPolicy ? diskStressSyncPolicy : "none";
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetSizeDistribution
+ *****************************************************************************/
+bool
+DiskStressThreadSetSizeDistribution
+(string InSpec)
+{
+  FileSizeDistribution*                 distribution;
+
+  distribution = FileSizeDistributionCreate(InSpec);
+  if ( NULL == distribution ) {
+    return false;
+  }
+  if ( FileSizeDistributionGetMax(distribution) > FILE_INFO_BLOCK_FILESIZE_MAX ) {
+    FileSizeDistributionDestroy(distribution);
+    return false;
+  }
+  FileSizeDistributionDestroy(diskStressSizeDistribution);
+  diskStressSizeDistribution = distribution;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetRateMBps
+ *  A rate limit replaces the fixed sleep between operations
+ *****************************************************************************/
+void
+DiskStressThreadSetRateMBps
+(uint32_t InRateMBps)
+{
+  DiskStressSettingSet(diskStressRateMBps, InRateMBps);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_RATEMBPS);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetRateMBps
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetRateMBps
+()
+{
+  return DiskStressSettingGet(diskStressRateMBps);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetRateIOPS
+ *****************************************************************************/
+void
+DiskStressThreadSetRateIOPS
+(uint32_t InRateIOPS)
+{
+  DiskStressSettingSet(diskStressRateIOPS, InRateIOPS);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_RATEIOPS);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetRateIOPS
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetRateIOPS
+()
+{
+  return DiskStressSettingGet(diskStressRateIOPS);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetArrival
+ *  poisson:<rate> or fixed:<rate>, the rate is split evenly over the workers
+ *****************************************************************************/
+bool
+DiskStressThreadSetArrival
+(string InSpec)
+{
+  ArrivalScheduleType                   type;
+  double                                rate;
+
+  if ( !ArrivalScheduleParse(InSpec, &type, &rate) ) {
+    return false;
+  }
+  diskStressArrivalType = type;
+  diskStressArrivalRate = rate;
+  if ( diskStressArrivalSpec ) {
+    FreeMemory(diskStressArrivalSpec);
+  }
+  diskStressArrivalSpec = StringCopy(InSpec);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetArrival
+ *****************************************************************************/
+string
+DiskStressThreadGetArrival
+()
+{
+  return diskStressArrivalSpec ? diskStressArrivalSpec : "closed";
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetDirectoryAlignment
+ *  The file system block size is a multiple of the device logical block size
+ *  so it is safe to use for O_DIRECT buffers and transfer sizes
+ *****************************************************************************/
+static uint32_t
+DiskStressThreadGetDirectoryAlignment
+(string InDirectory)
+{
+  struct statvfs                        vbuf;
+  uint32_t                              alignment;
+
+  if ( statvfs(InDirectory, &vbuf) ) {
+    return FILE_INFO_BLOCK_DEFAULT_ALIGNMENT;
+  }
+  alignment = (uint32_t)vbuf.f_bsize;
+  if ( alignment < 512 || (alignment & (alignment - 1)) ) {
+    return FILE_INFO_BLOCK_DEFAULT_ALIGNMENT;
+  }
+  return alignment;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadOpenTarget
+ *  Every slot gets an extent big enough for the largest file, so the target
+ *  can cut the slot count down.  The io_uring chains open and unlink real
+ *  files, block targets always use the synchronous engine.
+ *****************************************************************************/
+static void
+DiskStressThreadOpenTarget
+()
+{
+  int                                   flags;
+
+  flags = 0;
+  if ( diskStressSync == FILE_INFO_BLOCK_SYNC_OSYNC ) {
+    flags = O_SYNC;
+  } else if ( diskStressSync == FILE_INFO_BLOCK_SYNC_ODSYNC ) {
+    flags = O_DSYNC;
+  }
+  diskStressTarget = BlockTargetOpen(diskStressTargetPath, diskStressMaxFileSize, diskStressThreadMaxFiles,
+                                     diskStressDirectIO, flags, diskStressTargetRelease, diskStressTargetCreate);
+  if ( NULL == diskStressTarget ) {
+    fprintf(stderr, "%sCould not open the block target %s%s\n", ColorRed, diskStressTargetPath, ColorReset);
+    exit(EXIT_FAILURE);
+  }
+  diskStressThreadMaxFiles       = diskStressTarget->extentCount;
+  diskStressThreadAvailableBytes = diskStressTarget->size;
+  diskStressDirectIO             = diskStressTarget->directIO;
+  if ( diskStressEngine == DISK_STRESS_ENGINE_IOURING ) {
+    LogAppend("Block Target            : io_uring does not drive block targets, using sync");
+    diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+  }
+  FileInfoBlockSetTarget(diskStressTarget);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetTarget
+ *  A block device or image file to use instead of files in the directory,
+ *  InCreate names an image file that is created if it does not exist
+ *****************************************************************************/
+void
+DiskStressThreadSetTarget
+(string InPath, bool InCreate)
+{
+  if ( diskStressTargetPath ) {
+    FreeMemory(diskStressTargetPath);
+  }
+  diskStressTargetPath   = StringCopy(InPath);
+  diskStressTargetCreate = InCreate;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetTarget
+ *****************************************************************************/
+string
+DiskStressThreadGetTarget
+()
+{
+  return diskStressTargetPath;
+}
+
 /*****************************************************************************!
- * Function : DiskStressThreadInit
+ * Function : DiskStressThreadSetTargetRelease
+ *****************************************************************************/
+bool
+DiskStressThreadSetTargetRelease
+(string InName)
+{
+  return BlockTargetParseRelease(InName, &diskStressTargetRelease);
+}
 
+/*****************************************************************************!
+ * Function : DiskStressThreadSetAppendChunk
  *****************************************************************************/
 void
-DiskStressThreadInit
-()
+DiskStressThreadSetAppendChunk
+(uint32_t InAppendChunk)
 {
-  diskStressHighUsagePercent = diskStressHighUsagePercentDefault;
-  diskStressLowUsagePercent  = diskStressLowUsagePercentDefault;
-  diskStressFileHead = NULL;
-  diskStressTrend = DISK_STRESS_TREND_NONE;
-  diskStressDirectory = StringCopy(diskStressDirectoryDefault);
+  diskStressAppendChunk = InAppendChunk;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadStart
+ * Function : DiskStressThreadGetAppendChunk
  *****************************************************************************/
-void
-DiskStressThreadStart
+uint32_t
+DiskStressThreadGetAppendChunk
 ()
 {
-  DiskStressThreadCleanFiles();
-  DiskInformationInitialize();
-
-  if ( pthread_create(&DiskStressThreadID, NULL, DiskStressThread, NULL) ) {
-    fprintf(stderr, "%sCould not start \"DiskStress Thread\"%s\n", ColorRed, ColorReset);
-    exit(EXIT_FAILURE);
-  }
+  return diskStressAppendChunk;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThread
+ * Function : DiskStressThreadSetAppendFiles
  *****************************************************************************/
-void*
-DiskStressThread
-(void* InParameters)
+void
+DiskStressThreadSetAppendFiles
+(int InAppendFiles)
 {
-  long long                             filesize;
-  FileInfoBlock*                        infoBlock;
-  int                                   index;
-  int                                   diskTotalFileSize;
-  int                                   diskCurrentFileSize;
-  int                                   diskUsedPercent;
-
-  diskStressThreadAvailableBytes = DiskInformationGetAvailableBytes();
-
-  // If the user has not already set the maximum number of files, set it now
-  if ( diskStressThreadMaxFiles == 0 ) {
-    diskStressThreadMaxFiles = diskStressThreadAvailableBytes / diskStressMaxFileSize;
-    diskStressThreadMaxFiles++;
-  }
-  FileInfoBlockSetCreate(diskStressThreadMaxFiles);
-  LogAppend("Disk Stress Thread      : started");
-  LogAppend("  Files Directory       : %s", diskStressDirectory);
-  LogAppend("  Available Bytes       : %lld", diskStressThreadAvailableBytes);
-  LogAppend("  Max Files             : %lld", diskStressThreadMaxFiles);
-  LogAppend("  Max File Size         : %lld", diskStressMaxFileSize);
-
-  printf("%sDisk Stress Thread       :%s started%s\n"
-       "  %sFiles Directory        : %s%s%s\n"
-     "  %sAvailable Bytes        : %s%llu%s\n" 
-     "  %sMax Files              : %s%llu%s\n"
-     "  %sMax File Size          : %s%llu%s\n",
-
-     ColorGreen, ColorYellow, ColorReset, 
-     ColorCyan, ColorYellow, diskStressDirectory, ColorReset,
-     ColorCyan, ColorYellow, diskStressThreadAvailableBytes, ColorReset,
-     ColorCyan, ColorYellow, diskStressThreadMaxFiles, ColorReset,
-     ColorCyan, ColorYellow, diskStressMaxFileSize, ColorReset);
-  UserInputServerThreadStart();
-
-  filesize = diskStressMaxFileSize;
-  diskStressThreadStartTime = time(NULL);
-  diskStressTrend = DISK_STRESS_TREND_INCREASE;
-  diskTotalFileSize = FileInfoBlockSetGetSize();
-  while ( true ) {
-    diskCurrentFileSize = FileInfoBlockGetCount();
-    diskUsedPercent     = (int)(diskCurrentFileSize * 100 / diskTotalFileSize);
-    if ( diskStressTrend == DISK_STRESS_TREND_INCREASE ) {
-      if ( diskUsedPercent >= diskStressHighUsagePercent ) {
-        diskStressTrend = DISK_STRESS_TREND_DECREASE;
-      }
-    } else {
-      if ( diskUsedPercent <= diskStressLowUsagePercent ) {
-        diskStressTrend = DISK_STRESS_TREND_INCREASE;
-        diskStressCycleCount++;
-      }
-    }
-  index = rand();
-  index %= diskStressThreadMaxFiles;
-  infoBlock = FileInfoBlockGetBlock(index);
-
-  if ( infoBlock ) {
-    if ( infoBlock->filesize == 0 && diskStressTrend == DISK_STRESS_TREND_INCREASE ) {
-    FileInfoBlockSetBlock(infoBlock, filesize);
-    FileInfoBlockCreateFile(infoBlock, diskStressDirectory);
-    diskStressThreadFilesCreatedCount++;
-    } else if ( diskStressTrend == DISK_STRESS_TREND_DECREASE ) {
-    FileInfoBlockRemoveFile(infoBlock, diskStressDirectory);
-    FileInfoBlockClearBlock(infoBlock);
-    diskStressThreadFilesRemovedCount++;
-    }
-  }
-    usleep(diskStressThreadSleepPeriod);
-    DiskInformationRefresh();
+  if ( InAppendFiles < 1 ) {
+    return;
   }
+  diskStressAppendFiles = InAppendFiles;
 }
 
 /*****************************************************************************!
- * Function : DiskStressGetThreadID
+ * Function : DiskStressThreadGetAppendFiles
  *****************************************************************************/
-pthread_t
-DiskStressGetThreadID
+int
+DiskStressThreadGetAppendFiles
 ()
 {
-  return DiskStressThreadID;
+  return diskStressAppendFiles;
 }
 
 /*****************************************************************************!
- * Function : DiskStressGenFilename
+ * Function : DiskStressThreadSetOverwritePercent
  *****************************************************************************/
-string
-DiskStressGenFilename
-()
+void
+DiskStressThreadSetOverwritePercent
+(int InOverwritePercent)
 {
-  int                                   n;
-  string                                s;
-  
-  DiskStressFilenameIndex++;
-
-  n = strlen(DiskStressFilenameBase) + 16;
-  s = (string)GetMemory(n);
-  sprintf(s, "%s%lld", DiskStressFilenameBase, DiskStressFilenameIndex);
-  return s;
+  if ( InOverwritePercent < 0 || InOverwritePercent > 100 ) {
+    return;
+  }
+  DiskStressSettingSet(diskStressOverwritePercent, InOverwritePercent);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_OVERWRITE);
 }
 
 /*****************************************************************************!
- * Function : DiskStressGetFileCount
+ * Function : DiskStressThreadGetOverwritePercent
  *****************************************************************************/
-uint32_t
-DiskStressGetFileCount
+int
+DiskStressThreadGetOverwritePercent
 ()
 {
-  return FileInfoBlockGetCount(diskStressFileHead);
+  return DiskStressSettingGet(diskStressOverwritePercent);
 }
 
-
 /*****************************************************************************!
- * Function : DiskStressFileList
+ * Function : DiskStressThreadSetOverwriteSize
  *****************************************************************************/
 void
-DiskStressFileList
+DiskStressThreadSetOverwriteSize
+(uint32_t InOverwriteSize)
+{
+  if ( InOverwriteSize == 0 ) {
+    return;
+  }
+  DiskStressSettingSet(diskStressOverwriteSize, InOverwriteSize);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_OVERSIZE);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetOverwriteSize
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetOverwriteSize
 ()
 {
-  FileInfoBlockDisplay(diskStressFileHead);
+  return DiskStressSettingGet(diskStressOverwriteSize);
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetDirectory
+ * Function : DiskStressThreadSetHotSet
+ *  <percent of overwrites>:<percent of slots>, 90:10 sends nine overwrites
+ *  in ten to a tenth of the slots
  *****************************************************************************/
-void
-DiskStressThreadSetDirectory
-(string InDirectoryName)
+bool
+DiskStressThreadSetHotSet
+(string InSpec)
 {
-  if ( diskStressDirectory ) {
-    FreeMemory(diskStressDirectory);
+  int                                   percent, size;
+  char                                  c;
+
+  if ( sscanf(InSpec, "%d:%d%c", &percent, &size, &c) != 2 ) {
+    return false;
   }
-  diskStressDirectory = StringCopy(InDirectoryName);
-  if ( StringEndsWith(diskStressDirectory, "/") ) {
-    return;
+  if ( percent < 0 || percent > 100 || size < 1 || size > 100 ) {
+    return false;
   }
-  diskStressDirectory = StringConcatTo(diskStressDirectory, "/");
+  DiskStressSettingSet(diskStressHotSetPercent, percent);
+  DiskStressSettingSet(diskStressHotSetSize, size);
+  DiskStressThreadNoteOverride(DISK_STRESS_SETTING_HOTSET);
+  return true;
 }
 
 /*****************************************************************************!
- * Function : DiskStressGetFileSize
+ * Function : DiskStressThreadSetFanout
+ *  <levels>:<width>, taken before the thread starts
  *****************************************************************************/
-uint64_t
-DiskStressGetFileSize
-()
+bool
+DiskStressThreadSetFanout
+(string InSpec)
 {
-  return FileInfoBlockGetSize(diskStressFileHead);
+  return FileNamespaceParse(InSpec, &diskStressFanoutLevels, &diskStressFanoutWidth);
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadCleanFiles
+ * Function : DiskStressThreadGetFanout
  *****************************************************************************/
-void
-DiskStressThreadCleanFiles
+string
+DiskStressThreadGetFanout
 ()
 {
-  DIR*                                  dir;
-  struct dirent*            entry;
-  string                fullname;
-  int                   n;
+  static char                           fanout[32];
 
-  dir = opendir(diskStressDirectory);
-  if ( NULL == dir ) {
-  return;
+  if ( diskStressFanoutLevels == 0 ) {
+    return "flat";
   }
+  sprintf(fanout, "%d:%d", diskStressFanoutLevels, diskStressFanoutWidth);
+  return fanout;
+}
 
-  n = 0;
-  for ( entry = readdir(dir) ; entry ; entry = readdir(dir) ) {
-  if ( StringEqualsOneOf(entry->d_name, ".", "..", NULL) ) {
-    continue;
+/*****************************************************************************!
+ * Function : DiskStressThreadSetMetadata
+ *  on for the default mix, or <create>:<stat>:<rename>:<setattr>:<unlink>
+ *  weights
+ *****************************************************************************/
+bool
+DiskStressThreadSetMetadata
+(string InSpec)
+{
+  int                                   mix[DISK_STRESS_META_COUNT];
+  int                                   i, total;
+  char                                  c;
+
+  if ( StringEqual(InSpec, "on") ) {
+    diskStressMetadata = true;
+    return true;
   }
-  fullname = StringConcat(diskStressDirectory, entry->d_name);
-    if ( unlink(fullname) ) {
-    fprintf(stderr, "%sCould remove file %s%s : %s%s%s\n", ColorRed, ColorBrightRed, fullname, ColorRed, strerror(errno), ColorReset);
-    exit(EXIT_FAILURE);
+  if ( sscanf(InSpec, "%d:%d:%d:%d:%d%c", &mix[0], &mix[1], &mix[2], &mix[3], &mix[4], &c) != DISK_STRESS_META_COUNT ) {
+    return false;
   }
-  FreeMemory(fullname);
-  n++;
+  total = 0;
+  for ( i = 0 ; i < DISK_STRESS_META_COUNT ; i++ ) {
+    if ( mix[i] < 0 ) {
+      return false;
+    }
+    total += mix[i];
   }
-  if ( n > 1 ) {
-  printf("%sFiles removed            : %s%d%s\n", ColorGreen, ColorYellow, n, ColorReset);
+  if ( total == 0 ) {
+    return false;
   }
+  memcpy(diskStressMetaMix, mix, sizeof(mix));
+  diskStressMetadata = true;
+  return true;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetMaxFiles
+ * Function : DiskStressThreadGetMetadata
  *****************************************************************************/
-void
-DiskStressThreadSetMaxFiles
-(uint64_t InMaxFiles)
+string
+DiskStressThreadGetMetadata
+()
 {
-  if ( InMaxFiles == 0 ) {
-  return;
+  static char                           metadata[64];
+
+  if ( !diskStressMetadata ) {
+    return "off";
   }
+  sprintf(metadata, "%d:%d:%d:%d:%d", diskStressMetaMix[0], diskStressMetaMix[1], diskStressMetaMix[2],
+          diskStressMetaMix[3], diskStressMetaMix[4]);
+  return metadata;
+}
 
-  diskStressThreadMaxFiles = InMaxFiles;
+/*****************************************************************************!
+ * Function : DiskStressThreadSetSeed
+ *****************************************************************************/
+bool
+DiskStressThreadSetSeed
+(string InSeed)
+{
+  unsigned long long                    seed;
+  char*                                 end;
+
+  errno = 0;
+  seed = strtoull(InSeed, &end, 0);
+  if ( errno || end == InSeed || *end != 0x00 || *InSeed == '-' ) {
+    return false;
+  }
+  diskStressSeed    = (uint64_t)seed;
+  diskStressSeedSet = true;
+  return true;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetFilesRemovedCount
+ * Function : DiskStressThreadGetSeed
  *****************************************************************************/
 uint64_t
-DiskStressThreadGetFilesRemovedCount
+DiskStressThreadGetSeed
 ()
 {
-  return diskStressThreadFilesRemovedCount;
+  return diskStressSeed;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetFilesCreatedCount 
+ * Function : DiskStressThreadSetEngine
  *****************************************************************************/
-uint64_t
-DiskStressThreadGetFilesCreatedCount
-()
+bool
+DiskStressThreadSetEngine
+(string InEngineName)
 {
-  return diskStressThreadFilesCreatedCount;
+  if ( StringEqual(InEngineName, "sync") ) {
+    diskStressEngine = DISK_STRESS_ENGINE_SYNC;
+    return true;
+  }
+  if ( StringEqual(InEngineName, "iouring") || StringEqual(InEngineName, "io_uring") ) {
+    diskStressEngine = DISK_STRESS_ENGINE_IOURING;
+    return true;
+  }
+  return false;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetMaxFileSize
+ * Function : DiskStressThreadSetIODepth
+ *  A depth greater than one only makes sense with the io_uring engine
  *****************************************************************************/
 void
-DiskStressThreadSetMaxFileSize
-(uint64_t InMaxFileSize)
+DiskStressThreadSetIODepth
+(uint32_t InIODepth)
 {
-  if ( InMaxFileSize == 0 ) {
-  return;
+  if ( !DiskStressThreadValidateIODepth(InIODepth) ) {
+    return;
+  }
+  diskStressIODepth = InIODepth;
+  if ( InIODepth > 1 ) {
+    diskStressEngine = DISK_STRESS_ENGINE_IOURING;
   }
-
-  diskStressMaxFileSize = InMaxFileSize;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetMaxFileSize
+ * Function : DiskStressThreadValidateIODepth
  *****************************************************************************/
-uint64_t
-DiskStressThreadGetMaxFileSize
-()
+bool
+DiskStressThreadValidateIODepth
+(uint32_t InIODepth)
 {
-  return diskStressMaxFileSize;
+  return InIODepth > 0 && InIODepth <= diskStressIODepthMax;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetMaxFiles
+ * Function : DiskStressThreadGetIODepth
  *****************************************************************************/
-uint64_t
-DiskStressThreadGetMaxFiles
+uint32_t
+DiskStressThreadGetIODepth
 ()
 {
-  return diskStressThreadMaxFiles;
+  return diskStressIODepth;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetStartTime
+ * Function : DiskStressThreadGetIODepthMax
  *****************************************************************************/
-time_t
-DiskStressThreadGetStartTime
+uint32_t
+DiskStressThreadGetIODepthMax
 ()
 {
-  return diskStressThreadStartTime;
+  return diskStressIODepthMax;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetSleepPeriod
+ * Function : DiskStressThreadSetWorkerCount
  *****************************************************************************/
 void
-DiskStressThreadSetSleepPeriod
-(int InSleepPeriod)
+DiskStressThreadSetWorkerCount
+(int InWorkerCount)
 {
-  if ( InSleepPeriod < diskStressThreadSleepPeriodMin ) {
+  if ( !DiskStressThreadValidateWorkerCount(InWorkerCount) ) {
     return;
   }
-  diskStressThreadSleepPeriod = InSleepPeriod;
+  diskStressWorkerCount = InWorkerCount;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadValidateSleepPeriod
+ * Function : DiskStressThreadValidateWorkerCount
  *****************************************************************************/
 bool
-DiskStressThreadValidateSleepPeriod
-(int InSleepPeriod)
+DiskStressThreadValidateWorkerCount
+(int InWorkerCount)
 {
-  return InSleepPeriod >= diskStressThreadSleepPeriodMin;
+  return InWorkerCount > 0 && InWorkerCount <= diskStressWorkerCountMax;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetSleepPeriod
+ * Function : DiskStressThreadGetWorkerCount
  *****************************************************************************/
 int
-DiskStressThreadGetSleepPeriod
+DiskStressThreadGetWorkerCount
 ()
 {
-  return diskStressThreadSleepPeriod;
+  return diskStressWorkerCount;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetSleepPeriodMin
+ * Function : DiskStressThreadGetWorkerCountMax
  *****************************************************************************/
 int
-DiskStressThreadGetSleepPeriodMin
+DiskStressThreadGetWorkerCountMax
 ()
 {
-  return diskStressThreadSleepPeriodMin;
+  return diskStressWorkerCountMax;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadStressInfoToJSON
+ * Function : DiskStressThreadAddPhase
+ *  Snapshots the current settings as the next phase.  The job file applies
+ *  each phase's options on top of the previous one's before adding it.
  *****************************************************************************/
-JSONOut*
-DiskStressThreadStressInfoToJSON
-()
+bool
+DiskStressThreadAddPhase
+(string InName, uint32_t InDuration)
 {
-  JSONOut*                              object;
-  int                                   diskTotalFileSize, diskCurrentFileSize;
-  int                                   diskUsedPercent;
+  DiskStressPhase*                      phase;
 
-  diskTotalFileSize = FileInfoBlockSetGetSize();
-  diskCurrentFileSize = FileInfoBlockGetCount();
-  diskUsedPercent     = (int)(diskCurrentFileSize * 100 / diskTotalFileSize);
- 
-  object = JSONOutCreateObject("stressinfo");
-  JSONOutObjectAddObjects(object,
-                          JSONOutCreateInt("highpercent", diskStressHighUsagePercent),
-                          JSONOutCreateInt("lowpercent",  diskStressLowUsagePercent),
-                          JSONOutCreateInt("currentpercent", diskUsedPercent),
-                          JSONOutCreateInt("sleepperiod", diskStressThreadSleepPeriod),
-                          JSONOutCreateInt("cycle", diskStressCycleCount),
-                          JSONOutCreateString("process", diskStressTrend == DISK_STRESS_TREND_INCREASE ? "Creation" : "Removing"),
-                          NULL);
-  return object;
+  if ( diskStressPhaseCount == DISK_STRESS_PHASES_MAX ) {
+    return false;
+  }
+  phase = &(diskStressPhases[diskStressPhaseCount++]);
+  DiskStressThreadSaveSettings(phase);
+  phase->name     = StringCopy(InName);
+  phase->duration = InDuration;
+  return true;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetHighPercent 
+ * Function : DiskStressThreadGetPhaseCount
  *****************************************************************************/
 int
-DiskStressThreadGetHighPercent
+DiskStressThreadGetPhaseCount
 ()
 {
-  return diskStressHighUsagePercent;
+  return diskStressPhaseCount;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadGetLowPercent
+ * Function : DiskStressThreadSetDuration
+ *  Seconds before the run stops, 0 runs until it is stopped
  *****************************************************************************/
-int
-DiskStressThreadGetLowPercent
+void
+DiskStressThreadSetDuration
+(uint32_t InDuration)
+{
+  diskStressDuration = InDuration;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadGetDuration
+ *****************************************************************************/
+uint32_t
+DiskStressThreadGetDuration
 ()
 {
-  return diskStressLowUsagePercent;
+  return diskStressDuration;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetLowPercent
+ * Function : DiskStressThreadSetJobFile
+ *  Only recorded, main reads the job file and calls
+ *  DiskStressThreadEndJobFile when it is done
  *****************************************************************************/
 void
-DiskStressThreadSetLowPercent
-(int InLowPercent)
+DiskStressThreadSetJobFile
+(string InPath)
 {
-  if ( InLowPercent > 0 && InLowPercent <= 100 ) {
-    diskStressLowUsagePercent = InLowPercent;
+  if ( diskStressJobFile ) {
+    FreeMemory(diskStressJobFile);
   }
+  diskStressJobFile = StringCopy(InPath);
+  diskStressJobFileLoading = true;
 }
 
 /*****************************************************************************!
- * Function : DiskStressThreadSetHighPercent
+ * Function : DiskStressThreadEndJobFile
+ *  Phase settings changed from here on override every phase
  *****************************************************************************/
 void
-DiskStressThreadSetHighPercent
-(int InHighPercent)
+DiskStressThreadEndJobFile
+()
 {
-  if ( InHighPercent > 0 && InHighPercent <= 100 ) {
-    diskStressHighUsagePercent = InHighPercent;
+  diskStressJobFileLoading = false;
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadNoteOverride
+ *  A phase setting set outside the job file once there are phases, from
+ *  the command line after --job or from the user at run time
+ *****************************************************************************/
+static void
+DiskStressThreadNoteOverride
+(uint32_t InSetting)
+{
+  if ( diskStressPhaseCount && !diskStressJobFileLoading ) {
+    diskStressPhaseOverrides |= InSetting;
+  }
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetTrace
+ *  Records every operation of the run to InPath
+ *****************************************************************************/
+void
+DiskStressThreadSetTrace
+(string InPath)
+{
+  if ( diskStressTracePath ) {
+    FreeMemory(diskStressTracePath);
+  }
+  diskStressTracePath = StringCopy(InPath);
+}
+
+/*****************************************************************************!
+ * Function : DiskStressThreadSetReplay
+ *  Replays the operations recorded in InPath instead of generating them
+ *****************************************************************************/
+void
+DiskStressThreadSetReplay
+(string InPath)
+{
+  if ( diskStressReplayPath ) {
+    FreeMemory(diskStressReplayPath);
   }
+  diskStressReplayPath = StringCopy(InPath);
 }
 
+/*****************************************************************************!
+ * Function : DiskStressThreadSetReplayFast
+ *****************************************************************************/
+void
+DiskStressThreadSetReplayFast
+(bool InReplayFast)
+{
+  diskStressReplayFast = InReplayFast;
+}
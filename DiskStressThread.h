@@ -34,7 +34,7 @@ uint64_t
 DiskStressGetFileSize
 ();
 
-void
+bool
 DiskStressThreadSetDirectory
 (string InDirectoryName);
 
@@ -42,7 +42,7 @@ void
 DiskStressFileList
 ();
 
-uint32_t
+uint64_t
 DiskStressGetFileCount
 ();
 
@@ -74,7 +74,7 @@ uint64_t
 DiskStressThreadGetFilesCreatedCount
 ();
 
-void
+bool
 DiskStressThreadSetMaxFileSize
 (uint64_t InMaxFileSize);
 
@@ -126,4 +126,256 @@ void
 DiskStressThreadSetHighPercent
 (int InHighPercent);
 
+void
+DiskStressThreadSetWriteBlockSize
+(uint32_t InBlockSize);
+
+bool
+DiskStressThreadValidateWriteBlockSize
+(uint32_t InBlockSize);
+
+uint32_t
+DiskStressThreadGetWriteBlockSize
+();
+
+uint32_t
+DiskStressThreadGetWriteBlockSizeMin
+();
+
+uint32_t
+DiskStressThreadGetWriteBlockSizeMax
+();
+
+void
+DiskStressThreadSetDirectIO
+(bool InDirectIO);
+
+bool
+DiskStressThreadGetDirectIO
+();
+
+void
+DiskStressThreadSetVerify
+(bool InVerify);
+
+bool
+DiskStressThreadGetVerify
+();
+
+void
+DiskStressThreadSetReadPercent
+(int InReadPercent);
+
+bool
+DiskStressThreadValidateReadPercent
+(int InReadPercent);
+
+int
+DiskStressThreadGetReadPercent
+();
+
+void
+DiskStressThreadSetReadSize
+(uint64_t InReadSize);
+
+uint64_t
+DiskStressThreadGetReadSize
+();
+
+bool
+DiskStressThreadSetSyncPolicy
+(string InPolicy);
+
+string
+DiskStressThreadGetSyncPolicy
+();
+
+bool
+DiskStressThreadSetSizeDistribution
+(string InSpec);
+
+void
+DiskStressThreadSetRateMBps
+(uint32_t InRateMBps);
+
+uint32_t
+DiskStressThreadGetRateMBps
+();
+
+void
+DiskStressThreadSetRateIOPS
+(uint32_t InRateIOPS);
+
+uint32_t
+DiskStressThreadGetRateIOPS
+();
+
+bool
+DiskStressThreadSetArrival
+(string InSpec);
+
+string
+DiskStressThreadGetArrival
+();
+
+void
+DiskStressThreadSetTarget
+(string InPath, bool InCreate);
+
+string
+DiskStressThreadGetTarget
+();
+
+bool
+DiskStressThreadSetTargetRelease
+(string InName);
+
+bool
+DiskStressThreadSetFanout
+(string InSpec);
+
+string
+DiskStressThreadGetFanout
+();
+
+bool
+DiskStressThreadSetMetadata
+(string InSpec);
+
+string
+DiskStressThreadGetMetadata
+();
+
+bool
+DiskStressThreadSetSeed
+(string InSeed);
+
+uint64_t
+DiskStressThreadGetSeed
+();
+
+void
+DiskStressThreadSetOverwritePercent
+(int InOverwritePercent);
+
+int
+DiskStressThreadGetOverwritePercent
+();
+
+void
+DiskStressThreadSetOverwriteSize
+(uint32_t InOverwriteSize);
+
+uint32_t
+DiskStressThreadGetOverwriteSize
+();
+
+bool
+DiskStressThreadSetHotSet
+(string InSpec);
+
+uint64_t
+DiskStressThreadGetOverwriteCount
+();
+
+uint64_t
+DiskStressThreadGetBytesOverwritten
+();
+
+uint64_t
+DiskStressThreadGetOverwriteLatency
+();
+
+void
+DiskStressThreadSetAppendChunk
+(uint32_t InAppendChunk);
+
+uint32_t
+DiskStressThreadGetAppendChunk
+();
+
+void
+DiskStressThreadSetAppendFiles
+(int InAppendFiles);
+
+int
+DiskStressThreadGetAppendFiles
+();
+
+bool
+DiskStressThreadSetEngine
+(string InEngineName);
+
+void
+DiskStressThreadSetIODepth
+(uint32_t InIODepth);
+
+bool
+DiskStressThreadValidateIODepth
+(uint32_t InIODepth);
+
+uint32_t
+DiskStressThreadGetIODepth
+();
+
+uint32_t
+DiskStressThreadGetIODepthMax
+();
+
+void
+DiskStressThreadSetWorkerCount
+(int InWorkerCount);
+
+bool
+DiskStressThreadValidateWorkerCount
+(int InWorkerCount);
+
+int
+DiskStressThreadGetWorkerCount
+();
+
+int
+DiskStressThreadGetWorkerCountMax
+();
+
+bool
+DiskStressThreadAddPhase
+(string InName, uint32_t InDuration);
+
+int
+DiskStressThreadGetPhaseCount
+();
+
+void
+DiskStressThreadSetDuration
+(uint32_t InDuration);
+
+uint32_t
+DiskStressThreadGetDuration
+();
+
+void
+DiskStressThreadSetJobFile
+(string InPath);
+
+void
+DiskStressThreadEndJobFile
+();
+
+void
+DiskStressThreadSetTrace
+(string InPath);
+
+void
+DiskStressThreadSetReplay
+(string InPath);
+
+void
+DiskStressThreadSetReplayFast
+(bool InReplayFast);
+
+JSONOut*
+DiskStressThreadConfigToJSON
+();
+
 #endif // _diskstressthread_h_
@@ -8,168 +8,235 @@
 /*****************************************************************************!
  * Global Headers
  *****************************************************************************/
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
 
 /*****************************************************************************!
  * Local Headers
  *****************************************************************************/
 #include "FileInfoBlock.h"
 #include "GeneralUtilities/MemoryManager.h"
+#include "TimeStamp.h"
 
 /*****************************************************************************!
  * Local Macros
  *****************************************************************************/
+//! Extents fetched per FIEMAP call when counting a file's extents
+#define FILE_INFO_BLOCK_FIEMAP_BATCH    32
 
 /*****************************************************************************!
  * Local Functions
  *****************************************************************************/
+static uint64_t
+FileInfoBlockGetPatternSeed
+(FileInfoBlock* InBlock);
+
+static uint32_t
+FileInfoBlockGetExtentCount
+(int InFD, uint32_t* InPending);
+
+static void
+FileInfoBlockSetState
+(FileInfoBlock* InBlock, bool InOccupied, uint64_t InSize);
+
+static int
+FileInfoBlockGetNamespace
+(int64_t InIndex);
 
 /*****************************************************************************!
  * Local Data
  *****************************************************************************/
+//! The set lives in slot memory so only the pages holding used slots are
+//  backed
 FileInfoBlock*
 fileInfoBlockSet = NULL;
 
-int
+int64_t
 fileInfoBlockSetSize = 0;
 
+static SlotMemory*
+fileInfoBlockSetMemory = NULL;
+
+//! Which slots hold a file, so free and used slots can be found without
+//  probing
+static SlotBitmap*
+fileInfoBlockOccupied = NULL;
+
+//! The checksum each slot's file was written with, only kept when verifying
+static uint32_t*
+fileInfoBlockChecksums = NULL;
+
+static SlotMemory*
+fileInfoBlockChecksumMemory = NULL;
+
+//! Running totals over the set, kept as blocks change so the getters do
+//  not walk it.  Updated by the workers, read by any thread.
+static uint64_t
+fileInfoBlockOccupiedCount = 0;
+
+static uint64_t
+fileInfoBlockOccupiedBytes = 0;
+
+//! Resident bytes of the set as of the last FileInfoBlockSetUpdateResident
+static uint64_t
+fileInfoBlockResident = 0;
+
 string
 fileInfoBlockPrefix = "DiskFileInfo";
 
+//! When set, slots are extents of a device or image instead of files
+static BlockTarget*
+fileInfoBlockTarget = NULL;
+
+//! The directories the files live in, set before any file is touched.
+//  Each stress directory owns the slots from its first index up to the
+//  next one's.
+static FileNamespace*
+fileInfoBlockNamespaces[FILE_INFO_BLOCK_NAMESPACES_MAX];
+
+static int64_t
+fileInfoBlockNamespaceFirst[FILE_INFO_BLOCK_NAMESPACES_MAX];
+
+static int
+fileInfoBlockNamespaceCount = 0;
+
+//! Occupied slots in each stress directory's part of the set
+static uint64_t
+fileInfoBlockNamespaceOccupied[FILE_INFO_BLOCK_NAMESPACES_MAX];
+
 /*****************************************************************************!
  * Function : FileInfoBlockSetCreate
+ *  Only reserves address space, the set starts out all zero, every slot
+ *  empty, without touching it
  *****************************************************************************/
 void
 FileInfoBlockSetCreate
-(int InSetSize)
+(int64_t InSetSize, bool InChecksums)
 {
-  int                                   i, n;
-
-  if ( InSetSize == 0 ) {
+  if ( InSetSize <= 0 ) {
 	return;
   }
 
-  n = InSetSize * sizeof(FileInfoBlock);
-  fileInfoBlockSet = (FileInfoBlock*)GetMemory(n);
-  memset(fileInfoBlockSet, 0x00, n);
+  fileInfoBlockSetMemory = SlotMemoryCreate((uint64_t)InSetSize * sizeof(FileInfoBlock));
+  fileInfoBlockSet = (FileInfoBlock*)fileInfoBlockSetMemory->base;
   fileInfoBlockSetSize = InSetSize;
-
-  for ( i = 0 ; i < InSetSize ; i++ ) {
-    fileInfoBlockSet[i].index = i + 1;
+  fileInfoBlockOccupied = SlotBitmapCreate(InSetSize);
+  if ( InChecksums ) {
+    fileInfoBlockChecksumMemory = SlotMemoryCreate((uint64_t)InSetSize * sizeof(uint32_t));
+    fileInfoBlockChecksums = (uint32_t*)fileInfoBlockChecksumMemory->base;
   }
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockCreate
+ * Function : FileInfoBlockSetGetMemory
+ *  Bytes of address space reserved for the set
  *****************************************************************************/
-FileInfoBlock*
-FileInfoBlockCreate
-(string InFilename, uint64_t InFileSize)
+uint64_t
+FileInfoBlockSetGetMemory
+()
 {
-  FileInfoBlock*                        infoBlock;
-  if ( NULL == InFilename || 0 == InFileSize ) {
-    return NULL;
-  }
+  uint64_t                              bytes;
 
-  infoBlock = (FileInfoBlock*)GetMemory(sizeof(FileInfoBlock));
-  memset(infoBlock, 0x00, sizeof(FileInfoBlock));
-  infoBlock->filename = StringCopy(InFilename);
-  infoBlock->filesize = InFileSize;
-  infoBlock->filetime = time(NULL);
-  return infoBlock;
+  if ( NULL == fileInfoBlockSetMemory ) {
+    return 0;
+  }
+  bytes = fileInfoBlockSetMemory->size;
+  if ( fileInfoBlockChecksumMemory ) {
+    bytes += fileInfoBlockChecksumMemory->size;
+  }
+  bytes += fileInfoBlockOccupied->wordMemory->size + fileInfoBlockOccupied->groupMemory->size +
+    fileInfoBlockOccupied->sumMemory->size;
+  return bytes;
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockDestroy
+ * Function : FileInfoBlockSetUpdateResident
+ *  Measures the bytes of the set backed by memory, which grows with the
+ *  slots used.  It walks every page reserved, so it is sampled.
  *****************************************************************************/
 void
-FileInfoBlockDestroy
-(FileInfoBlock* InInfoBlock)
+FileInfoBlockSetUpdateResident
+()
 {
-  if ( NULL == InInfoBlock ) {
+  uint64_t                              resident;
+
+  if ( NULL == fileInfoBlockSetMemory ) {
     return;
   }
-  FreeMemory(InInfoBlock->filename);
-  FreeMemory(InInfoBlock);
+  resident = SlotMemoryGetResident(fileInfoBlockSetMemory) + SlotMemoryGetResident(fileInfoBlockChecksumMemory) +
+    SlotBitmapGetResident(fileInfoBlockOccupied);
+  __atomic_store_n(&fileInfoBlockResident, resident, __ATOMIC_RELAXED);
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockAppend
+ * Function : FileInfoBlockSetGetResident
+ *  The last sample taken by FileInfoBlockSetUpdateResident
  *****************************************************************************/
-FileInfoBlock*
-FileInfoBlockAppend
-(FileInfoBlock* InHead, FileInfoBlock* InInfoBlock)
+uint64_t
+FileInfoBlockSetGetResident
+()
 {
-  FileInfoBlock*                        infoBlock;
-  if ( NULL == InInfoBlock ) {
-    return NULL;
-  }
-
-  InInfoBlock->next = NULL;
-  InInfoBlock->prev = NULL;
-  
-  if ( NULL == InHead ) {
-    return InInfoBlock;
-  }
-
-  infoBlock = InHead;
-
-  while ( infoBlock->next ) {
-    infoBlock = infoBlock->next;
-  }
-  infoBlock->next = InInfoBlock;
-  InInfoBlock->prev = infoBlock;
-  return InHead;
+  return __atomic_load_n(&fileInfoBlockResident, __ATOMIC_RELAXED);
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockRemove
+ * Function : FileInfoBlockGetIndex
+ *  The block's 1 based slot number, its position in the set
  *****************************************************************************/
-FileInfoBlock*
-FileInfoBlockRemove
-(FileInfoBlock* InHead, FileInfoBlock* InInfoBlock, bool InDestroy)
+int64_t
+FileInfoBlockGetIndex
+(FileInfoBlock* InBlock)
 {
-  FileInfoBlock*                        prevInfoBlock;
-  FileInfoBlock*                        infoBlock;
-  if ( NULL == InHead || NULL == InInfoBlock ) {
-    return InHead;
-  }
+  return (int64_t)(InBlock - fileInfoBlockSet) + 1;
+}
 
-  if ( InHead == InInfoBlock ) {
-    infoBlock = InHead->next;
-    if ( InDestroy ) {
-      FileInfoBlockDestroy(InInfoBlock);
-    }
-    infoBlock->prev = NULL;
-    return infoBlock;
-  }
+/*****************************************************************************!
+ * Function : FileInfoBlockIsOccupied
+ *****************************************************************************/
+bool
+FileInfoBlockIsOccupied
+(FileInfoBlock* InBlock)
+{
+  return SlotBitmapTest(fileInfoBlockOccupied, (uint64_t)(InBlock - fileInfoBlockSet));
+}
 
-  prevInfoBlock = InHead;
-  infoBlock = InHead->next;
-  while ( infoBlock && infoBlock != InInfoBlock ) {
-    prevInfoBlock = infoBlock;
-    infoBlock = infoBlock->next;
+/*****************************************************************************!
+ * Function : FileInfoBlockGetChecksum
+ *  0 when the set was created without checksums
+ *****************************************************************************/
+uint32_t
+FileInfoBlockGetChecksum
+(FileInfoBlock* InBlock)
+{
+  if ( NULL == fileInfoBlockChecksums ) {
+    return 0;
   }
+  return fileInfoBlockChecksums[InBlock - fileInfoBlockSet];
+}
 
-  if ( NULL == infoBlock ) {
-    return InHead;
-  }
-  prevInfoBlock->next = infoBlock->next;
-  if ( infoBlock->next ) {
-    infoBlock->next->prev = prevInfoBlock;
-  }
-  if ( InDestroy ) {
-    FileInfoBlockDestroy(infoBlock);
+/*****************************************************************************!
+ * Function : FileInfoBlockSetChecksum
+ *****************************************************************************/
+void
+FileInfoBlockSetChecksum
+(FileInfoBlock* InBlock, uint32_t InChecksum)
+{
+  if ( NULL == fileInfoBlockChecksums ) {
+    return;
   }
-  return InHead;
+  fileInfoBlockChecksums[InBlock - fileInfoBlockSet] = InChecksum;
 }
 
-
 /*****************************************************************************!
  * Function : FileInfoBlockDisplay
  *****************************************************************************/
@@ -179,75 +246,73 @@ FileInfoBlockDisplay
 {
   struct tm*                            t;
   FileInfoBlock*                        infoBlock;
-  int                                   i;
+  int64_t                               i;
+  time_t                                filetime;
 
   for ( i = 0 ; i < fileInfoBlockSetSize ; i++ ) {
-	if ( fileInfoBlockSet[i].filesize == 0 ) {
+	if ( !SlotBitmapTest(fileInfoBlockOccupied, i) ) {
 	  continue;
 	}
 	infoBlock = &(fileInfoBlockSet[i]);
-    t = localtime(&infoBlock->filetime);
-    printf("%6d  %10lld  %02d/%02d/%04d %02d:%02d:%02d\n",
-		   infoBlock->index, 
-           infoBlock->filesize,
+    filetime = (time_t)infoBlock->filetime;
+    t = localtime(&filetime);
+    printf("%6lld  %10llu  %02d/%02d/%04d %02d:%02d:%02d\n",
+		   (long long)i + 1,
+           (unsigned long long)infoBlock->filesize,
            t->tm_mon + 1, t->tm_mday, t->tm_year + 1900, t->tm_hour, t->tm_min, t->tm_sec);
   }
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockFindByName
+ * Function : FileInfoBlockGetCount
  *****************************************************************************/
-FileInfoBlock*
-FileInfoBlockFindByName
-(FileInfoBlock* InHead, string  InFileName)
+uint64_t
+FileInfoBlockGetCount
+()
 {
-  FileInfoBlock*                        infoBlock;
-  if ( NULL == InHead || NULL == InFileName ) {
-    return NULL;
-  }
-
-  for ( infoBlock = InHead; infoBlock ; infoBlock = infoBlock->next ) {
-    if ( StringEqual(InFileName, infoBlock->filename) ) {
-      return infoBlock;
-    }
-  }
-  return NULL;
+  return __atomic_load_n(&fileInfoBlockOccupiedCount, __ATOMIC_RELAXED);
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockRemoveByName
+ * Function : FileInfoBlockGetRangeCount
+ *  Occupied slots in [InFirst, InLast).  A stress directory's whole part of
+ *  the set is a running total, any other range is counted from the bitmap.
  *****************************************************************************/
-FileInfoBlock*
-FileInfoBlockRemoveByName
-(FileInfoBlock* InHead, string InFilename, bool InDestroy)
+uint64_t
+FileInfoBlockGetRangeCount
+(int64_t InFirst, int64_t InLast)
 {
-  FileInfoBlock*                        infoBlock;
-  if ( NULL == InHead || NULL == InFilename ) {
-    return NULL;
+  int64_t                               last;
+  int                                   i;
+
+  if ( NULL == fileInfoBlockOccupied ) {
+    return 0;
   }
-  infoBlock = FileInfoBlockFindByName(InHead, InFilename);
-  if ( NULL == infoBlock ) {
-    return InHead;
+  for ( i = 0 ; i < fileInfoBlockNamespaceCount ; i++ ) {
+    last = i + 1 < fileInfoBlockNamespaceCount ? fileInfoBlockNamespaceFirst[i + 1] : fileInfoBlockSetSize;
+    if ( fileInfoBlockNamespaceFirst[i] == InFirst && last == InLast ) {
+      return __atomic_load_n(&(fileInfoBlockNamespaceOccupied[i]), __ATOMIC_RELAXED);
+    }
   }
-  return FileInfoBlockRemove(InHead, infoBlock, InDestroy);
+  return SlotBitmapCount(fileInfoBlockOccupied, InFirst, InLast, true);
 }
 
-
 /*****************************************************************************!
- * Function : FileInfoBlockGetCount
+ * Function : FileInfoBlockGetRandomBlock
+ *  A uniformly chosen occupied, or empty, slot in [InFirst, InLast), NULL
+ *  when there is none
  *****************************************************************************/
-uint32_t
-FileInfoBlockGetCount
-()
+FileInfoBlock*
+FileInfoBlockGetRandomBlock
+(int64_t InFirst, int64_t InLast, bool InOccupied, Random* InRandom)
 {
-  int									i, count;
-  count = 0;
-  for (i = 0; i < fileInfoBlockSetSize ; i++ ) {
-	if ( fileInfoBlockSet[i].filesize ) {
-	  count++;
-	}
+  int64_t                               slot;
+
+  if ( NULL == fileInfoBlockOccupied ) {
+    return NULL;
   }
-  return count;
+  slot = SlotBitmapSelect(fileInfoBlockOccupied, InFirst, InLast, InOccupied, InRandom);
+  return slot < 0 ? NULL : &(fileInfoBlockSet[slot]);
 }
 
 /*****************************************************************************!
@@ -257,17 +322,7 @@ uint64_t
 FileInfoBlockGetSize
 (FileInfoBlock* InHead)
 {
-  uint64_t                              size;
-  int                                   i;
-
-  size = 0;
-
-  for (i = 0; i < fileInfoBlockSetSize ; i++ ) {
-	if ( fileInfoBlockSet[i].filesize ) {
-	  size += fileInfoBlockSet[i].filesize;
-	}
-  }
-  return size;
+  return __atomic_load_n(&fileInfoBlockOccupiedBytes, __ATOMIC_RELAXED);
 }
 
 /*****************************************************************************!
@@ -275,7 +330,7 @@ FileInfoBlockGetSize
  *****************************************************************************/
 FileInfoBlock*
 FileInfoBlockGetBlock
-(int InIndex)
+(int64_t InIndex)
 {
   if ( InIndex < 0 || InIndex >= fileInfoBlockSetSize ) {
 	return NULL;
@@ -288,14 +343,14 @@ FileInfoBlockGetBlock
  *****************************************************************************/
 void
 FileInfoBlockSetBlock
-(FileInfoBlock* InBlock, int InSize)
+(FileInfoBlock* InBlock, uint64_t InSize)
 {
   if ( InBlock == NULL || InSize == 0 ) {
 	return;
   }
-  InBlock->filetime = time(NULL);
-  InBlock->filesize = InSize;
-  
+  InBlock->filetime = (uint32_t)time(NULL);
+  FileInfoBlockSetState(InBlock, true, InSize);
+  InBlock->generation++;
 }
 
 /*****************************************************************************!
@@ -308,63 +363,964 @@ FileInfoBlockClearBlock
   if ( InBlock == NULL ) {
 	return;
   }
-  InBlock->filesize = 0;
   InBlock->filetime = 0;
+  FileInfoBlockSetState(InBlock, false, 0);
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockCreateFile
+ * Function : FileInfoBlockSetFileSize
+ *  A file that ended up a different size than planned, such as an append
+ *  cut short
  *****************************************************************************/
 void
-FileInfoBlockCreateFile
-(FileInfoBlock* InBlock, string InDirectory)
+FileInfoBlockSetFileSize
+(FileInfoBlock* InBlock, uint64_t InSize)
 {
-  char									filename[32];
-  FILE*                                 file;
+  if ( InBlock == NULL ) {
+	return;
+  }
+  FileInfoBlockSetState(InBlock, FileInfoBlockIsOccupied(InBlock), InSize);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockSetState
+ *  The only place occupancy and filesize change, so the bitmap and the
+ *  running totals stay in step
+ *****************************************************************************/
+static void
+FileInfoBlockSetState
+(FileInfoBlock* InBlock, bool InOccupied, uint64_t InSize)
+{
+  uint64_t                              delta;
+  uint64_t                              slot;
   int                                   i;
-  string                                s;
 
+  slot = (uint64_t)(InBlock - fileInfoBlockSet);
+  if ( InOccupied != SlotBitmapTest(fileInfoBlockOccupied, slot) ) {
+    delta = InOccupied ? 1 : (uint64_t)-1;
+    __atomic_fetch_add(&fileInfoBlockOccupiedCount, delta, __ATOMIC_RELAXED);
+    i = FileInfoBlockGetNamespace(slot + 1);
+    if ( i >= 0 ) {
+      __atomic_fetch_add(&(fileInfoBlockNamespaceOccupied[i]), delta, __ATOMIC_RELAXED);
+    }
+    if ( InOccupied ) {
+      SlotBitmapSet(fileInfoBlockOccupied, slot);
+    } else {
+      SlotBitmapClear(fileInfoBlockOccupied, slot);
+    }
+  }
+
+  //! Unsigned wrap around makes a shrink a subtraction
+  __atomic_fetch_add(&fileInfoBlockOccupiedBytes, InSize - InBlock->filesize, __ATOMIC_RELAXED);
+  InBlock->filesize = InSize;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockSetEmptyBlock
+ *  Marks InBlock as holding a zero length file
+ *****************************************************************************/
+void
+FileInfoBlockSetEmptyBlock
+(FileInfoBlock* InBlock)
+{
   if ( InBlock == NULL ) {
 	return;
   }
+  InBlock->filetime = (uint32_t)time(NULL);
+  FileInfoBlockSetState(InBlock, true, 0);
+  InBlock->generation++;
+}
 
-  sprintf(filename, "%s%08d", fileInfoBlockPrefix, InBlock->index);
-  s = StringConcat(InDirectory, filename);
-  file = fopen(s, "wb");
-  if ( NULL == file ) {
-	return;
+/*****************************************************************************!
+ * Function : FileInfoBlockCreateFile
+ *  Writes the file in InBuffer sized chunks and returns the time spent in
+ *  open/write/sync/close in InElapsed and the time spent in fsync or
+ *  fdatasync alone in InSyncElapsed (microseconds).  With a block target the
+ *  data goes to the slot's extent, a direct I/O tail is padded out to the
+ *  alignment since the shared descriptor cannot drop O_DIRECT.
+ *****************************************************************************/
+bool
+FileInfoBlockCreateFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t* InElapsed, uint64_t* InSyncElapsed)
+{
+  int                                   fd;
+  int                                   flags;
+  uint64_t                              remaining;
+  uint64_t                              tail, base, position;
+  uint64_t                              startTime, syncTime;
+  ssize_t                               n, padded, offset, bytesWritten;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+  bool                                  result;
+  Checksum                              checksum;
+
+  if ( InBlock == NULL || InBuffer == NULL ) {
+	return false;
   }
-  for (i = 0; i < InBlock->filesize ; i++ ) {
-	fputc(' ', file);
+
+  if ( InBuffer->verify ) {
+    FileInfoBlockFillPattern(InBlock, InBuffer->data, InBuffer->size);
+    ChecksumInit(&checksum);
   }
-  FreeMemory(s);
-  fclose(file);
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  flags = O_WRONLY | O_CREAT | O_TRUNC;
+  if ( InBuffer->directIO ) {
+    flags |= O_DIRECT;
+  }
+  if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_OSYNC ) {
+    flags |= O_SYNC;
+  } else if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_ODSYNC ) {
+    flags |= O_DSYNC;
+  }
+  syncTime = 0;
+  base = 0;
+  startTime = TimeStampGetMicroseconds();
+  if ( fileInfoBlockTarget ) {
+    fd = fileInfoBlockTarget->fd;
+    base = BlockTargetGetOffset(fileInfoBlockTarget, FileInfoBlockGetIndex(InBlock) - 1);
+  } else {
+    fd = openat(dirFD, name, flags, 0644);
+  }
+  if ( fd < 0 && InBuffer->directIO && errno == EINVAL ) {
+    //! The file system does not support O_DIRECT, carry on through the page cache
+    fprintf(stderr, "O_DIRECT not supported for %s%s : using buffered writes\n", InDirectory, path);
+    InBuffer->directIO = false;
+    fd = openat(dirFD, name, flags & ~O_DIRECT, 0644);
+  }
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not create file %s%s : %s\n", InDirectory, path, strerror(errno));
+	return false;
+  }
+
+  result = true;
+  remaining = InBlock->filesize;
+  position = base;
+
+  //! O_DIRECT writes must be a multiple of the alignment, the tail is written
+  //  after dropping O_DIRECT from the descriptor
+  tail = 0;
+  if ( InBuffer->directIO && NULL == fileInfoBlockTarget ) {
+    tail = remaining % InBuffer->alignment;
+    remaining -= tail;
+  }
+
+  while ( result && (remaining > 0 || tail > 0) ) {
+    if ( remaining == 0 ) {
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+      remaining = tail;
+      tail = 0;
+    }
+    n = remaining < InBuffer->size ? (ssize_t)remaining : (ssize_t)InBuffer->size;
+    padded = n;
+    if ( fileInfoBlockTarget && InBuffer->directIO && n % InBuffer->alignment ) {
+      padded += InBuffer->alignment - (n % InBuffer->alignment);
+    }
+    for ( offset = 0 ; offset < padded ; offset += bytesWritten ) {
+      bytesWritten = pwrite(fd, InBuffer->data + offset, padded - offset, position + offset);
+      if ( bytesWritten < 0 ) {
+        if ( errno == EINTR ) {
+          bytesWritten = 0;
+          continue;
+        }
+        fprintf(stderr, "Could not write file %s%s : %s\n", InDirectory, path, strerror(errno));
+        result = false;
+        break;
+      }
+    }
+    if ( offset > n ) {
+      offset = n;
+    }
+    if ( InBuffer->verify ) {
+      ChecksumUpdate(&checksum, InBuffer->data, offset);
+    }
+    remaining -= offset;
+    position += offset;
+  }
+  if ( result && (InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC || InBuffer->sync == FILE_INFO_BLOCK_SYNC_FDATASYNC) ) {
+    syncTime = TimeStampGetMicroseconds();
+    if ( (InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC ? fsync(fd) : fdatasync(fd)) ) {
+      fprintf(stderr, "Could not sync file %s%s : %s\n", InDirectory, path, strerror(errno));
+      result = false;
+    }
+    syncTime = TimeStampGetMicroseconds() - syncTime;
+  }
+  if ( NULL == fileInfoBlockTarget ) {
+    close(fd);
+  }
+  if ( InElapsed ) {
+    *InElapsed = TimeStampGetMicroseconds() - startTime;
+  }
+  if ( InSyncElapsed ) {
+    *InSyncElapsed = syncTime;
+  }
+  if ( InBuffer->verify ) {
+    FileInfoBlockSetChecksum(InBlock, ChecksumFinal(&checksum));
+  }
+  return result;
 }
 
 /*****************************************************************************!
- * Function : FileInfoBlockRemoveFile
+ * Function : FileInfoBlockVerifyFile
+ *  Reads the file back and compares its checksum with the one recorded when
+ *  it was written.  The read uses InBuffer, so the pattern in
+ *  it is lost.
+ *****************************************************************************/
+bool
+FileInfoBlockVerifyFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t* InElapsed, uint32_t* InChecksum)
+{
+  int                                   fd;
+  int                                   flags;
+  uint64_t                              total, base, limit, n;
+  uint64_t                              startTime;
+  ssize_t                               bytesRead;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+  Checksum                              checksum;
+
+  if ( InBlock == NULL || InBuffer == NULL ) {
+	return false;
+  }
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  flags = O_RDONLY;
+  if ( InBuffer->directIO ) {
+    flags |= O_DIRECT;
+  }
+  ChecksumInit(&checksum);
+  total = 0;
+  base = 0;
+
+  //! A file is read to its end, an extent only up to the aligned file size
+  limit = UINT64_MAX;
+  startTime = TimeStampGetMicroseconds();
+  if ( fileInfoBlockTarget ) {
+    fd = fileInfoBlockTarget->fd;
+    base = BlockTargetGetOffset(fileInfoBlockTarget, FileInfoBlockGetIndex(InBlock) - 1);
+    limit = InBlock->filesize;
+    if ( InBuffer->directIO && limit % InBuffer->alignment ) {
+      limit += InBuffer->alignment - (limit % InBuffer->alignment);
+    }
+  } else {
+    fd = openat(dirFD, name, flags);
+    if ( fd < 0 && InBuffer->directIO && errno == EINVAL ) {
+      fd = openat(dirFD, name, flags & ~O_DIRECT);
+    }
+  }
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not open file %s%s : %s\n", InDirectory, path, strerror(errno));
+    *InChecksum = 0;
+	return false;
+  }
+  while ( total < limit ) {
+    n = limit - total < InBuffer->size ? limit - total : InBuffer->size;
+    bytesRead = pread(fd, InBuffer->data, n, base + total);
+    if ( bytesRead < 0 ) {
+      if ( errno == EINTR ) {
+        continue;
+      }
+      fprintf(stderr, "Could not read file %s%s : %s\n", InDirectory, path, strerror(errno));
+      break;
+    }
+    if ( bytesRead == 0 ) {
+      break;
+    }
+    //! io_uring direct writes pad the file past filesize, the padding is not
+    //  part of the checksum
+    if ( total < InBlock->filesize ) {
+      ChecksumUpdate(&checksum, InBuffer->data,
+                     InBlock->filesize - total < (uint64_t)bytesRead ? InBlock->filesize - total : (uint64_t)bytesRead);
+    }
+    total += bytesRead;
+  }
+  if ( NULL == fileInfoBlockTarget ) {
+    close(fd);
+  }
+  if ( InElapsed ) {
+    *InElapsed = TimeStampGetMicroseconds() - startTime;
+  }
+  *InChecksum = ChecksumFinal(&checksum);
+  return total >= InBlock->filesize && *InChecksum == FileInfoBlockGetChecksum(InBlock);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockReadFile
+ *  Reads InLength bytes from InOffset in InBuffer sized chunks.  With direct
+ *  I/O InOffset must be aligned, each chunk is rounded up to the alignment.
+ *  Returns the number of bytes read or -1 when the file could not be read.
+ *****************************************************************************/
+int64_t
+FileInfoBlockReadFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t InOffset, uint64_t InLength, uint64_t* InElapsed)
+{
+  int                                   fd;
+  int                                   flags;
+  uint64_t                              total, n, base;
+  uint64_t                              startTime;
+  ssize_t                               bytesRead;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+
+  if ( InBlock == NULL || InBuffer == NULL ) {
+	return -1;
+  }
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  flags = O_RDONLY;
+  if ( InBuffer->directIO ) {
+    flags |= O_DIRECT;
+  }
+  total = 0;
+  base = 0;
+  startTime = TimeStampGetMicroseconds();
+  if ( fileInfoBlockTarget ) {
+    fd = fileInfoBlockTarget->fd;
+    base = BlockTargetGetOffset(fileInfoBlockTarget, FileInfoBlockGetIndex(InBlock) - 1);
+  } else {
+    fd = openat(dirFD, name, flags);
+    if ( fd < 0 && InBuffer->directIO && errno == EINVAL ) {
+      fd = openat(dirFD, name, flags & ~O_DIRECT);
+    }
+  }
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not open file %s%s : %s\n", InDirectory, path, strerror(errno));
+	return -1;
+  }
+  while ( total < InLength ) {
+    n = InLength - total < InBuffer->size ? InLength - total : InBuffer->size;
+    if ( InBuffer->directIO && n % InBuffer->alignment ) {
+      n += InBuffer->alignment - (n % InBuffer->alignment);
+    }
+    bytesRead = pread(fd, InBuffer->data, n, base + InOffset + total);
+    if ( bytesRead < 0 ) {
+      if ( errno == EINTR ) {
+        continue;
+      }
+      fprintf(stderr, "Could not read file %s%s : %s\n", InDirectory, path, strerror(errno));
+      break;
+    }
+    if ( bytesRead == 0 ) {
+      break;
+    }
+    total += bytesRead;
+  }
+  if ( NULL == fileInfoBlockTarget ) {
+    close(fd);
+  }
+  if ( InElapsed ) {
+    *InElapsed = TimeStampGetMicroseconds() - startTime;
+  }
+  return (int64_t)total;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockOverwriteFile
+ *  Rewrites InLength bytes at InOffset in place with pwrite.  With verify
+ *  the range is read first and the same bytes written back, so the checksum
+ *  recorded at create time stays valid whatever the file was written with.
+ *  InElapsed covers the writes and the sync, not the read back.  A range
+ *  that is not aligned is written through the page cache, or widened to the
+ *  alignment on a block target whose shared descriptor is always O_DIRECT.
+ *****************************************************************************/
+bool
+FileInfoBlockOverwriteFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t InOffset, uint64_t InLength,
+ uint64_t* InElapsed, uint64_t* InSyncElapsed)
+{
+  int                                   fd;
+  int                                   flags;
+  uint64_t                              total, n, base;
+  uint64_t                              startTime, readTime, syncTime, t;
+  ssize_t                               offset, bytesRead, bytesWritten;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+  bool                                  result;
+
+  if ( InBlock == NULL || InBuffer == NULL ) {
+    return false;
+  }
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  flags = InBuffer->verify ? O_RDWR : O_WRONLY;
+  if ( InBuffer->directIO && InOffset % InBuffer->alignment == 0 && InLength % InBuffer->alignment == 0 ) {
+    flags |= O_DIRECT;
+  }
+  if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_OSYNC ) {
+    flags |= O_SYNC;
+  } else if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_ODSYNC ) {
+    flags |= O_DSYNC;
+  }
+  base = 0;
+  readTime = 0;
+  syncTime = 0;
+  startTime = TimeStampGetMicroseconds();
+  if ( fileInfoBlockTarget ) {
+    fd = fileInfoBlockTarget->fd;
+    base = BlockTargetGetOffset(fileInfoBlockTarget, FileInfoBlockGetIndex(InBlock) - 1);
+    //! The extent is a multiple of the alignment, so the widened range
+    //  stays inside this slot
+    if ( fileInfoBlockTarget->directIO ) {
+      n = InOffset % fileInfoBlockTarget->alignment;
+      InOffset -= n;
+      InLength += n;
+      if ( InLength % fileInfoBlockTarget->alignment ) {
+        InLength += fileInfoBlockTarget->alignment - (InLength % fileInfoBlockTarget->alignment);
+      }
+    }
+  } else {
+    fd = openat(dirFD, name, flags);
+    if ( fd < 0 && (flags & O_DIRECT) && errno == EINVAL ) {
+      fd = openat(dirFD, name, flags & ~O_DIRECT);
+    }
+  }
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not open file %s%s : %s\n", InDirectory, path, strerror(errno));
+    return false;
+  }
+
+  result = true;
+  for ( total = 0 ; result && total < InLength ; total += n ) {
+    n = InLength - total < InBuffer->size ? InLength - total : InBuffer->size;
+    if ( InBuffer->verify ) {
+      t = TimeStampGetMicroseconds();
+      bytesRead = pread(fd, InBuffer->data, n, base + InOffset + total);
+      readTime += TimeStampGetMicroseconds() - t;
+      if ( bytesRead <= 0 ) {
+        if ( bytesRead < 0 ) {
+          fprintf(stderr, "Could not read file %s%s : %s\n", InDirectory, path, strerror(errno));
+        }
+        result = false;
+        break;
+      }
+      n = (uint64_t)bytesRead;
+    }
+    for ( offset = 0 ; offset < (ssize_t)n ; offset += bytesWritten ) {
+      bytesWritten = pwrite(fd, InBuffer->data + offset, n - offset, base + InOffset + total + offset);
+      if ( bytesWritten < 0 ) {
+        if ( errno == EINTR ) {
+          bytesWritten = 0;
+          continue;
+        }
+        fprintf(stderr, "Could not overwrite file %s%s : %s\n", InDirectory, path, strerror(errno));
+        result = false;
+        break;
+      }
+    }
+  }
+  if ( result && (InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC || InBuffer->sync == FILE_INFO_BLOCK_SYNC_FDATASYNC) ) {
+    syncTime = TimeStampGetMicroseconds();
+    if ( (InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC ? fsync(fd) : fdatasync(fd)) ) {
+      fprintf(stderr, "Could not sync file %s%s : %s\n", InDirectory, path, strerror(errno));
+      result = false;
+    }
+    syncTime = TimeStampGetMicroseconds() - syncTime;
+  }
+  if ( NULL == fileInfoBlockTarget ) {
+    close(fd);
+  }
+  if ( InElapsed ) {
+    *InElapsed = TimeStampGetMicroseconds() - startTime - readTime;
+  }
+  if ( InSyncElapsed ) {
+    *InSyncElapsed = syncTime;
+  }
+  return result;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockFillPattern
+ *  The pattern depends only on the slot and its generation so a stale or
+ *  misplaced file is detected as well as a corrupt one
  *****************************************************************************/
 void
+FileInfoBlockFillPattern
+(FileInfoBlock* InBlock, uint8_t* InData, uint32_t InSize)
+{
+  ChecksumFillPattern(InData, InSize, FileInfoBlockGetPatternSeed(InBlock));
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockGetPatternSeed
+ *****************************************************************************/
+static uint64_t
+FileInfoBlockGetPatternSeed
+(FileInfoBlock* InBlock)
+{
+  uint64_t                              seed;
+
+  seed = ((uint64_t)FileInfoBlockGetIndex(InBlock) << 32) | InBlock->generation;
+  return seed * 0x9E3779B97F4A7C15ULL;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockAppendOpen
+ *  Starts growing InBlock, whose filesize is the size it grows to.  Appends
+ *  go through the page cache like the logs they stand in for, O_DIRECT is
+ *  not used.
+ *****************************************************************************/
+bool
+FileInfoBlockAppendOpen
+(FileInfoBlockAppender* InAppender, FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer)
+{
+  int                                   flags;
+  char*                                 name;
+  int                                   dirFD;
+
+  if ( InAppender == NULL || InBlock == NULL || InBuffer == NULL ) {
+    return false;
+  }
+  flags = O_WRONLY | O_CREAT | O_TRUNC | O_APPEND;
+  if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_OSYNC ) {
+    flags |= O_SYNC;
+  } else if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_ODSYNC ) {
+    flags |= O_DSYNC;
+  }
+  InAppender->directory = InDirectory;
+  dirFD = FileInfoBlockResolve(InBlock, InAppender->path, &name);
+  InAppender->fd = openat(dirFD, name, flags, 0644);
+  if ( InAppender->fd < 0 ) {
+    fprintf(stderr, "Could not create file %s%s : %s\n", InDirectory, InAppender->path, strerror(errno));
+    return false;
+  }
+  InAppender->block   = InBlock;
+  InAppender->written = 0;
+  ChecksumInit(&(InAppender->checksum));
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockAppendChunk
+ *  Appends up to InChunkSize bytes and returns the number appended, or -1 on
+ *  a write error.  The pattern is seeded by the offset so each append is
+ *  different.
+ *****************************************************************************/
+int64_t
+FileInfoBlockAppendChunk
+(FileInfoBlockAppender* InAppender, FileInfoBlockBuffer* InBuffer, uint32_t InChunkSize, uint64_t* InElapsed)
+{
+  uint64_t                              n, startTime;
+  ssize_t                               offset, bytesWritten;
+
+  n = InAppender->block->filesize - InAppender->written;
+  if ( n > InChunkSize ) {
+    n = InChunkSize;
+  }
+  if ( n > InBuffer->size ) {
+    n = InBuffer->size;
+  }
+  if ( InBuffer->verify ) {
+    ChecksumFillPattern(InBuffer->data, (uint32_t)n,
+                        FileInfoBlockGetPatternSeed(InAppender->block) + InAppender->written);
+  }
+  startTime = TimeStampGetMicroseconds();
+  for ( offset = 0 ; offset < (ssize_t)n ; offset += bytesWritten ) {
+    bytesWritten = write(InAppender->fd, InBuffer->data + offset, n - offset);
+    if ( bytesWritten < 0 ) {
+      if ( errno == EINTR ) {
+        bytesWritten = 0;
+        continue;
+      }
+      fprintf(stderr, "Could not append to file %s%s : %s\n", InAppender->directory, InAppender->path,
+              strerror(errno));
+      return -1;
+    }
+  }
+  if ( InElapsed ) {
+    *InElapsed = TimeStampGetMicroseconds() - startTime;
+  }
+  if ( InBuffer->verify ) {
+    ChecksumUpdate(&(InAppender->checksum), InBuffer->data, n);
+  }
+  InAppender->written += n;
+  return (int64_t)n;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockAppendClose
+ *  Syncs the file per the sync policy, counts its allocated extents in
+ *  InExtents and those still in delayed allocation in InPending, and
+ *  closes it
+ *****************************************************************************/
+bool
+FileInfoBlockAppendClose
+(FileInfoBlockAppender* InAppender, FileInfoBlockBuffer* InBuffer, uint64_t* InSyncElapsed, uint32_t* InExtents,
+ uint32_t* InPending)
+{
+  uint64_t                              syncTime;
+  bool                                  result;
+
+  result = true;
+  syncTime = 0;
+  if ( InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC || InBuffer->sync == FILE_INFO_BLOCK_SYNC_FDATASYNC ) {
+    syncTime = TimeStampGetMicroseconds();
+    if ( (InBuffer->sync == FILE_INFO_BLOCK_SYNC_FSYNC ? fsync(InAppender->fd) : fdatasync(InAppender->fd)) ) {
+      fprintf(stderr, "Could not sync file %s%s : %s\n", InAppender->directory, InAppender->path,
+              strerror(errno));
+      result = false;
+    }
+    syncTime = TimeStampGetMicroseconds() - syncTime;
+  }
+  if ( InSyncElapsed ) {
+    *InSyncElapsed = syncTime;
+  }
+  if ( InExtents && InPending ) {
+    *InExtents = FileInfoBlockGetExtentCount(InAppender->fd, InPending);
+  }
+  close(InAppender->fd);
+  InAppender->fd = -1;
+  if ( InBuffer->verify ) {
+    FileInfoBlockSetChecksum(InAppender->block, ChecksumFinal(&(InAppender->checksum)));
+  }
+  return result && InAppender->written >= InAppender->block->filesize;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockGetExtentCount
+ *  The file is not flushed first, that would override the sync policy.
+ *  Ranges still waiting on delayed allocation have no blocks yet and the
+ *  file system maps them however it likes, so they are returned apart in
+ *  InPending.  Returns the allocated extents, 0 and 0 pending when the file
+ *  system does not support FIEMAP.
+ *****************************************************************************/
+static uint32_t
+FileInfoBlockGetExtentCount
+(int InFD, uint32_t* InPending)
+{
+  struct {
+    struct fiemap                       map;
+    struct fiemap_extent                extents[FILE_INFO_BLOCK_FIEMAP_BATCH];
+  }                                     fiemap;
+  struct fiemap_extent*                 extent;
+  uint64_t                              start;
+  uint32_t                              i, allocated;
+
+  allocated = 0;
+  *InPending = 0;
+  start = 0;
+  do {
+    memset(&fiemap, 0x00, sizeof(fiemap));
+    fiemap.map.fm_start        = start;
+    fiemap.map.fm_length       = FIEMAP_MAX_OFFSET - start;
+    fiemap.map.fm_flags        = 0;
+    fiemap.map.fm_extent_count = FILE_INFO_BLOCK_FIEMAP_BATCH;
+    if ( ioctl(InFD, FS_IOC_FIEMAP, &(fiemap.map)) ) {
+      *InPending = 0;
+      return 0;
+    }
+    extent = NULL;
+    for ( i = 0 ; i < fiemap.map.fm_mapped_extents ; i++ ) {
+      extent = &(fiemap.map.fm_extents[i]);
+      if ( extent->fe_flags & FIEMAP_EXTENT_DELALLOC ) {
+        (*InPending)++;
+      } else {
+        allocated++;
+      }
+    }
+    if ( NULL == extent ) {
+      break;
+    }
+    start = extent->fe_logical + extent->fe_length;
+  } while ( !(extent->fe_flags & FIEMAP_EXTENT_LAST) );
+  return allocated;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockComputeChecksum
+ *  Checksum of a file made of InData repeated every InChunkSize bytes
+ *****************************************************************************/
+uint32_t
+FileInfoBlockComputeChecksum
+(uint8_t* InData, uint32_t InChunkSize, uint64_t InFileSize)
+{
+  Checksum                              checksum;
+  uint64_t                              n;
+
+  ChecksumInit(&checksum);
+  while ( InFileSize > 0 ) {
+    n = InFileSize < InChunkSize ? InFileSize : InChunkSize;
+    ChecksumUpdate(&checksum, InData, n);
+    InFileSize -= n;
+  }
+  return ChecksumFinal(&checksum);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockResolve
+ *  Fills InPath with InBlock's path relative to the stress directory and
+ *  returns the directory descriptor to open or unlink *InName against.  The
+ *  name is composed straight into InPath, nothing is allocated.
+ *****************************************************************************/
+int
+FileInfoBlockResolve
+(FileInfoBlock* InBlock, char* InPath, char** InName)
+{
+  int64_t                               index;
+  int                                   i;
+
+  index = FileInfoBlockGetIndex(InBlock);
+  i = FileInfoBlockGetNamespace(index);
+  return FileNamespaceResolve(fileInfoBlockNamespaces[i], (uint64_t)index, fileInfoBlockPrefix, InPath, InName);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockGetNamespace
+ *  The stress directory owning block InIndex, -1 before any are added
+ *****************************************************************************/
+static int
+FileInfoBlockGetNamespace
+(int64_t InIndex)
+{
+  int                                   i;
+
+  i = fileInfoBlockNamespaceCount - 1;
+  while ( i > 0 && fileInfoBlockNamespaceFirst[i] >= InIndex ) {
+    i--;
+  }
+  return i;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockBufferCreate
+ *  The data is always aligned, so switching to O_DIRECT only needs the size
+ *  rounded up to the alignment
+ *****************************************************************************/
+FileInfoBlockBuffer*
+FileInfoBlockBufferCreate
+(uint32_t InSize, uint32_t InAlignment, bool InDirectIO, bool InVerify, FileInfoBlockSync InSync)
+{
+  FileInfoBlockBuffer*                  buffer;
+  void*                                 data;
+  uint32_t                              size;
+
+  if ( InSize == 0 ) {
+    return NULL;
+  }
+  if ( InAlignment == 0 ) {
+    InAlignment = FILE_INFO_BLOCK_DEFAULT_ALIGNMENT;
+  }
+  size = InSize;
+  if ( InDirectIO && size % InAlignment ) {
+    size += InAlignment - (size % InAlignment);
+  }
+  if ( posix_memalign(&data, InAlignment, size) ) {
+    return NULL;
+  }
+  buffer = (FileInfoBlockBuffer*)GetMemory(sizeof(FileInfoBlockBuffer));
+  buffer->data = (uint8_t*)data;
+  buffer->size = size;
+  buffer->alignment = InAlignment;
+  buffer->directIO = InDirectIO;
+  buffer->verify = InVerify;
+  buffer->sync = InSync;
+  memset(buffer->data, ' ', size);
+  return buffer;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockBufferDestroy
+ *****************************************************************************/
+void
+FileInfoBlockBufferDestroy
+(FileInfoBlockBuffer* InBuffer)
+{
+  if ( NULL == InBuffer ) {
+    return;
+  }
+  free(InBuffer->data);
+  FreeMemory(InBuffer);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockRemoveFile
+ *****************************************************************************/
+bool
 FileInfoBlockRemoveFile
 (FileInfoBlock* InBlock, string InDirectory)
 {
-  char									filename[32];
-  string                                s;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
 
   if ( NULL == InBlock ) {
-	return;
+	return false;
   }
 
-  if ( InBlock->filesize == 0 ) {
-	return;
+  if ( !FileInfoBlockIsOccupied(InBlock) ) {
+	return false;
   }
 
-  sprintf(filename, "%s%08d", fileInfoBlockPrefix, InBlock->index);
-  s = StringConcat(InDirectory, filename);
-  if ( unlink(s) ) {
-    fprintf(stderr, "Could not remove file %s : %s\n", s, strerror(errno));
+  if ( fileInfoBlockTarget ) {
+    return BlockTargetReleaseExtent(fileInfoBlockTarget,
+                                    BlockTargetGetOffset(fileInfoBlockTarget, FileInfoBlockGetIndex(InBlock) - 1),
+                                    InBlock->filesize);
   }
-  FreeMemory(s);
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  if ( unlinkat(dirFD, name, 0) ) {
+    fprintf(stderr, "Could not remove file %s%s : %s\n", InDirectory, path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockCreateEmptyFile
+ *  Creates InBlock's file with no data, a create and a close
+ *****************************************************************************/
+bool
+FileInfoBlockCreateEmptyFile
+(FileInfoBlock* InBlock, string InDirectory)
+{
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD, fd;
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  fd = openat(dirFD, name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if ( fd < 0 ) {
+    fprintf(stderr, "Could not create file %s%s : %s\n", InDirectory, path, strerror(errno));
+    return false;
+  }
+  close(fd);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockStatFile
+ *****************************************************************************/
+bool
+FileInfoBlockStatFile
+(FileInfoBlock* InBlock, string InDirectory)
+{
+  struct stat                           statbuf;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  if ( fstatat(dirFD, name, &statbuf, 0) ) {
+    fprintf(stderr, "Could not stat file %s%s : %s\n", InDirectory, path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockRenameFile
+ *  Moves InFrom's file to InTo's name, across directories when the files
+ *  are fanned out
+ *****************************************************************************/
+bool
+FileInfoBlockRenameFile
+(FileInfoBlock* InFrom, FileInfoBlock* InTo, string InDirectory)
+{
+  char                                  fromPath[FILE_NAMESPACE_PATH_SIZE];
+  char                                  toPath[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 fromName;
+  char*                                 toName;
+  int                                   fromFD, toFD;
+
+  fromFD = FileInfoBlockResolve(InFrom, fromPath, &fromName);
+  toFD   = FileInfoBlockResolve(InTo, toPath, &toName);
+  if ( renameat(fromFD, fromName, toFD, toName) ) {
+    fprintf(stderr, "Could not rename file %s%s to %s : %s\n", InDirectory, fromPath, toPath, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockSetAttributes
+ *  Changes the file's mode to InMode, or sets its times to now when InMode
+ *  is 0
+ *****************************************************************************/
+bool
+FileInfoBlockSetAttributes
+(FileInfoBlock* InBlock, string InDirectory, mode_t InMode)
+{
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD, n;
+
+  dirFD = FileInfoBlockResolve(InBlock, path, &name);
+  if ( InMode ) {
+    n = fchmodat(dirFD, name, InMode, 0);
+  } else {
+    n = utimensat(dirFD, name, NULL, 0);
+  }
+  if ( n ) {
+    fprintf(stderr, "Could not set the %s of file %s%s : %s\n", InMode ? "mode" : "times",
+            InDirectory, path, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockSetTarget
+ *****************************************************************************/
+void
+FileInfoBlockSetTarget
+(BlockTarget* InTarget)
+{
+  fileInfoBlockTarget = InTarget;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockGetTarget
+ *****************************************************************************/
+BlockTarget*
+FileInfoBlockGetTarget
+()
+{
+  return fileInfoBlockTarget;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockAddNamespace
+ *  Slots from InFirstIndex (0 based) on live in InNamespace, add them in
+ *  increasing order of InFirstIndex
+ *****************************************************************************/
+bool
+FileInfoBlockAddNamespace
+(FileNamespace* InNamespace, int64_t InFirstIndex)
+{
+  if ( fileInfoBlockNamespaceCount == FILE_INFO_BLOCK_NAMESPACES_MAX ) {
+    return false;
+  }
+  fileInfoBlockNamespaces[fileInfoBlockNamespaceCount]     = InNamespace;
+  fileInfoBlockNamespaceFirst[fileInfoBlockNamespaceCount] = InFirstIndex;
+  fileInfoBlockNamespaceCount++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockAddRange
+ *  [InFirst, InLast) is searched often enough, a worker's slice, to keep
+ *  its occupied count as it changes.  Ranges must not overlap.
+ *****************************************************************************/
+void
+FileInfoBlockAddRange
+(int64_t InFirst, int64_t InLast)
+{
+  if ( NULL == fileInfoBlockOccupied ) {
+    return;
+  }
+  SlotBitmapAddRange(fileInfoBlockOccupied, (uint64_t)InFirst, (uint64_t)InLast);
+}
+
+/*****************************************************************************!
+ * Function : FileInfoBlockGetPrefix
+ *****************************************************************************/
+string
+FileInfoBlockGetPrefix
+()
+{
+  return fileInfoBlockPrefix;
 }
 
 /*****************************************************************************!
@@ -372,82 +1328,75 @@ FileInfoBlockRemoveFile
  *****************************************************************************/
 void
 FileInfoBlockSetGetMap
-(int* InMapSize, uint64_t** InMap)
+(int64_t* InMapSize, uint64_t** InMap)
 {
-  int                                   i, size;
-  int                                   bitIndex, byteIndex;
-  int                                   byteCount;
+  int64_t                               i, wordCount;
   uint64_t*                             map;
-  uint64_t                              b;
-  
-  byteCount = fileInfoBlockSetSize / 64;
-  if ( fileInfoBlockSetSize % 64 > 0 ) {
-	byteCount++;
-  }
-
-  size = sizeof(uint64_t) * byteCount; 
-  map = (uint64_t*)GetMemory(size);
-  memset(map, 0x00, size);
-  bitIndex = 0;
-  byteIndex = 0;
-  b = 0;
 
-  for ( i = 0 ; i < fileInfoBlockSetSize ; i++ ) {
-    if ( fileInfoBlockSet[i].filesize > 0 ) {
-      b |= (1 << bitIndex); 
-    }
-	bitIndex++;
-	if ( bitIndex == 64 ) {
-	  map[byteIndex] = b;
-	  byteIndex++;
-	  bitIndex = 0;
-	  b = 0;
-	}
-  }
-  if ( bitIndex > 0 ) {
-	map[byteIndex] = b;
-	byteIndex++;
+  wordCount = (fileInfoBlockSetSize + SLOT_BITMAP_WORD_BITS - 1) / SLOT_BITMAP_WORD_BITS;
+  map = (uint64_t*)GetMemory(sizeof(uint64_t) * (wordCount + 1));
+  for ( i = 0 ; i < wordCount ; i++ ) {
+    map[i] = __atomic_load_n(&(fileInfoBlockOccupied->words[i]), __ATOMIC_RELAXED);
   }
   *InMap = map;
-  *InMapSize= byteIndex;
+  *InMapSize = wordCount;
 }
 
 /*****************************************************************************!
  * 
  *****************************************************************************/
-int
+int64_t
 FileInfoBlockSetGetSize
 ()
 {
   return fileInfoBlockSetSize;
 }
 
+/*****************************************************************************!
+ * Function : FileInfoBlockSetGetMapCells
+ *  Cells in the JSON map, one per slot for a small set
+ *****************************************************************************/
+int
+FileInfoBlockSetGetMapCells
+()
+{
+  return fileInfoBlockSetSize < FILE_INFO_BLOCK_MAP_CELLS ? (int)fileInfoBlockSetSize : FILE_INFO_BLOCK_MAP_CELLS;
+}
+
 /*****************************************************************************!
  * Function : FileInfoBlockSetToJSON 
+ *  The set downsampled to at most FILE_INFO_BLOCK_MAP_CELLS cells of
+ *  slotspercell or one more slots.  A cell is '0' when empty, otherwise '1'
+ *  to '9' by how full it is, rounded up so a single file shows.
  *****************************************************************************/
 JSONOut*
 FileInfoBlockSetToJSON
 ()
 {
   JSONOut*						        jsonOut;
-  int                                   i;
+  int                                   i, cells;
+  int64_t                               first, last;
+  uint64_t                              used;
   string                                s;
 
   jsonOut = JSONOutCreateObject("filemapinfo");
 
-  s = (string)GetMemory(fileInfoBlockSetSize + 1);
+  cells = FileInfoBlockSetGetMapCells();
+  s = (string)GetMemory(cells + 1);
 
-  for ( i  = 0 ; i < fileInfoBlockSetSize ; i ++ ) {
-	if ( fileInfoBlockSet[i].filesize > 0 ) {
-	  s[i] = '1';
-	} else {
-	  s[i] = '0';
-	}
+  for ( i  = 0 ; i < cells ; i ++ ) {
+    first = fileInfoBlockSetSize * i / cells;
+    last  = fileInfoBlockSetSize * (i + 1) / cells;
+    used  = SlotBitmapCount(fileInfoBlockOccupied, first, last, true);
+	s[i] = '0' + (char)((used * 9 + (last - first) - 1) / (last - first));
   }
-  s[fileInfoBlockSetSize] = 0;
+  s[cells] = 0;
 
   JSONOutObjectAddObject(jsonOut, JSONOutCreateString("map", s));
-  JSONOutObjectAddObject(jsonOut, JSONOutCreateInt("mapsize", fileInfoBlockSetSize));
+  FreeMemory(s);
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateInt("mapsize", cells));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("slotspercell", cells ? fileInfoBlockSetSize / cells : 0));
+  JSONOutObjectAddObject(jsonOut, JSONOutCreateLongLong("slots", fileInfoBlockSetSize));
   return jsonOut;
 }
 
@@ -14,31 +14,103 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/types.h>
 
 /*****************************************************************************!
  * Local Headers
  *****************************************************************************/
 #include "GeneralUtilities/String.h"
 #include "JSONOut.h"
+#include "BlockTarget.h"
+#include "Checksum.h"
+#include "FileNamespace.h"
+#include "SlotBitmap.h"
+#include "SlotMemory.h"
+#include "Random.h"
 
 /*****************************************************************************!
  * Exported Macros
  *****************************************************************************/
+#define FILE_INFO_BLOCK_DEFAULT_ALIGNMENT       4096
+
+//! Stress directories sharing the slot set
+#define FILE_INFO_BLOCK_NAMESPACES_MAX          16
+
+//! Largest file a slot can record, filesize is 40 bits
+#define FILE_INFO_BLOCK_FILESIZE_MAX            ((1ULL << 40) - 1)
+
+//! Most cells in the JSON map, larger sets are downsampled to fit
+#define FILE_INFO_BLOCK_MAP_CELLS               4096
 
 /*****************************************************************************!
  * Exported Type : FileInfoBlock
+ *  One slot of the set, packed into 12 bytes since a large target has
+ *  hundreds of millions of them.  The slot number is the block's position
+ *  in the set (FileInfoBlockGetIndex), whether its file exists is kept in
+ *  the set's bitmap (FileInfoBlockIsOccupied), which for the zero length
+ *  files of the metadata workload is not the same as filesize > 0, and the
+ *  checksums are a separate column only allocated when verifying.
+ *  filetime is in seconds since the epoch, generation wraps.
  *****************************************************************************/
-struct _FileInfoBlock
+struct __attribute__((packed, aligned(4))) _FileInfoBlock
 {
-  string                                filename;
-  int									index;
-  time_t                                filetime;
-  uint64_t                              filesize;
-  struct _FileInfoBlock*                next;
-  struct _FileInfoBlock*                prev;
+  uint64_t                              filesize   : 40;
+  uint64_t                              generation : 23;
+  uint64_t                              pending    : 1;
+  uint32_t                              filetime;
 };
 typedef struct _FileInfoBlock FileInfoBlock;
 
+/*****************************************************************************!
+ * Exported Type : FileInfoBlockSync
+ *  Per file durability.  Batched syncs are done by the caller.
+ *****************************************************************************/
+enum _FileInfoBlockSync
+{
+  FILE_INFO_BLOCK_SYNC_NONE,
+  FILE_INFO_BLOCK_SYNC_FSYNC,
+  FILE_INFO_BLOCK_SYNC_FDATASYNC,
+  FILE_INFO_BLOCK_SYNC_OSYNC,
+  FILE_INFO_BLOCK_SYNC_ODSYNC
+};
+typedef enum _FileInfoBlockSync FileInfoBlockSync;
+
+/*****************************************************************************!
+ * Exported Type : FileInfoBlockBuffer
+ *  Reusable write buffer, allocated once per stress thread.  When directIO is
+ *  set the data is aligned and sized to a multiple of alignment so it can be
+ *  written with O_DIRECT.  When verify is set each file is written with its
+ *  own slot/generation pattern and its checksum is kept in the block.
+ *****************************************************************************/
+struct _FileInfoBlockBuffer
+{
+  uint8_t*                              data;
+  uint32_t                              size;
+  uint32_t                              alignment;
+  bool                                  directIO;
+  bool                                  verify;
+  FileInfoBlockSync                     sync;
+};
+typedef struct _FileInfoBlockBuffer FileInfoBlockBuffer;
+
+/*****************************************************************************!
+ * Exported Type : FileInfoBlockAppender
+ *  A file being grown to its filesize by small appends.  The checksum is
+ *  carried from one append to the next so the finished file can be verified
+ *  like one written in one go.  directory and path are where the file was
+ *  opened, for error messages.
+ *****************************************************************************/
+struct _FileInfoBlockAppender
+{
+  FileInfoBlock*                        block;
+  string                                directory;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  int                                   fd;
+  uint64_t                              written;
+  Checksum                              checksum;
+};
+typedef struct _FileInfoBlockAppender FileInfoBlockAppender;
+
 /*****************************************************************************!
  * Exported Data
  *****************************************************************************/
@@ -50,76 +122,178 @@ uint64_t
 FileInfoBlockGetSize
 ();
 
-uint32_t
+uint64_t
 FileInfoBlockGetCount
 ();
 
-FileInfoBlock*
-FileInfoBlockRemoveByName
-(FileInfoBlock* InHead, string InFilename, bool InDestroy);
+uint64_t
+FileInfoBlockGetRangeCount
+(int64_t InFirst, int64_t InLast);
 
 FileInfoBlock*
-FileInfoBlockFindByName
-(FileInfoBlock* InHead, string  InFileName);
-
-void
-FileInfoBlockCreateFile
-(FileInfoBlock* InInfoBlock, string InDirectory);
+FileInfoBlockGetRandomBlock
+(int64_t InFirst, int64_t InLast, bool InOccupied, Random* InRandom);
 
 void
 FileInfoBlockDisplay
 ();
 
-FileInfoBlock*
-FileInfoBlockRemove
-(FileInfoBlock* InHead, FileInfoBlock* InInfoBlock, bool InDestroy);
+void
+FileInfoBlockSetCreate
+(int64_t InSetSize, bool InChecksums);
 
-FileInfoBlock*
-FileInfoBlockAppend
-(FileInfoBlock* InHead, FileInfoBlock* InInfoBlock);
+uint64_t
+FileInfoBlockSetGetMemory
+();
 
 void
-FileInfoBlockDestroy
-(FileInfoBlock* InInfoBlock);
+FileInfoBlockSetUpdateResident
+();
 
-FileInfoBlock*
-FileInfoBlockCreate
-(string InFilename, uint64_t InFileSize);
+uint64_t
+FileInfoBlockSetGetResident
+();
 
-void
-FileInfoBlockSetCreate
-(int InSetSize);
+int64_t
+FileInfoBlockGetIndex
+(FileInfoBlock* InBlock);
+
+bool
+FileInfoBlockIsOccupied
+(FileInfoBlock* InBlock);
+
+uint32_t
+FileInfoBlockGetChecksum
+(FileInfoBlock* InBlock);
 
 void
+FileInfoBlockSetChecksum
+(FileInfoBlock* InBlock, uint32_t InChecksum);
+
+bool
 FileInfoBlockRemoveFile
 (FileInfoBlock* InBlock, string InDirectory);
 
-void
-FileInfoBlockCreateFile
+bool
+FileInfoBlockCreateEmptyFile
 (FileInfoBlock* InBlock, string InDirectory);
 
+bool
+FileInfoBlockStatFile
+(FileInfoBlock* InBlock, string InDirectory);
+
+bool
+FileInfoBlockRenameFile
+(FileInfoBlock* InFrom, FileInfoBlock* InTo, string InDirectory);
+
+bool
+FileInfoBlockSetAttributes
+(FileInfoBlock* InBlock, string InDirectory, mode_t InMode);
+
+bool
+FileInfoBlockCreateFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t* InElapsed, uint64_t* InSyncElapsed);
+
+bool
+FileInfoBlockOverwriteFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t InOffset, uint64_t InLength,
+ uint64_t* InElapsed, uint64_t* InSyncElapsed);
+
+bool
+FileInfoBlockAppendOpen
+(FileInfoBlockAppender* InAppender, FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer);
+
+int64_t
+FileInfoBlockAppendChunk
+(FileInfoBlockAppender* InAppender, FileInfoBlockBuffer* InBuffer, uint32_t InChunkSize, uint64_t* InElapsed);
+
+bool
+FileInfoBlockAppendClose
+(FileInfoBlockAppender* InAppender, FileInfoBlockBuffer* InBuffer, uint64_t* InSyncElapsed, uint32_t* InExtents,
+ uint32_t* InPending);
+
+FileInfoBlockBuffer*
+FileInfoBlockBufferCreate
+(uint32_t InSize, uint32_t InAlignment, bool InDirectIO, bool InVerify, FileInfoBlockSync InSync);
+
+bool
+FileInfoBlockVerifyFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t* InElapsed, uint32_t* InChecksum);
+
+int64_t
+FileInfoBlockReadFile
+(FileInfoBlock* InBlock, string InDirectory, FileInfoBlockBuffer* InBuffer, uint64_t InOffset, uint64_t InLength, uint64_t* InElapsed);
+
+void
+FileInfoBlockFillPattern
+(FileInfoBlock* InBlock, uint8_t* InData, uint32_t InSize);
+
+uint32_t
+FileInfoBlockComputeChecksum
+(uint8_t* InData, uint32_t InChunkSize, uint64_t InFileSize);
+
+void
+FileInfoBlockBufferDestroy
+(FileInfoBlockBuffer* InBuffer);
+
 void
 FileInfoBlockClearBlock
 (FileInfoBlock* InBlock);
 
+void
+FileInfoBlockSetFileSize
+(FileInfoBlock* InBlock, uint64_t InSize);
+
+void
+FileInfoBlockSetEmptyBlock
+(FileInfoBlock* InBlock);
+
 void
 FileInfoBlockSetBlock
-(FileInfoBlock* InBlock, int InSize);
+(FileInfoBlock* InBlock, uint64_t InSize);
 
 FileInfoBlock*
 FileInfoBlockGetBlock
-(int InIndex);
+(int64_t InIndex);
 
 void
 FileInfoBlockSetGetMap
-(int* InMapSize, uint64_t** InMap);
+(int64_t* InMapSize, uint64_t** InMap);
 
-int
+int64_t
 FileInfoBlockSetGetSize
 ();
 
+int
+FileInfoBlockSetGetMapCells
+();
+
 JSONOut*
 FileInfoBlockSetToJSON
 ();
 
+void
+FileInfoBlockSetTarget
+(BlockTarget* InTarget);
+
+BlockTarget*
+FileInfoBlockGetTarget
+();
+
+bool
+FileInfoBlockAddNamespace
+(FileNamespace* InNamespace, int64_t InFirstIndex);
+
+void
+FileInfoBlockAddRange
+(int64_t InFirst, int64_t InLast);
+
+string
+FileInfoBlockGetPrefix
+();
+
+int
+FileInfoBlockResolve
+(FileInfoBlock* InBlock, char* InPath, char** InName);
+
 #endif /* _fileinfoblock_h_*/
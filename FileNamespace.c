@@ -0,0 +1,339 @@
+/*****************************************************************************
+ * FILE NAME    : FileNamespace.c
+ * DATE         : January 22 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "FileNamespace.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! Descriptors left for files, sockets and the log when leaves are cached
+#define FILE_NAMESPACE_FD_RESERVE       1024
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static int
+FileNamespaceGetSubdirectory
+(FileNamespace* InNamespace, uint32_t InLeaf, int InLevels, char* InPath);
+
+static void
+FileNamespaceCacheDirectories
+(FileNamespace* InNamespace);
+
+static int
+FileNamespaceFormatIndex
+(uint64_t InIndex, char* InText);
+
+/*****************************************************************************!
+ * Function : FileNamespaceParse
+ *  <levels>:<width>, 2:256 is two levels of 256 directories
+ *****************************************************************************/
+bool
+FileNamespaceParse
+(string InSpec, int* InLevels, int* InWidth)
+{
+  int                                   levels, width, level;
+  uint64_t                              count;
+  char                                  c;
+
+  if ( sscanf(InSpec, "%d:%d%c", &levels, &width, &c) != 2 ) {
+    return false;
+  }
+  if ( levels < 0 || levels > FILE_NAMESPACE_MAX_LEVELS || width < 2 || width > FILE_NAMESPACE_MAX_WIDTH ) {
+    return false;
+  }
+  count = 1;
+  for ( level = 0 ; level < levels ; level++ ) {
+    count *= width;
+  }
+  if ( count > FILE_NAMESPACE_MAX_DIRECTORIES ) {
+    return false;
+  }
+  *InLevels = levels;
+  *InWidth  = width;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceCreate
+ *  Opens InDirectory, creating it if needed, and creates every subdirectory
+ *  up front so the stress operations never have to
+ *****************************************************************************/
+FileNamespace*
+FileNamespaceCreate
+(string InDirectory, int InLevels, int InWidth)
+{
+  FileNamespace*                        ns;
+  int                                   rootFD, level, digits;
+  uint32_t                              n, count;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+
+  rootFD = open(InDirectory, O_PATH | O_DIRECTORY);
+  if ( rootFD < 0 && errno == ENOENT && mkdir(InDirectory, 0755) == 0 ) {
+    rootFD = open(InDirectory, O_PATH | O_DIRECTORY);
+  }
+  if ( rootFD < 0 ) {
+    fprintf(stderr, "Could not open directory %s : %s\n", InDirectory, strerror(errno));
+    return NULL;
+  }
+
+  ns = (FileNamespace*)GetMemory(sizeof(FileNamespace));
+  memset(ns, 0x00, sizeof(FileNamespace));
+  ns->directory = StringCopy(InDirectory);
+  ns->rootFD    = rootFD;
+  ns->levels    = InLevels;
+  ns->width     = InWidth;
+  ns->dirCount  = 1;
+
+  for ( digits = 1 ; (1 << (4 * digits)) < InWidth ; digits++ ) {
+  }
+  ns->digits = digits;
+
+  count = 1;
+  for ( level = 1 ; level <= InLevels ; level++ ) {
+    count *= (uint32_t)InWidth;
+    for ( n = 0 ; n < count ; n++ ) {
+      FileNamespaceGetSubdirectory(ns, n, level, path);
+      if ( mkdirat(rootFD, path, 0755) && errno != EEXIST ) {
+        fprintf(stderr, "Could not create directory %s%s : %s\n", InDirectory, path, strerror(errno));
+        FileNamespaceDestroy(ns);
+        return NULL;
+      }
+    }
+  }
+  ns->dirCount = count;
+  if ( InLevels > 0 ) {
+    FileNamespaceCacheDirectories(ns);
+  }
+  return ns;
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceDestroy
+ *****************************************************************************/
+void
+FileNamespaceDestroy
+(FileNamespace* InNamespace)
+{
+  uint32_t                              i;
+
+  if ( NULL == InNamespace ) {
+    return;
+  }
+  if ( InNamespace->dirFDs ) {
+    for ( i = 0 ; i < InNamespace->dirCount ; i++ ) {
+      close(InNamespace->dirFDs[i]);
+    }
+    FreeMemory(InNamespace->dirFDs);
+  }
+  close(InNamespace->rootFD);
+  FreeMemory(InNamespace->directory);
+  FreeMemory(InNamespace);
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceCacheDirectories
+ *  Raises the descriptor limit as far as the hard limit allows.  When every
+ *  leaf still does not fit, paths are resolved from the top directory.
+ *****************************************************************************/
+static void
+FileNamespaceCacheDirectories
+(FileNamespace* InNamespace)
+{
+  struct rlimit                         limit;
+  rlim_t                                need;
+  uint32_t                              i, j;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+
+  need = (rlim_t)InNamespace->dirCount + FILE_NAMESPACE_FD_RESERVE;
+  if ( getrlimit(RLIMIT_NOFILE, &limit) ) {
+    return;
+  }
+  if ( limit.rlim_cur < need ) {
+    limit.rlim_cur = limit.rlim_max < need ? limit.rlim_max : need;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+  }
+  if ( limit.rlim_cur < need ) {
+    fprintf(stderr, "Not enough descriptors for %d directories : resolving from %s\n",
+            InNamespace->dirCount, InNamespace->directory);
+    return;
+  }
+
+  InNamespace->dirFDs = (int*)GetMemory(sizeof(int) * InNamespace->dirCount);
+  for ( i = 0 ; i < InNamespace->dirCount ; i++ ) {
+    FileNamespaceGetSubdirectory(InNamespace, i, InNamespace->levels, path);
+    InNamespace->dirFDs[i] = openat(InNamespace->rootFD, path, O_PATH | O_DIRECTORY);
+    if ( InNamespace->dirFDs[i] < 0 ) {
+      for ( j = 0 ; j < i ; j++ ) {
+        close(InNamespace->dirFDs[j]);
+      }
+      FreeMemory(InNamespace->dirFDs);
+      InNamespace->dirFDs = NULL;
+      return;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceGetSubdirectory
+ *  Writes the first InLevels directory names of leaf InLeaf, each followed
+ *  by a '/', and returns the length.  Runs for every operation, so the
+ *  digits are written directly rather than through sprintf.
+ *****************************************************************************/
+static int
+FileNamespaceGetSubdirectory
+(FileNamespace* InNamespace, uint32_t InLeaf, int InLevels, char* InPath)
+{
+  static const char                     hex[] = "0123456789abcdef";
+  int                                   level, n, d;
+  uint32_t                              part;
+
+  n = 0;
+  for ( level = 0 ; level < InLevels ; level++ ) {
+    part = InLeaf % InNamespace->width;
+    for ( d = InNamespace->digits - 1 ; d >= 0 ; d-- ) {
+      InPath[n + d] = hex[part & 0x0F];
+      part >>= 4;
+    }
+    n += InNamespace->digits;
+    InPath[n++] = '/';
+    InLeaf /= InNamespace->width;
+  }
+  InPath[n] = 0x00;
+  return n;
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceFormatIndex
+ *  Writes InIndex in decimal, zero padded to FILE_NAMESPACE_INDEX_DIGITS,
+ *  and returns the length.  InText is not terminated.
+ *****************************************************************************/
+static int
+FileNamespaceFormatIndex
+(uint64_t InIndex, char* InText)
+{
+  char                                  digits[24];
+  int                                   n, i;
+
+  n = 0;
+  do {
+    digits[n++] = '0' + (char)(InIndex % 10);
+    InIndex /= 10;
+  } while ( InIndex );
+  while ( n < FILE_NAMESPACE_INDEX_DIGITS ) {
+    digits[n++] = '0';
+  }
+  for ( i = 0 ; i < n ; i++ ) {
+    InText[i] = digits[n - 1 - i];
+  }
+  return n;
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceResolve
+ *  Fills InPath with the path of file InIndex, named InPrefix followed by
+ *  the index, relative to the top directory and returns the descriptor to
+ *  use it with.  InLeaf points at the part of InPath to pass to
+ *  openat()/unlinkat() with that descriptor, just the name when the leaf
+ *  directory is cached.  InPath is the caller's, so resolving allocates
+ *  nothing and only the leaf is looked up by the kernel.
+ *****************************************************************************/
+int
+FileNamespaceResolve
+(FileNamespace* InNamespace, uint64_t InIndex, string InPrefix, char* InPath, char** InLeaf)
+{
+  uint32_t                              leaf;
+  size_t                                prefixLength;
+  char*                                 name;
+  char*                                 end;
+
+  leaf = (uint32_t)(InIndex % InNamespace->dirCount);
+  name = InPath + FileNamespaceGetSubdirectory(InNamespace, leaf, InNamespace->levels, InPath);
+  prefixLength = strlen(InPrefix);
+  memcpy(name, InPrefix, prefixLength);
+  end = name + prefixLength;
+  end += FileNamespaceFormatIndex(InIndex, end);
+  *end = 0x00;
+  if ( InNamespace->dirFDs ) {
+    *InLeaf = name;
+    return InNamespace->dirFDs[leaf];
+  }
+  *InLeaf = InPath;
+  return InNamespace->rootFD;
+}
+
+/*****************************************************************************!
+ * Function : FileNamespaceClean
+ *  Removes the files starting with InPrefix from every leaf directory and
+ *  returns how many there were.  The directories themselves are kept.
+ *****************************************************************************/
+uint32_t
+FileNamespaceClean
+(FileNamespace* InNamespace, string InPrefix)
+{
+  DIR*                                  dir;
+  struct dirent*                        entry;
+  uint32_t                              i, removed;
+  int                                   fd;
+  size_t                                prefixLength;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+
+  removed = 0;
+  prefixLength = strlen(InPrefix);
+  for ( i = 0 ; i < InNamespace->dirCount ; i++ ) {
+    //! The cached descriptors are O_PATH, reading a directory needs its own
+    if ( InNamespace->dirFDs ) {
+      fd = openat(InNamespace->dirFDs[i], ".", O_RDONLY | O_DIRECTORY);
+    } else {
+      FileNamespaceGetSubdirectory(InNamespace, i, InNamespace->levels, path);
+      fd = openat(InNamespace->rootFD, InNamespace->levels ? path : ".", O_RDONLY | O_DIRECTORY);
+    }
+    if ( fd < 0 ) {
+      continue;
+    }
+    dir = fdopendir(fd);
+    if ( NULL == dir ) {
+      close(fd);
+      continue;
+    }
+    rewinddir(dir);
+    for ( entry = readdir(dir) ; entry ; entry = readdir(dir) ) {
+      if ( strncmp(entry->d_name, InPrefix, prefixLength) ) {
+        continue;
+      }
+      if ( unlinkat(dirfd(dir), entry->d_name, 0) == 0 ) {
+        removed++;
+      }
+    }
+    closedir(dir);
+  }
+  return removed;
+}
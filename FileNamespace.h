@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * FILE NAME    : FileNamespace.h
+ * DATE         : January 22 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _filenamespace_h_
+#define _filenamespace_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define FILE_NAMESPACE_MAX_LEVELS       3
+#define FILE_NAMESPACE_MAX_WIDTH        4096
+#define FILE_NAMESPACE_MAX_DIRECTORIES  (1024 * 1024)
+
+//! Room for the subdirectories and a file name relative to the top directory
+#define FILE_NAMESPACE_PATH_SIZE        64
+
+//! File names carry the index in at least this many digits
+#define FILE_NAMESPACE_INDEX_DIGITS     8
+
+/*****************************************************************************!
+ * Exported Type : FileNamespace
+ *  The directories the stress files live in.  With levels 0 every file is
+ *  in the top directory, otherwise slot n goes in the leaf directory
+ *  n % dirCount, named by its base width digits, lowest first, so
+ *  neighbouring slots land in different directories.  dirFDs holds an open
+ *  descriptor for every leaf when the descriptor limit allows it.  rootFD
+ *  and dirFDs are O_PATH descriptors, only good as the directory argument
+ *  of the *at() calls.
+ *****************************************************************************/
+struct _FileNamespace
+{
+  string                                directory;
+  int                                   rootFD;
+  int                                   levels;
+  int                                   width;
+  int                                   digits;
+  uint32_t                              dirCount;
+  int*                                  dirFDs;
+};
+typedef struct _FileNamespace FileNamespace;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+bool
+FileNamespaceParse
+(string InSpec, int* InLevels, int* InWidth);
+
+FileNamespace*
+FileNamespaceCreate
+(string InDirectory, int InLevels, int InWidth);
+
+void
+FileNamespaceDestroy
+(FileNamespace* InNamespace);
+
+int
+FileNamespaceResolve
+(FileNamespace* InNamespace, uint64_t InIndex, string InPrefix, char* InPath, char** InLeaf);
+
+uint32_t
+FileNamespaceClean
+(FileNamespace* InNamespace, string InPrefix);
+
+#endif // _filenamespace_h_
@@ -0,0 +1,381 @@
+/*****************************************************************************
+ * FILE NAME    : FileSizeDistribution.c
+ * DATE         : January 11 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "FileSizeDistribution.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! Log-normal samples are cut off this many standard deviations above the median
+#define FILE_SIZE_DISTRIBUTION_LOGNORMAL_TAIL   4.0
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static bool
+FileSizeDistributionParseSize
+(char** InText, uint64_t* InSize);
+
+static bool
+FileSizeDistributionParse
+(FileSizeDistribution* InDistribution, char* InText);
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionCreate
+ *  InSpec is one of
+ *    fixed:<size>
+ *    uniform:<min>-<max>
+ *    lognormal:<median>,<sigma>
+ *    bimodal:<small>,<large>,<large percent>
+ *    table:<size>:<weight>,<size>:<weight>...
+ *  Sizes take an optional k, m or g suffix.  Returns NULL when InSpec can
+ *  not be parsed.
+ *****************************************************************************/
+FileSizeDistribution*
+FileSizeDistributionCreate
+(string InSpec)
+{
+  FileSizeDistribution*                 distribution;
+
+  if ( NULL == InSpec ) {
+    return NULL;
+  }
+  distribution = (FileSizeDistribution*)GetMemory(sizeof(FileSizeDistribution));
+  memset(distribution, 0x00, sizeof(FileSizeDistribution));
+  if ( !FileSizeDistributionParse(distribution, InSpec) ) {
+    FreeMemory(distribution);
+    return NULL;
+  }
+  distribution->spec = StringCopy(InSpec);
+  return distribution;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionDestroy
+ *****************************************************************************/
+void
+FileSizeDistributionDestroy
+(FileSizeDistribution* InDistribution)
+{
+  if ( NULL == InDistribution ) {
+    return;
+  }
+  FreeMemory(InDistribution->spec);
+  FreeMemory(InDistribution);
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionParse
+ *****************************************************************************/
+static bool
+FileSizeDistributionParse
+(FileSizeDistribution* InDistribution, char* InText)
+{
+  uint64_t                              size, weight;
+  char*                                 end;
+
+  if ( strncmp(InText, "fixed:", 6) == 0 ) {
+    InText += 6;
+    InDistribution->type = FILE_SIZE_DISTRIBUTION_FIXED;
+    if ( !FileSizeDistributionParseSize(&InText, &size) || *InText ) {
+      return false;
+    }
+    InDistribution->min = size;
+    InDistribution->max = size;
+    return true;
+  }
+
+  if ( strncmp(InText, "uniform:", 8) == 0 ) {
+    InText += 8;
+    InDistribution->type = FILE_SIZE_DISTRIBUTION_UNIFORM;
+    if ( !FileSizeDistributionParseSize(&InText, &(InDistribution->min)) || *InText++ != '-' ||
+         !FileSizeDistributionParseSize(&InText, &(InDistribution->max)) || *InText ) {
+      return false;
+    }
+    return InDistribution->min <= InDistribution->max;
+  }
+
+  if ( strncmp(InText, "lognormal:", 10) == 0 ) {
+    InText += 10;
+    InDistribution->type = FILE_SIZE_DISTRIBUTION_LOGNORMAL;
+    if ( !FileSizeDistributionParseSize(&InText, &size) || *InText++ != ',' ) {
+      return false;
+    }
+    InDistribution->sigma = strtod(InText, &end);
+    if ( end == InText || *end || InDistribution->sigma <= 0.0 ) {
+      return false;
+    }
+    InDistribution->mu  = log((double)size);
+    InDistribution->min = 1;
+    InDistribution->max = (uint64_t)exp(InDistribution->mu + FILE_SIZE_DISTRIBUTION_LOGNORMAL_TAIL * InDistribution->sigma);
+    return true;
+  }
+
+  if ( strncmp(InText, "bimodal:", 8) == 0 ) {
+    InText += 8;
+    InDistribution->type = FILE_SIZE_DISTRIBUTION_BIMODAL;
+    if ( !FileSizeDistributionParseSize(&InText, &(InDistribution->min)) || *InText++ != ',' ||
+         !FileSizeDistributionParseSize(&InText, &(InDistribution->max)) || *InText++ != ',' ) {
+      return false;
+    }
+    InDistribution->percent = (uint32_t)strtoul(InText, &end, 10);
+    if ( end == InText || *end || InDistribution->percent > 100 ) {
+      return false;
+    }
+    return InDistribution->min <= InDistribution->max;
+  }
+
+  if ( strncmp(InText, "table:", 6) == 0 ) {
+    InText += 6;
+    InDistribution->type = FILE_SIZE_DISTRIBUTION_TABLE;
+    InDistribution->min  = UINT64_MAX;
+    while ( InDistribution->entries < FILE_SIZE_DISTRIBUTION_TABLE_MAX ) {
+      if ( !FileSizeDistributionParseSize(&InText, &size) || *InText++ != ':' ) {
+        return false;
+      }
+      weight = strtoul(InText, &end, 10);
+      if ( end == InText || weight == 0 ) {
+        return false;
+      }
+      InText = end;
+      InDistribution->sizes[InDistribution->entries]   = size;
+      InDistribution->weights[InDistribution->entries] = (uint32_t)weight;
+      InDistribution->entries++;
+      InDistribution->totalWeight += (uint32_t)weight;
+      if ( size < InDistribution->min ) {
+        InDistribution->min = size;
+      }
+      if ( size > InDistribution->max ) {
+        InDistribution->max = size;
+      }
+      if ( *InText == 0x00 ) {
+        return true;
+      }
+      if ( *InText++ != ',' ) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionParseSize
+ *  Reads a non zero size with an optional k, m or g suffix and leaves
+ *  InText on the character after it
+ *****************************************************************************/
+static bool
+FileSizeDistributionParseSize
+(char** InText, uint64_t* InSize)
+{
+  uint64_t                              size;
+  char*                                 end;
+
+  size = strtoull(*InText, &end, 10);
+  if ( end == *InText ) {
+    return false;
+  }
+  switch ( *end ) {
+    case 'k' : case 'K' : {
+      size <<= 10;
+      end++;
+      break;
+    }
+    case 'm' : case 'M' : {
+      size <<= 20;
+      end++;
+      break;
+    }
+    case 'g' : case 'G' : {
+      size <<= 30;
+      end++;
+      break;
+    }
+  }
+  *InText = end;
+  *InSize = size;
+  return size > 0;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionSample
+ *****************************************************************************/
+uint64_t
+FileSizeDistributionSample
+(FileSizeDistribution* InDistribution, Random* InRandom)
+{
+  double                                u1, u2, size;
+  uint32_t                              i, weight;
+
+  switch ( InDistribution->type ) {
+    case FILE_SIZE_DISTRIBUTION_FIXED : {
+      return InDistribution->min;
+    }
+    case FILE_SIZE_DISTRIBUTION_UNIFORM : {
+      return InDistribution->min + RandomBounded64(InRandom, InDistribution->max - InDistribution->min + 1);
+    }
+    case FILE_SIZE_DISTRIBUTION_LOGNORMAL : {
+      //! Box-Muller
+      u1 = RandomDouble(InRandom);
+      u2 = RandomDouble(InRandom);
+      size = exp(InDistribution->mu + InDistribution->sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+      if ( size < InDistribution->min ) {
+        return InDistribution->min;
+      }
+      if ( size > InDistribution->max ) {
+        return InDistribution->max;
+      }
+      return (uint64_t)size;
+    }
+    case FILE_SIZE_DISTRIBUTION_BIMODAL : {
+      return RandomBounded(InRandom, 100) < InDistribution->percent ? InDistribution->max : InDistribution->min;
+    }
+    case FILE_SIZE_DISTRIBUTION_TABLE : {
+      weight = RandomBounded(InRandom, InDistribution->totalWeight);
+      for ( i = 0 ; i + 1 < InDistribution->entries && weight >= InDistribution->weights[i] ; i++ ) {
+        weight -= InDistribution->weights[i];
+      }
+      return InDistribution->sizes[i];
+    }
+  }
+  return InDistribution->max;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionGetMax
+ *****************************************************************************/
+uint64_t
+FileSizeDistributionGetMax
+(FileSizeDistribution* InDistribution)
+{
+  return InDistribution->max;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionCapMax
+ *  Only a log-normal maximum is derived rather than given, so only it can be
+ *  lowered, samples above InMax are then cut off at InMax like the tail
+ *****************************************************************************/
+bool
+FileSizeDistributionCapMax
+(FileSizeDistribution* InDistribution, uint64_t InMax)
+{
+  if ( InDistribution->type != FILE_SIZE_DISTRIBUTION_LOGNORMAL || InMax < InDistribution->min ) {
+    return false;
+  }
+  if ( InMax < InDistribution->max ) {
+    InDistribution->max = InMax;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionGetMean
+ *****************************************************************************/
+uint64_t
+FileSizeDistributionGetMean
+(FileSizeDistribution* InDistribution)
+{
+  uint64_t                              total;
+  uint32_t                              i;
+
+  switch ( InDistribution->type ) {
+    case FILE_SIZE_DISTRIBUTION_FIXED : {
+      return InDistribution->min;
+    }
+    case FILE_SIZE_DISTRIBUTION_UNIFORM : {
+      return (InDistribution->min + InDistribution->max) / 2;
+    }
+    case FILE_SIZE_DISTRIBUTION_LOGNORMAL : {
+      return (uint64_t)exp(InDistribution->mu + InDistribution->sigma * InDistribution->sigma / 2.0);
+    }
+    case FILE_SIZE_DISTRIBUTION_BIMODAL : {
+      return (InDistribution->min * (100 - InDistribution->percent) + InDistribution->max * InDistribution->percent) / 100;
+    }
+    case FILE_SIZE_DISTRIBUTION_TABLE : {
+      total = 0;
+      for ( i = 0 ; i < InDistribution->entries ; i++ ) {
+        total += InDistribution->sizes[i] * InDistribution->weights[i];
+      }
+      return total / InDistribution->totalWeight;
+    }
+  }
+  return InDistribution->max;
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionRecord
+ *  Called by every worker, the buckets are updated atomically
+ *****************************************************************************/
+void
+FileSizeDistributionRecord
+(FileSizeDistribution* InDistribution, uint64_t InSize)
+{
+  int                                   bucket;
+
+  bucket = InSize ? 64 - __builtin_clzll(InSize) : 0;
+  if ( bucket >= FILE_SIZE_DISTRIBUTION_BUCKETS ) {
+    bucket = FILE_SIZE_DISTRIBUTION_BUCKETS - 1;
+  }
+  __atomic_fetch_add(&(InDistribution->histogram[bucket]), 1, __ATOMIC_RELAXED);
+}
+
+/*****************************************************************************!
+ * Function : FileSizeDistributionToJSON
+ *  Only the buckets in use are listed, each by the largest size it holds
+ *****************************************************************************/
+JSONOut*
+FileSizeDistributionToJSON
+(string InTag, FileSizeDistribution* InDistribution)
+{
+  JSONOut*                              object;
+  JSONOut*                              histogram;
+  JSONOut*                              bucket;
+  uint64_t                              count;
+  int                                   i;
+
+  histogram = JSONOutCreateArray("histogram");
+  for ( i = 0 ; i < FILE_SIZE_DISTRIBUTION_BUCKETS ; i++ ) {
+    count = __atomic_load_n(&(InDistribution->histogram[i]), __ATOMIC_RELAXED);
+    if ( count == 0 ) {
+      continue;
+    }
+    bucket = JSONOutCreateObject(NULL);
+    JSONOutObjectAddObjects(bucket,
+                            JSONOutCreateLongLong("size", i ? (1ULL << i) - 1 : 0),
+                            JSONOutCreateLongLong("count", count),
+                            NULL);
+    JSONOutArrayAddObject(histogram, bucket);
+  }
+
+  object = JSONOutCreateObject(InTag);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("spec", InDistribution->spec),
+                          JSONOutCreateLongLong("min", InDistribution->min),
+                          JSONOutCreateLongLong("max", InDistribution->max),
+                          JSONOutCreateLongLong("mean", FileSizeDistributionGetMean(InDistribution)),
+                          histogram,
+                          NULL);
+  return object;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * FILE NAME    : FileSizeDistribution.h
+ * DATE         : January 11 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _filesizedistribution_h_
+#define _filesizedistribution_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "JSONOut.h"
+#include "Random.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define FILE_SIZE_DISTRIBUTION_TABLE_MAX        32
+#define FILE_SIZE_DISTRIBUTION_BUCKETS          48
+
+/*****************************************************************************!
+ * Exported Type : FileSizeDistributionType
+ *****************************************************************************/
+enum _FileSizeDistributionType
+{
+  FILE_SIZE_DISTRIBUTION_FIXED,
+  FILE_SIZE_DISTRIBUTION_UNIFORM,
+  FILE_SIZE_DISTRIBUTION_LOGNORMAL,
+  FILE_SIZE_DISTRIBUTION_BIMODAL,
+  FILE_SIZE_DISTRIBUTION_TABLE
+};
+typedef enum _FileSizeDistributionType FileSizeDistributionType;
+
+/*****************************************************************************!
+ * Exported Type : FileSizeDistribution
+ *  min/max bound every sample.  The histogram counts sampled sizes in log2
+ *  buckets, bucket n holding sizes of [2^(n-1), 2^n) bytes.
+ *****************************************************************************/
+struct _FileSizeDistribution
+{
+  FileSizeDistributionType              type;
+  string                                spec;
+  uint64_t                              min;
+  uint64_t                              max;
+  double                                mu;
+  double                                sigma;
+  uint32_t                              percent;
+  uint64_t                              sizes[FILE_SIZE_DISTRIBUTION_TABLE_MAX];
+  uint32_t                              weights[FILE_SIZE_DISTRIBUTION_TABLE_MAX];
+  uint32_t                              entries;
+  uint32_t                              totalWeight;
+  uint64_t                              histogram[FILE_SIZE_DISTRIBUTION_BUCKETS];
+};
+typedef struct _FileSizeDistribution FileSizeDistribution;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+FileSizeDistribution*
+FileSizeDistributionCreate
+(string InSpec);
+
+void
+FileSizeDistributionDestroy
+(FileSizeDistribution* InDistribution);
+
+uint64_t
+FileSizeDistributionSample
+(FileSizeDistribution* InDistribution, Random* InRandom);
+
+uint64_t
+FileSizeDistributionGetMax
+(FileSizeDistribution* InDistribution);
+
+bool
+FileSizeDistributionCapMax
+(FileSizeDistribution* InDistribution, uint64_t InMax);
+
+uint64_t
+FileSizeDistributionGetMean
+(FileSizeDistribution* InDistribution);
+
+void
+FileSizeDistributionRecord
+(FileSizeDistribution* InDistribution, uint64_t InSize);
+
+JSONOut*
+FileSizeDistributionToJSON
+(string InTag, FileSizeDistribution* InDistribution);
+
+#endif // _filesizedistribution_h_
@@ -26,6 +26,7 @@
 #include "GeneralUtilities/String.h"
 #include "GeneralUtilities/MemoryManager.h"
 #include "Log.h"
+#include "ThreadAffinity.h"
 
 /*****************************************************************************!
  * Local Macros
@@ -104,6 +105,7 @@ void*
 HTTPServerThread
 (void* InParameters)
 {
+  ThreadAffinityApplyServer("http");
   mg_mgr_init(&HTTPManager, NULL);
   HTTPConnection = mg_bind(&HTTPManager, HTTPPortAddress, HTTPServerEventHandler);
 
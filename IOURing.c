@@ -0,0 +1,237 @@
+/*****************************************************************************
+ * FILE NAME    : IOURing.c
+ * DATE         : January 06 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "IOURing.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define IOURingLoadAcquire(p)           __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define IOURingStoreRelease(p, v)       __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : IOURingCreate
+ *****************************************************************************/
+IOURing*
+IOURingCreate
+(uint32_t InEntries)
+{
+  IOURing*                              ring;
+  struct io_uring_params                params;
+  uint8_t*                              sq;
+  uint8_t*                              cq;
+
+  memset(&params, 0x00, sizeof(params));
+  ring = (IOURing*)GetMemory(sizeof(IOURing));
+  memset(ring, 0x00, sizeof(IOURing));
+
+  ring->fd = (int)syscall(__NR_io_uring_setup, InEntries, &params);
+  if ( ring->fd < 0 ) {
+    FreeMemory(ring);
+    return NULL;
+  }
+  ring->sqEntries = params.sq_entries;
+  ring->cqEntries = params.cq_entries;
+
+  ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  ring->sqesSize   = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQ_RING);
+  ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_CQ_RING);
+  ring->sqes   = (struct io_uring_sqe*)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if ( ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || (void*)ring->sqes == MAP_FAILED ) {
+    IOURingDestroy(ring);
+    return NULL;
+  }
+
+  sq = (uint8_t*)ring->sqRing;
+  ring->sqHead      = (uint32_t*)(sq + params.sq_off.head);
+  ring->sqTail      = (uint32_t*)(sq + params.sq_off.tail);
+  ring->sqRingMask  = (uint32_t*)(sq + params.sq_off.ring_mask);
+  ring->sqArray     = (uint32_t*)(sq + params.sq_off.array);
+  ring->sqLocalTail = *ring->sqTail;
+
+  cq = (uint8_t*)ring->cqRing;
+  ring->cqHead      = (uint32_t*)(cq + params.cq_off.head);
+  ring->cqTail      = (uint32_t*)(cq + params.cq_off.tail);
+  ring->cqRingMask  = (uint32_t*)(cq + params.cq_off.ring_mask);
+  ring->cqes        = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+  return ring;
+}
+
+/*****************************************************************************!
+ * Function : IOURingDestroy
+ *****************************************************************************/
+void
+IOURingDestroy
+(IOURing* InRing)
+{
+  if ( NULL == InRing ) {
+    return;
+  }
+  if ( InRing->sqRing && InRing->sqRing != MAP_FAILED ) {
+    munmap(InRing->sqRing, InRing->sqRingSize);
+  }
+  if ( InRing->cqRing && InRing->cqRing != MAP_FAILED ) {
+    munmap(InRing->cqRing, InRing->cqRingSize);
+  }
+  if ( InRing->sqes && (void*)InRing->sqes != MAP_FAILED ) {
+    munmap(InRing->sqes, InRing->sqesSize);
+  }
+  close(InRing->fd);
+  FreeMemory(InRing);
+}
+
+/*****************************************************************************!
+ * Function : IOURingGetSQE
+ *  Returns a cleared submission entry or NULL when the queue is full
+ *****************************************************************************/
+struct io_uring_sqe*
+IOURingGetSQE
+(IOURing* InRing)
+{
+  uint32_t                              index;
+  struct io_uring_sqe*                  sqe;
+
+  if ( InRing->sqLocalTail - IOURingLoadAcquire(InRing->sqHead) >= InRing->sqEntries ) {
+    return NULL;
+  }
+  index = InRing->sqLocalTail & *InRing->sqRingMask;
+  InRing->sqArray[index] = index;
+  InRing->sqLocalTail++;
+  sqe = &(InRing->sqes[index]);
+  memset(sqe, 0x00, sizeof(struct io_uring_sqe));
+  return sqe;
+}
+
+/*****************************************************************************!
+ * Function : IOURingGetSQESpace
+ *  Entries IOURingGetSQE can still hand out before the queue is full
+ *****************************************************************************/
+uint32_t
+IOURingGetSQESpace
+(IOURing* InRing)
+{
+  return InRing->sqEntries - (InRing->sqLocalTail - IOURingLoadAcquire(InRing->sqHead));
+}
+
+/*****************************************************************************!
+ * Function : IOURingSubmit
+ *  Publishes the queued entries and optionally waits for InWaitCount
+ *  completions.  Everything the kernel has not consumed yet is offered
+ *  again, so entries left over from a short submit are not stranded.
+ *  -EAGAIN and -EBUSY only mean the kernel wants completions reaped first,
+ *  they are returned as nothing submitted.
+ *****************************************************************************/
+int
+IOURingSubmit
+(IOURing* InRing, uint32_t InWaitCount)
+{
+  uint32_t                              submitCount;
+  uint32_t                              flags;
+  int                                   n;
+
+  submitCount = InRing->sqLocalTail - IOURingLoadAcquire(InRing->sqHead);
+  IOURingStoreRelease(InRing->sqTail, InRing->sqLocalTail);
+  flags = InWaitCount > 0 ? IORING_ENTER_GETEVENTS : 0;
+  if ( submitCount == 0 && InWaitCount == 0 ) {
+    return 0;
+  }
+  do {
+    n = (int)syscall(__NR_io_uring_enter, InRing->fd, submitCount, InWaitCount, flags, NULL, 0);
+  } while ( n < 0 && errno == EINTR );
+  if ( n < 0 && (errno == EAGAIN || errno == EBUSY) ) {
+    return 0;
+  }
+  return n;
+}
+
+/*****************************************************************************!
+ * Function : IOURingPeekCQE
+ *****************************************************************************/
+struct io_uring_cqe*
+IOURingPeekCQE
+(IOURing* InRing)
+{
+  uint32_t                              head;
+
+  head = *InRing->cqHead;
+  if ( head == IOURingLoadAcquire(InRing->cqTail) ) {
+    return NULL;
+  }
+  return &(InRing->cqes[head & *InRing->cqRingMask]);
+}
+
+/*****************************************************************************!
+ * Function : IOURingCQESeen
+ *****************************************************************************/
+void
+IOURingCQESeen
+(IOURing* InRing)
+{
+  IOURingStoreRelease(InRing->cqHead, *InRing->cqHead + 1);
+}
+
+/*****************************************************************************!
+ * Function : IOURingRegisterBuffers
+ *****************************************************************************/
+int
+IOURingRegisterBuffers
+(IOURing* InRing, struct iovec* InBuffers, uint32_t InBufferCount)
+{
+  return (int)syscall(__NR_io_uring_register, InRing->fd, IORING_REGISTER_BUFFERS,
+                      InBuffers, InBufferCount);
+}
+
+/*****************************************************************************!
+ * Function : IOURingRegisterFiles
+ *  Registers an empty (sparse) fixed file table that direct open/close fill in
+ *****************************************************************************/
+int
+IOURingRegisterFiles
+(IOURing* InRing, uint32_t InFileCount)
+{
+  int*                                  fds;
+  uint32_t                              i;
+  int                                   n;
+
+  fds = (int*)GetMemory(sizeof(int) * InFileCount);
+  for ( i = 0 ; i < InFileCount ; i++ ) {
+    fds[i] = -1;
+  }
+  n = (int)syscall(__NR_io_uring_register, InRing->fd, IORING_REGISTER_FILES, fds, InFileCount);
+  FreeMemory(fds);
+  return n;
+}
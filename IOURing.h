@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * FILE NAME    : IOURing.h
+ * DATE         : January 06 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _iouring_h_
+#define _iouring_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : IOURing
+ *  Thin wrapper around the io_uring system calls and the shared rings
+ *****************************************************************************/
+struct _IOURing
+{
+  int                                   fd;
+  uint32_t                              sqEntries;
+  uint32_t                              cqEntries;
+
+  void*                                 sqRing;
+  size_t                                sqRingSize;
+  uint32_t*                             sqHead;
+  uint32_t*                             sqTail;
+  uint32_t*                             sqRingMask;
+  uint32_t*                             sqArray;
+  uint32_t                              sqLocalTail;
+  struct io_uring_sqe*                  sqes;
+  size_t                                sqesSize;
+
+  void*                                 cqRing;
+  size_t                                cqRingSize;
+  uint32_t*                             cqHead;
+  uint32_t*                             cqTail;
+  uint32_t*                             cqRingMask;
+  struct io_uring_cqe*                  cqes;
+};
+typedef struct _IOURing IOURing;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+IOURing*
+IOURingCreate
+(uint32_t InEntries);
+
+void
+IOURingDestroy
+(IOURing* InRing);
+
+struct io_uring_sqe*
+IOURingGetSQE
+(IOURing* InRing);
+
+uint32_t
+IOURingGetSQESpace
+(IOURing* InRing);
+
+int
+IOURingSubmit
+(IOURing* InRing, uint32_t InWaitCount);
+
+struct io_uring_cqe*
+IOURingPeekCQE
+(IOURing* InRing);
+
+void
+IOURingCQESeen
+(IOURing* InRing);
+
+int
+IOURingRegisterBuffers
+(IOURing* InRing, struct iovec* InBuffers, uint32_t InBufferCount);
+
+int
+IOURingRegisterFiles
+(IOURing* InRing, uint32_t InFileCount);
+
+#endif // _iouring_h_
@@ -0,0 +1,524 @@
+/*****************************************************************************
+ * FILE NAME    : IOURingEngine.c
+ * DATE         : January 06 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "IOURingEngine.h"
+#include "GeneralUtilities/MemoryManager.h"
+#include "TimeStamp.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define IOURING_ENGINE_MAX_ENTRIES      32768
+
+//! user_data carries the slot number and the opcode of the request
+#define IOURingEngineUserData(slot, op) (((uint64_t)(slot) << 8) | (op))
+#define IOURingEngineUserDataSlot(d)    ((uint32_t)((d) >> 8))
+#define IOURingEngineUserDataOp(d)      ((uint8_t)((d) & 0xFF))
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static int
+IOURingEngineFindFreeSlot
+(IOURingEngine* InEngine);
+
+static bool
+IOURingEngineQueueSync
+(IOURingEngine* InEngine, uint32_t InSlotIndex);
+
+/*****************************************************************************!
+ * Function : IOURingEngineCreate
+ *  Each slot owns a registered buffer and a fixed file table entry, so a
+ *  create is a single linked openat -> write_fixed... -> close chain
+ *****************************************************************************/
+IOURingEngine*
+IOURingEngineCreate
+(uint32_t InDepth, uint32_t InBufferSize, uint32_t InAlignment, bool InDirectIO, bool InVerify,
+ FileInfoBlockSync InSync, uint64_t InMaxFileSize)
+{
+  IOURingEngine*                        engine;
+  struct iovec*                         iovecs;
+  uint32_t                              i, chainLength, entries;
+  void*                                 buffers;
+
+  if ( InDepth == 0 || InBufferSize == 0 ) {
+    return NULL;
+  }
+
+  //! Open + writes + fsync + close
+  chainLength = (uint32_t)((InMaxFileSize + InBufferSize - 1) / InBufferSize) + 3;
+  if ( chainLength > IOURING_ENGINE_MAX_ENTRIES ) {
+    return NULL;
+  }
+  if ( InDepth * chainLength > IOURING_ENGINE_MAX_ENTRIES ) {
+    InDepth = IOURING_ENGINE_MAX_ENTRIES / chainLength;
+  }
+  for ( entries = 1 ; entries < InDepth * chainLength ; entries <<= 1 ) {
+  }
+
+  if ( posix_memalign(&buffers, InAlignment, (size_t)InBufferSize * InDepth) ) {
+    return NULL;
+  }
+  memset(buffers, ' ', (size_t)InBufferSize * InDepth);
+
+  engine = (IOURingEngine*)GetMemory(sizeof(IOURingEngine));
+  memset(engine, 0x00, sizeof(IOURingEngine));
+  engine->depth      = InDepth;
+  engine->buffers    = (uint8_t*)buffers;
+  engine->bufferSize = InBufferSize;
+  engine->alignment  = InAlignment;
+  engine->directIO   = InDirectIO;
+  engine->verify     = InVerify;
+  engine->sync       = InSync;
+  engine->slots      = (IOURingEngineSlot*)GetMemory(sizeof(IOURingEngineSlot) * InDepth);
+  memset(engine->slots, 0x00, sizeof(IOURingEngineSlot) * InDepth);
+
+  engine->ring = IOURingCreate(entries);
+  if ( NULL == engine->ring ) {
+    IOURingEngineDestroy(engine);
+    return NULL;
+  }
+
+  iovecs = (struct iovec*)GetMemory(sizeof(struct iovec) * InDepth);
+  for ( i = 0 ; i < InDepth ; i++ ) {
+    iovecs[i].iov_base = engine->buffers + (size_t)i * InBufferSize;
+    iovecs[i].iov_len  = InBufferSize;
+  }
+  if ( IOURingRegisterBuffers(engine->ring, iovecs, InDepth) < 0 ||
+       IOURingRegisterFiles(engine->ring, InDepth) < 0 ) {
+    FreeMemory(iovecs);
+    IOURingEngineDestroy(engine);
+    return NULL;
+  }
+  FreeMemory(iovecs);
+  return engine;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineGetMaxFileSize
+ *  The largest file one create chain of InBufferSize writes can hold
+ *****************************************************************************/
+uint64_t
+IOURingEngineGetMaxFileSize
+(uint32_t InBufferSize)
+{
+  return (uint64_t)(IOURING_ENGINE_MAX_ENTRIES - 3) * InBufferSize;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineDestroy
+ *****************************************************************************/
+void
+IOURingEngineDestroy
+(IOURingEngine* InEngine)
+{
+  if ( NULL == InEngine ) {
+    return;
+  }
+  IOURingDestroy(InEngine->ring);
+  FreeMemory(InEngine->slots);
+  free(InEngine->buffers);
+  FreeMemory(InEngine);
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineHasFreeSlot
+ *****************************************************************************/
+bool
+IOURingEngineHasFreeSlot
+(IOURingEngine* InEngine)
+{
+  return InEngine->inFlight < InEngine->depth;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineFindFreeSlot
+ *****************************************************************************/
+static int
+IOURingEngineFindFreeSlot
+(IOURingEngine* InEngine)
+{
+  uint32_t                              i;
+
+  for ( i = 0 ; i < InEngine->depth ; i++ ) {
+    if ( InEngine->slots[i].op == IOURING_ENGINE_OP_NONE ) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineSubmitCreate
+ *  With fsync or fdatasync the chain stops after the writes, Reap queues
+ *  the fsync once they have completed so its latency is its own rather
+ *  than the gap between two completions reaped together
+ *****************************************************************************/
+bool
+IOURingEngineSubmitCreate
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InScheduledTime)
+{
+  int                                   slotIndex;
+  IOURingEngineSlot*                    slot;
+  struct io_uring_sqe*                  sqe;
+  uint64_t                              offset, size;
+  uint32_t                              n, chainLength;
+  int                                   flags;
+  uint8_t*                              buffer;
+  bool                                  syncing;
+
+  slotIndex = IOURingEngineFindFreeSlot(InEngine);
+  if ( slotIndex < 0 || NULL == InBlock ) {
+    return false;
+  }
+  slot = &(InEngine->slots[slotIndex]);
+
+  //! Fixed buffers can not drop O_DIRECT for an unaligned tail, so direct
+  //  files are padded out to the alignment instead
+  size = InBlock->filesize;
+  if ( InEngine->directIO && size % InEngine->alignment ) {
+    size += InEngine->alignment - (size % InEngine->alignment);
+  }
+
+  //! A chain is queued whole or not at all, a partial one would leave its
+  //  last entry linked to whatever is queued next
+  syncing = InEngine->sync == FILE_INFO_BLOCK_SYNC_FSYNC || InEngine->sync == FILE_INFO_BLOCK_SYNC_FDATASYNC;
+  chainLength = (uint32_t)((size + InEngine->bufferSize - 1) / InEngine->bufferSize) + (syncing ? 1 : 2);
+  if ( IOURingGetSQESpace(InEngine->ring) < chainLength ) {
+    return false;
+  }
+
+  //! The slot is free, so nothing in flight is still reading its buffer
+  buffer = InEngine->buffers + (size_t)slotIndex * InEngine->bufferSize;
+  if ( InEngine->verify ) {
+    FileInfoBlockFillPattern(InBlock, buffer, InEngine->bufferSize);
+    FileInfoBlockSetChecksum(InBlock, FileInfoBlockComputeChecksum(buffer, InEngine->bufferSize, InBlock->filesize));
+  }
+
+  slot->block         = InBlock;
+  slot->op            = IOURING_ENGINE_OP_CREATE;
+  slot->dirFD         = FileInfoBlockResolve(InBlock, slot->path, &(slot->name));
+  slot->outstanding   = 0;
+  slot->result        = 0;
+  slot->offset        = 0;
+  slot->bytes         = size;
+  slot->startTime     = TimeStampGetMicroseconds();
+  slot->scheduledTime = InScheduledTime ? InScheduledTime : slot->startTime;
+  slot->syncTime      = 0;
+  slot->syncElapsed   = 0;
+  slot->syncPending   = syncing;
+
+  flags = O_WRONLY | O_CREAT | O_TRUNC;
+  if ( InEngine->directIO ) {
+    flags |= O_DIRECT;
+  }
+  if ( InEngine->sync == FILE_INFO_BLOCK_SYNC_OSYNC ) {
+    flags |= O_SYNC;
+  } else if ( InEngine->sync == FILE_INFO_BLOCK_SYNC_ODSYNC ) {
+    flags |= O_DSYNC;
+  }
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode     = IORING_OP_OPENAT;
+  sqe->fd         = slot->dirFD;
+  sqe->addr       = (uint64_t)(uintptr_t)slot->name;
+  sqe->len        = 0644;
+  sqe->open_flags = flags;
+  sqe->file_index = slotIndex + 1;
+  sqe->flags      = IOSQE_IO_LINK;
+  sqe->user_data  = IOURingEngineUserData(slotIndex, IORING_OP_OPENAT);
+  slot->outstanding++;
+
+  for ( offset = 0 ; offset < size ; offset += n ) {
+    n = size - offset < InEngine->bufferSize ? (uint32_t)(size - offset) : InEngine->bufferSize;
+    sqe = IOURingGetSQE(InEngine->ring);
+    sqe->opcode    = IORING_OP_WRITE_FIXED;
+    sqe->fd        = slotIndex;
+    sqe->flags     = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+    sqe->addr      = (uint64_t)(uintptr_t)buffer;
+    sqe->len       = n;
+    sqe->off       = offset;
+    sqe->buf_index = slotIndex;
+    sqe->user_data = IOURingEngineUserData(slotIndex, IORING_OP_WRITE_FIXED);
+    slot->outstanding++;
+  }
+
+  //! The last write ends the chain, the fsync and close follow on their own
+  if ( syncing ) {
+    sqe->flags &= ~IOSQE_IO_LINK;
+    InEngine->inFlight++;
+    return true;
+  }
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode     = IORING_OP_CLOSE;
+  sqe->file_index = slotIndex + 1;
+  sqe->user_data  = IOURingEngineUserData(slotIndex, IORING_OP_CLOSE);
+  slot->outstanding++;
+
+  InEngine->inFlight++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineSubmitRead
+ *  openat -> read_fixed... -> close into the slot buffer.  With direct I/O
+ *  InOffset must be aligned, the reads are rounded up to the alignment.
+ *****************************************************************************/
+bool
+IOURingEngineSubmitRead
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InOffset, uint64_t InLength,
+ uint64_t InScheduledTime)
+{
+  int                                   slotIndex;
+  IOURingEngineSlot*                    slot;
+  struct io_uring_sqe*                  sqe;
+  uint64_t                              offset;
+  uint32_t                              n, chainLength;
+  int                                   flags;
+
+  slotIndex = IOURingEngineFindFreeSlot(InEngine);
+  if ( slotIndex < 0 || NULL == InBlock ) {
+    return false;
+  }
+  slot = &(InEngine->slots[slotIndex]);
+  if ( InEngine->directIO && InLength % InEngine->alignment ) {
+    InLength += InEngine->alignment - (InLength % InEngine->alignment);
+  }
+  chainLength = (uint32_t)((InLength + InEngine->bufferSize - 1) / InEngine->bufferSize) + 2;
+  if ( IOURingGetSQESpace(InEngine->ring) < chainLength ) {
+    return false;
+  }
+
+  slot->block         = InBlock;
+  slot->op            = IOURING_ENGINE_OP_READ;
+  slot->dirFD         = FileInfoBlockResolve(InBlock, slot->path, &(slot->name));
+  slot->outstanding   = 0;
+  slot->result        = 0;
+  slot->offset        = InOffset;
+  slot->bytes         = 0;
+  slot->startTime     = TimeStampGetMicroseconds();
+  slot->scheduledTime = InScheduledTime ? InScheduledTime : slot->startTime;
+  slot->syncTime      = 0;
+  slot->syncElapsed   = 0;
+  slot->syncPending   = false;
+
+  flags = O_RDONLY;
+  if ( InEngine->directIO ) {
+    flags |= O_DIRECT;
+  }
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode     = IORING_OP_OPENAT;
+  sqe->fd         = slot->dirFD;
+  sqe->addr       = (uint64_t)(uintptr_t)slot->name;
+  sqe->open_flags = flags;
+  sqe->file_index = slotIndex + 1;
+  sqe->flags      = IOSQE_IO_LINK;
+  sqe->user_data  = IOURingEngineUserData(slotIndex, IORING_OP_OPENAT);
+  slot->outstanding++;
+
+  //! The reads all land in the slot buffer, only the byte count matters.  A
+  //  read running into the end of the file comes back short, which would
+  //  cancel the rest of a normal link and leave the file open, so the reads
+  //  are hard linked.
+  for ( offset = 0 ; offset < InLength ; offset += n ) {
+    n = InLength - offset < InEngine->bufferSize ? (uint32_t)(InLength - offset) : InEngine->bufferSize;
+    sqe = IOURingGetSQE(InEngine->ring);
+    sqe->opcode    = IORING_OP_READ_FIXED;
+    sqe->fd        = slotIndex;
+    sqe->flags     = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+    sqe->addr      = (uint64_t)(uintptr_t)(InEngine->buffers + (size_t)slotIndex * InEngine->bufferSize);
+    sqe->len       = n;
+    sqe->off       = InOffset + offset;
+    sqe->buf_index = slotIndex;
+    sqe->user_data = IOURingEngineUserData(slotIndex, IORING_OP_READ_FIXED);
+    slot->outstanding++;
+  }
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode     = IORING_OP_CLOSE;
+  sqe->file_index = slotIndex + 1;
+  sqe->user_data  = IOURingEngineUserData(slotIndex, IORING_OP_CLOSE);
+  slot->outstanding++;
+
+  InEngine->inFlight++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineSubmitRemove
+ *****************************************************************************/
+bool
+IOURingEngineSubmitRemove
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InScheduledTime)
+{
+  int                                   slotIndex;
+  IOURingEngineSlot*                    slot;
+  struct io_uring_sqe*                  sqe;
+
+  slotIndex = IOURingEngineFindFreeSlot(InEngine);
+  if ( slotIndex < 0 || NULL == InBlock || IOURingGetSQESpace(InEngine->ring) < 1 ) {
+    return false;
+  }
+  slot = &(InEngine->slots[slotIndex]);
+  slot->block         = InBlock;
+  slot->op            = IOURING_ENGINE_OP_REMOVE;
+  slot->dirFD         = FileInfoBlockResolve(InBlock, slot->path, &(slot->name));
+  slot->outstanding   = 1;
+  slot->result        = 0;
+  slot->offset        = 0;
+  slot->bytes         = 0;
+  slot->startTime     = TimeStampGetMicroseconds();
+  slot->scheduledTime = InScheduledTime ? InScheduledTime : slot->startTime;
+  slot->syncTime      = 0;
+  slot->syncElapsed   = 0;
+  slot->syncPending   = false;
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode    = IORING_OP_UNLINKAT;
+  sqe->fd        = slot->dirFD;
+  sqe->addr      = (uint64_t)(uintptr_t)slot->name;
+  sqe->user_data = IOURingEngineUserData(slotIndex, IORING_OP_UNLINKAT);
+  InEngine->inFlight++;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineReap
+ *  Submits everything queued and waits until at least one chain finishes.
+ *  Returns the number of finished chains stored in InCompletions.
+ *****************************************************************************/
+int
+IOURingEngineReap
+(IOURingEngine* InEngine, IOURingEngineCompletion* InCompletions, int InMaxCompletions)
+{
+  struct io_uring_cqe*                  cqe;
+  IOURingEngineSlot*                    slot;
+  IOURingEngineCompletion*              completion;
+  uint32_t                              slotIndex;
+  int                                   count;
+  uint64_t                              now;
+
+  if ( InEngine->inFlight == 0 ) {
+    return 0;
+  }
+  count = 0;
+  while ( count == 0 ) {
+    if ( IOURingSubmit(InEngine->ring, 1) < 0 ) {
+      return -1;
+    }
+    while ( count < InMaxCompletions && (cqe = IOURingPeekCQE(InEngine->ring)) ) {
+      slotIndex = IOURingEngineUserDataSlot(cqe->user_data);
+      slot = &(InEngine->slots[slotIndex]);
+
+      //! Keep the first failure, the rest of the chain reports -ECANCELED
+      if ( cqe->res < 0 && slot->result == 0 ) {
+        slot->result = cqe->res;
+      }
+      if ( cqe->res > 0 && IOURingEngineUserDataOp(cqe->user_data) == IORING_OP_READ_FIXED ) {
+        slot->bytes += cqe->res;
+      }
+
+      now = TimeStampGetMicroseconds();
+      if ( IOURingEngineUserDataOp(cqe->user_data) == IORING_OP_FSYNC ) {
+        slot->syncElapsed = now - slot->syncTime;
+      }
+      IOURingCQESeen(InEngine->ring);
+
+      slot->outstanding--;
+      if ( slot->outstanding > 0 ) {
+        continue;
+      }
+
+      //! The writes are done, the fsync is submitted straight away so it is
+      //  timed from submission to completion.  A failed chain is finished
+      //  as it is, a later openat into the fixed slot replaces the file.
+      if ( slot->syncPending && slot->result == 0 ) {
+        slot->syncPending = false;
+        if ( !IOURingEngineQueueSync(InEngine, slotIndex) ) {
+          IOURingSubmit(InEngine->ring, 0);
+          if ( !IOURingEngineQueueSync(InEngine, slotIndex) ) {
+            slot->result = -EAGAIN;
+          }
+        }
+        if ( slot->outstanding > 0 ) {
+          slot->syncTime = TimeStampGetMicroseconds();
+          if ( IOURingSubmit(InEngine->ring, 0) < 0 ) {
+            return -1;
+          }
+          continue;
+        }
+      }
+      completion = &(InCompletions[count++]);
+      completion->block        = slot->block;
+      completion->op           = slot->op;
+      completion->result       = slot->result;
+      completion->offset       = slot->offset;
+      completion->bytes        = slot->bytes;
+      completion->elapsed      = now - slot->startTime;
+      completion->syncElapsed  = slot->syncElapsed;
+      completion->responseTime = now - slot->scheduledTime;
+      slot->block = NULL;
+      slot->op    = IOURING_ENGINE_OP_NONE;
+      InEngine->inFlight--;
+    }
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : IOURingEngineQueueSync
+ *  Queues the fsync -> close tail of a synced create, false when the
+ *  submission queue has no room for it
+ *****************************************************************************/
+static bool
+IOURingEngineQueueSync
+(IOURingEngine* InEngine, uint32_t InSlotIndex)
+{
+  IOURingEngineSlot*                    slot;
+  struct io_uring_sqe*                  sqe;
+
+  if ( IOURingGetSQESpace(InEngine->ring) < 2 ) {
+    return false;
+  }
+  slot = &(InEngine->slots[InSlotIndex]);
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode      = IORING_OP_FSYNC;
+  sqe->fd          = InSlotIndex;
+  sqe->flags       = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+  sqe->fsync_flags = InEngine->sync == FILE_INFO_BLOCK_SYNC_FDATASYNC ? IORING_FSYNC_DATASYNC : 0;
+  sqe->user_data   = IOURingEngineUserData(InSlotIndex, IORING_OP_FSYNC);
+  slot->outstanding++;
+
+  sqe = IOURingGetSQE(InEngine->ring);
+  sqe->opcode     = IORING_OP_CLOSE;
+  sqe->file_index = InSlotIndex + 1;
+  sqe->user_data  = IOURingEngineUserData(InSlotIndex, IORING_OP_CLOSE);
+  slot->outstanding++;
+  return true;
+}
@@ -0,0 +1,140 @@
+/*****************************************************************************
+ * FILE NAME    : IOURingEngine.h
+ * DATE         : January 06 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _iouringengine_h_
+#define _iouringengine_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "IOURing.h"
+#include "FileInfoBlock.h"
+#include "GeneralUtilities/String.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : IOURingEngineOp
+ *****************************************************************************/
+enum _IOURingEngineOp
+{
+  IOURING_ENGINE_OP_NONE,
+  IOURING_ENGINE_OP_CREATE,
+  IOURING_ENGINE_OP_REMOVE,
+  IOURING_ENGINE_OP_READ
+};
+typedef enum _IOURingEngineOp IOURingEngineOp;
+
+/*****************************************************************************!
+ * Exported Type : IOURingEngineSlot
+ *  One in flight openat/write/close, openat/read/close or unlinkat chain.
+ *  A synced create runs as openat/write then fsync/close, syncPending is
+ *  set while the second chain is still to be queued and syncTime is when
+ *  it was submitted.
+ *****************************************************************************/
+struct _IOURingEngineSlot
+{
+  FileInfoBlock*                        block;
+  IOURingEngineOp                       op;
+  char                                  path[FILE_NAMESPACE_PATH_SIZE];
+  char*                                 name;
+  int                                   dirFD;
+  uint32_t                              outstanding;
+  int                                   result;
+  uint64_t                              offset;
+  uint64_t                              bytes;
+  uint64_t                              startTime;
+  uint64_t                              scheduledTime;
+  uint64_t                              syncTime;
+  uint64_t                              syncElapsed;
+  bool                                  syncPending;
+};
+typedef struct _IOURingEngineSlot IOURingEngineSlot;
+
+/*****************************************************************************!
+ * Exported Type : IOURingEngineCompletion
+ *****************************************************************************/
+struct _IOURingEngineCompletion
+{
+  FileInfoBlock*                        block;
+  IOURingEngineOp                       op;
+  int                                   result;
+  uint64_t                              offset;
+  uint64_t                              bytes;
+  uint64_t                              elapsed;
+  uint64_t                              syncElapsed;
+  uint64_t                              responseTime;
+};
+typedef struct _IOURingEngineCompletion IOURingEngineCompletion;
+
+/*****************************************************************************!
+ * Exported Type : IOURingEngine
+ *****************************************************************************/
+struct _IOURingEngine
+{
+  IOURing*                              ring;
+  uint32_t                              depth;
+  uint32_t                              inFlight;
+  IOURingEngineSlot*                    slots;
+  uint8_t*                              buffers;
+  uint32_t                              bufferSize;
+  uint32_t                              alignment;
+  bool                                  directIO;
+  bool                                  verify;
+  FileInfoBlockSync                     sync;
+};
+typedef struct _IOURingEngine IOURingEngine;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+IOURingEngine*
+IOURingEngineCreate
+(uint32_t InDepth, uint32_t InBufferSize, uint32_t InAlignment, bool InDirectIO, bool InVerify,
+ FileInfoBlockSync InSync, uint64_t InMaxFileSize);
+
+void
+IOURingEngineDestroy
+(IOURingEngine* InEngine);
+
+uint64_t
+IOURingEngineGetMaxFileSize
+(uint32_t InBufferSize);
+
+bool
+IOURingEngineHasFreeSlot
+(IOURingEngine* InEngine);
+
+bool
+IOURingEngineSubmitCreate
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InScheduledTime);
+
+bool
+IOURingEngineSubmitRead
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InOffset, uint64_t InLength,
+ uint64_t InScheduledTime);
+
+bool
+IOURingEngineSubmitRemove
+(IOURingEngine* InEngine, FileInfoBlock* InBlock, string InDirectory, uint64_t InScheduledTime);
+
+int
+IOURingEngineReap
+(IOURingEngine* InEngine, IOURingEngineCompletion* InCompletions, int InMaxCompletions);
+
+#endif // _iouringengine_h_
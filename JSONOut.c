@@ -78,6 +78,20 @@ JSONOutCreateLongLong
   return jsonout;
 }
 
+/*****************************************************************************!
+ * Function : JSONOutCreateFloat
+ *****************************************************************************/
+JSONOut*
+JSONOutCreateFloat
+(string InTag, double InFloat)
+{
+  JSONOut*                              jsonout;
+
+  jsonout = JSONOutCreate(InTag, JSONOutTypeFloat);
+  jsonout->valueFloat = InFloat;
+  return jsonout;
+}
+
 /*****************************************************************************!
  * Function : JSONOutCreateString
  *****************************************************************************/
@@ -326,7 +340,7 @@ JSONOutToString
   string                                s2;
   int                                   i;
   char                                  intString[32];
-  char                                  floatString[16];
+  char                                  floatString[64];
   string                                indentString;
   string                                s;
   if ( NULL == InObject ) {
@@ -363,7 +377,7 @@ JSONOutToString
     }
       
     case JSONOutTypeFloat : {
-      sprintf(floatString, "%f", InObject->valueFloat);
+      snprintf(floatString, sizeof(floatString), "%.3f", InObject->valueFloat);
       s = StringConcatTo(s, floatString);
       break;
     }
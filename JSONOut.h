@@ -164,4 +164,8 @@ JSONOut*
 JSONOutCreateLongLong
 (string InTag, uint64_t InLongLong);
 
+JSONOut*
+JSONOutCreateFloat
+(string InTag, double InFloat);
+
 #endif /* _jsonout_h_*/
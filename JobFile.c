@@ -0,0 +1,257 @@
+/*****************************************************************************
+ * FILE NAME    : JobFile.c
+ * DATE         : January 27 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <errno.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "JobFile.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define JOB_FILE_LINE_SIZE              1024
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static string
+JobFileTrim
+(string InText);
+
+static JobFileSection*
+JobFileAddSection
+(JobFile* InJobFile, bool InPhase, string InName, int InLine);
+
+static void
+JobFileAddEntry
+(JobFileSection* InSection, string InKey, string InValue, int InLine);
+
+/*****************************************************************************!
+ * Function : JobFileLoad
+ *  Reports the first malformed line on stderr and returns NULL
+ *****************************************************************************/
+JobFile*
+JobFileLoad
+(string InPath)
+{
+  FILE*                                 file;
+  JobFile*                              jobFile;
+  JobFileSection*                       section;
+  char                                  buffer[JOB_FILE_LINE_SIZE];
+  string                                line;
+  string                                key;
+  string                                value;
+  string                                s;
+  int                                   lineNumber;
+
+  file = fopen(InPath, "r");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not open job file %s : %s\n", InPath, strerror(errno));
+    return NULL;
+  }
+
+  jobFile = (JobFile*)GetMemory(sizeof(JobFile));
+  memset(jobFile, 0x00, sizeof(JobFile));
+  jobFile->path = StringCopy(InPath);
+  section = NULL;
+  lineNumber = 0;
+
+  while ( fgets(buffer, sizeof(buffer), file) ) {
+    lineNumber++;
+    line = JobFileTrim(buffer);
+    if ( *line == 0x00 || *line == '#' || *line == ';' ) {
+      continue;
+    }
+
+    if ( *line == '[' ) {
+      s = strchr(line, ']');
+      if ( NULL == s || *JobFileTrim(s + 1) != 0x00 ) {
+        fprintf(stderr, "%s:%d : a section header is [global] or [phase <name>]\n", InPath, lineNumber);
+        break;
+      }
+      *s = 0x00;
+      line = JobFileTrim(line + 1);
+      if ( StringEqual(line, JOB_FILE_GLOBAL_SECTION) ) {
+        section = JobFileAddSection(jobFile, false, NULL, lineNumber);
+        continue;
+      }
+      if ( strncmp(line, JOB_FILE_PHASE_SECTION, strlen(JOB_FILE_PHASE_SECTION)) == 0 &&
+           isspace((unsigned char)line[strlen(JOB_FILE_PHASE_SECTION)]) ) {
+        section = JobFileAddSection(jobFile, true, JobFileTrim(line + strlen(JOB_FILE_PHASE_SECTION)), lineNumber);
+        continue;
+      }
+      fprintf(stderr, "%s:%d : unknown section [%s]\n", InPath, lineNumber, line);
+      break;
+    }
+
+    s = strchr(line, '=');
+    if ( NULL == s ) {
+      fprintf(stderr, "%s:%d : expected <key> = <value>\n", InPath, lineNumber);
+      break;
+    }
+    *s = 0x00;
+    key   = JobFileTrim(line);
+    value = JobFileTrim(s + 1);
+    if ( *key == 0x00 ) {
+      fprintf(stderr, "%s:%d : missing key\n", InPath, lineNumber);
+      break;
+    }
+    if ( NULL == section ) {
+      section = JobFileAddSection(jobFile, false, NULL, lineNumber);
+    }
+    JobFileAddEntry(section, key, value, lineNumber);
+  }
+
+  if ( !feof(file) ) {
+    fclose(file);
+    JobFileDestroy(jobFile);
+    return NULL;
+  }
+  fclose(file);
+  return jobFile;
+}
+
+/*****************************************************************************!
+ * Function : JobFileDestroy
+ *****************************************************************************/
+void
+JobFileDestroy
+(JobFile* InJobFile)
+{
+  JobFileSection*                       section;
+  int                                   i, j;
+
+  if ( NULL == InJobFile ) {
+    return;
+  }
+  for ( i = 0 ; i < InJobFile->sectionCount ; i++ ) {
+    section = &(InJobFile->sections[i]);
+    for ( j = 0 ; j < section->entryCount ; j++ ) {
+      FreeMemory(section->entries[j].key);
+      FreeMemory(section->entries[j].value);
+    }
+    if ( section->entries ) {
+      FreeMemory(section->entries);
+    }
+    if ( section->name ) {
+      FreeMemory(section->name);
+    }
+  }
+  if ( InJobFile->sections ) {
+    FreeMemory(InJobFile->sections);
+  }
+  FreeMemory(InJobFile->path);
+  FreeMemory(InJobFile);
+}
+
+/*****************************************************************************!
+ * Function : JobFileIsTrue
+ *****************************************************************************/
+bool
+JobFileIsTrue
+(string InValue)
+{
+  return StringEqualsOneOf(InValue, "on", "true", "yes", "1", NULL);
+}
+
+/*****************************************************************************!
+ * Function : JobFileIsFalse
+ *****************************************************************************/
+bool
+JobFileIsFalse
+(string InValue)
+{
+  return StringEqualsOneOf(InValue, "off", "false", "no", "0", NULL);
+}
+
+/*****************************************************************************!
+ * Function : JobFileTrim
+ *  Strips leading and trailing white space in place
+ *****************************************************************************/
+static string
+JobFileTrim
+(string InText)
+{
+  string                                end;
+
+  while ( isspace((unsigned char)*InText) ) {
+    InText++;
+  }
+  end = InText + strlen(InText);
+  while ( end > InText && isspace((unsigned char)end[-1]) ) {
+    end--;
+  }
+  *end = 0x00;
+  return InText;
+}
+
+/*****************************************************************************!
+ * Function : JobFileAddSection
+ *****************************************************************************/
+static JobFileSection*
+JobFileAddSection
+(JobFile* InJobFile, bool InPhase, string InName, int InLine)
+{
+  JobFileSection*                       sections;
+  JobFileSection*                       section;
+
+  if ( InJobFile->sectionCount == InJobFile->sectionSize ) {
+    InJobFile->sectionSize = InJobFile->sectionSize ? InJobFile->sectionSize * 2 : 4;
+    sections = (JobFileSection*)GetMemory(sizeof(JobFileSection) * InJobFile->sectionSize);
+    if ( InJobFile->sections ) {
+      memcpy(sections, InJobFile->sections, sizeof(JobFileSection) * InJobFile->sectionCount);
+      FreeMemory(InJobFile->sections);
+    }
+    InJobFile->sections = sections;
+  }
+  section = &(InJobFile->sections[InJobFile->sectionCount++]);
+  memset(section, 0x00, sizeof(JobFileSection));
+  section->phase = InPhase;
+  section->name  = InName ? StringCopy(InName) : NULL;
+  section->line  = InLine;
+  return section;
+}
+
+/*****************************************************************************!
+ * Function : JobFileAddEntry
+ *****************************************************************************/
+static void
+JobFileAddEntry
+(JobFileSection* InSection, string InKey, string InValue, int InLine)
+{
+  JobFileEntry*                         entries;
+  JobFileEntry*                         entry;
+
+  if ( InSection->entryCount == InSection->entrySize ) {
+    InSection->entrySize = InSection->entrySize ? InSection->entrySize * 2 : 8;
+    entries = (JobFileEntry*)GetMemory(sizeof(JobFileEntry) * InSection->entrySize);
+    if ( InSection->entries ) {
+      memcpy(entries, InSection->entries, sizeof(JobFileEntry) * InSection->entryCount);
+      FreeMemory(InSection->entries);
+    }
+    InSection->entries = entries;
+  }
+  entry = &(InSection->entries[InSection->entryCount++]);
+  entry->key   = StringCopy(InKey);
+  entry->value = StringCopy(InValue);
+  entry->line  = InLine;
+}
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * FILE NAME    : JobFile.h
+ * DATE         : January 27 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _jobfile_h_
+#define _jobfile_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define JOB_FILE_GLOBAL_SECTION         "global"
+#define JOB_FILE_PHASE_SECTION          "phase"
+
+/*****************************************************************************!
+ * Exported Type : JobFileEntry
+ *****************************************************************************/
+struct _JobFileEntry
+{
+  string                                key;
+  string                                value;
+  int                                   line;
+};
+typedef struct _JobFileEntry JobFileEntry;
+
+/*****************************************************************************!
+ * Exported Type : JobFileSection
+ *  [global] or [phase <name>], name is NULL for the global section
+ *****************************************************************************/
+struct _JobFileSection
+{
+  bool                                  phase;
+  string                                name;
+  int                                   line;
+  int                                   entryCount;
+  int                                   entrySize;
+  JobFileEntry*                         entries;
+};
+typedef struct _JobFileSection JobFileSection;
+
+/*****************************************************************************!
+ * Exported Type : JobFile
+ *  An ini style description of a run.  Keys are the long command line
+ *  option names, values their arguments.  Entries before the first section
+ *  header belong to [global].
+ *
+ *    # comment
+ *    [global]
+ *    engine = iouring
+ *    direct = on
+ *    [phase fill]
+ *    duration = 60
+ *    readpct = 0
+ *****************************************************************************/
+struct _JobFile
+{
+  string                                path;
+  int                                   sectionCount;
+  int                                   sectionSize;
+  JobFileSection*                       sections;
+};
+typedef struct _JobFile JobFile;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+JobFile*
+JobFileLoad
+(string InPath);
+
+void
+JobFileDestroy
+(JobFile* InJobFile);
+
+bool
+JobFileIsTrue
+(string InValue);
+
+bool
+JobFileIsFalse
+(string InValue);
+
+#endif // _jobfile_h_
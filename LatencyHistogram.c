@@ -0,0 +1,160 @@
+/*****************************************************************************
+ * FILE NAME    : LatencyHistogram.c
+ * DATE         : January 09 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "LatencyHistogram.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define LatencyHistogramCounterAdd(c, n) __atomic_fetch_add(&(c), (n), __ATOMIC_RELAXED)
+#define LatencyHistogramCounterGet(c)    __atomic_load_n(&(c), __ATOMIC_RELAXED)
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : LatencyHistogramInit
+ *****************************************************************************/
+void
+LatencyHistogramInit
+(LatencyHistogram* InHistogram)
+{
+  memset(InHistogram, 0x00, sizeof(LatencyHistogram));
+}
+
+/*****************************************************************************!
+ * Function : LatencyHistogramAdd
+ *****************************************************************************/
+void
+LatencyHistogramAdd
+(LatencyHistogram* InHistogram, uint64_t InMicroseconds)
+{
+  uint64_t                              max;
+  int                                   bucket;
+
+  bucket = InMicroseconds ? 64 - __builtin_clzll(InMicroseconds) : 0;
+  if ( bucket >= LATENCY_HISTOGRAM_BUCKETS ) {
+    bucket = LATENCY_HISTOGRAM_BUCKETS - 1;
+  }
+  LatencyHistogramCounterAdd(InHistogram->buckets[bucket], 1);
+  LatencyHistogramCounterAdd(InHistogram->count, 1);
+  LatencyHistogramCounterAdd(InHistogram->total, InMicroseconds);
+
+  max = LatencyHistogramCounterGet(InHistogram->max);
+  while ( InMicroseconds > max &&
+          !__atomic_compare_exchange_n(&(InHistogram->max), &max, InMicroseconds, false,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+  }
+}
+
+/*****************************************************************************!
+ * Function : LatencyHistogramMerge
+ *****************************************************************************/
+void
+LatencyHistogramMerge
+(LatencyHistogram* InHistogram, LatencyHistogram* InSource)
+{
+  uint64_t                              max;
+  int                                   i;
+
+  for ( i = 0 ; i < LATENCY_HISTOGRAM_BUCKETS ; i++ ) {
+    InHistogram->buckets[i] += LatencyHistogramCounterGet(InSource->buckets[i]);
+  }
+  InHistogram->count += LatencyHistogramCounterGet(InSource->count);
+  InHistogram->total += LatencyHistogramCounterGet(InSource->total);
+  max = LatencyHistogramCounterGet(InSource->max);
+  if ( max > InHistogram->max ) {
+    InHistogram->max = max;
+  }
+}
+
+/*****************************************************************************!
+ * Function : LatencyHistogramGetPercentile
+ *  Returns the upper edge of the bucket holding the percentile, clipped to
+ *  the largest sample seen
+ *****************************************************************************/
+uint64_t
+LatencyHistogramGetPercentile
+(LatencyHistogram* InHistogram, double InPercentile)
+{
+  uint64_t                              count, target, seen, edge, max;
+  int                                   i;
+
+  count = LatencyHistogramCounterGet(InHistogram->count);
+  if ( count == 0 ) {
+    return 0;
+  }
+  target = (uint64_t)(count * InPercentile / 100.0);
+  if ( target >= count ) {
+    target = count - 1;
+  }
+  max = LatencyHistogramCounterGet(InHistogram->max);
+  seen = 0;
+  for ( i = 0 ; i < LATENCY_HISTOGRAM_BUCKETS ; i++ ) {
+    seen += LatencyHistogramCounterGet(InHistogram->buckets[i]);
+    if ( seen > target ) {
+      edge = i ? (1ULL << i) - 1 : 0;
+      return edge < max ? edge : max;
+    }
+  }
+  return max;
+}
+
+/*****************************************************************************!
+ * Function : LatencyHistogramGetMean
+ *****************************************************************************/
+uint64_t
+LatencyHistogramGetMean
+(LatencyHistogram* InHistogram)
+{
+  uint64_t                              count;
+
+  count = LatencyHistogramCounterGet(InHistogram->count);
+  if ( count == 0 ) {
+    return 0;
+  }
+  return LatencyHistogramCounterGet(InHistogram->total) / count;
+}
+
+/*****************************************************************************!
+ * Function : LatencyHistogramToJSON
+ *  All times are in microseconds
+ *****************************************************************************/
+JSONOut*
+LatencyHistogramToJSON
+(string InTag, LatencyHistogram* InHistogram)
+{
+  JSONOut*                              object;
+
+  object = JSONOutCreateObject(InTag);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateLongLong("count", LatencyHistogramCounterGet(InHistogram->count)),
+                          JSONOutCreateLongLong("mean", LatencyHistogramGetMean(InHistogram)),
+                          JSONOutCreateLongLong("p50", LatencyHistogramGetPercentile(InHistogram, 50.0)),
+                          JSONOutCreateLongLong("p90", LatencyHistogramGetPercentile(InHistogram, 90.0)),
+                          JSONOutCreateLongLong("p99", LatencyHistogramGetPercentile(InHistogram, 99.0)),
+                          JSONOutCreateLongLong("p999", LatencyHistogramGetPercentile(InHistogram, 99.9)),
+                          JSONOutCreateLongLong("max", LatencyHistogramCounterGet(InHistogram->max)),
+                          NULL);
+  return object;
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * FILE NAME    : LatencyHistogram.h
+ * DATE         : January 09 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _latencyhistogram_h_
+#define _latencyhistogram_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "JSONOut.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define LATENCY_HISTOGRAM_BUCKETS       40
+
+/*****************************************************************************!
+ * Exported Type : LatencyHistogram
+ *  Bucket n counts samples of [2^(n-1), 2^n) microseconds, bucket 0 counts
+ *  samples under a microsecond.  Samples are added by one thread and read
+ *  by another, so every field is updated atomically.
+ *****************************************************************************/
+struct _LatencyHistogram
+{
+  uint64_t                              buckets[LATENCY_HISTOGRAM_BUCKETS];
+  uint64_t                              count;
+  uint64_t                              total;
+  uint64_t                              max;
+};
+typedef struct _LatencyHistogram LatencyHistogram;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+void
+LatencyHistogramInit
+(LatencyHistogram* InHistogram);
+
+void
+LatencyHistogramAdd
+(LatencyHistogram* InHistogram, uint64_t InMicroseconds);
+
+void
+LatencyHistogramMerge
+(LatencyHistogram* InHistogram, LatencyHistogram* InSource);
+
+uint64_t
+LatencyHistogramGetPercentile
+(LatencyHistogram* InHistogram, double InPercentile);
+
+uint64_t
+LatencyHistogramGetMean
+(LatencyHistogram* InHistogram);
+
+JSONOut*
+LatencyHistogramToJSON
+(string InTag, LatencyHistogram* InHistogram);
+
+#endif // _latencyhistogram_h_
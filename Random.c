@@ -0,0 +1,201 @@
+/*****************************************************************************
+ * FILE NAME    : Random.c
+ * DATE         : January 25 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "Random.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define RandomRotate(x, k)              (((x) << (k)) | ((x) >> (64 - (k))))
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! The xoshiro256 jump polynomial, equivalent to 2^128 calls to RandomNext
+static const uint64_t
+randomJump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static uint64_t
+RandomSplitMix
+(uint64_t* InState);
+
+/*****************************************************************************!
+ * Function : RandomInit
+ *  The four state words are filled from InSeed with splitmix64, so a small
+ *  or zero seed still gives a well mixed, never all zero state
+ *****************************************************************************/
+void
+RandomInit
+(Random* InRandom, uint64_t InSeed)
+{
+  int                                   i;
+
+  for ( i = 0 ; i < 4 ; i++ ) {
+    InRandom->s[i] = RandomSplitMix(&InSeed);
+  }
+}
+
+/*****************************************************************************!
+ * Function : RandomSplitMix
+ *****************************************************************************/
+static uint64_t
+RandomSplitMix
+(uint64_t* InState)
+{
+  uint64_t                              z;
+
+  z = (*InState += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/*****************************************************************************!
+ * Function : RandomNext
+ *  xoshiro256**
+ *****************************************************************************/
+uint64_t
+RandomNext
+(Random* InRandom)
+{
+  uint64_t*                             s;
+  uint64_t                              result, t;
+
+  s = InRandom->s;
+  result = RandomRotate(s[1] * 5, 7) * 9;
+  t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = RandomRotate(s[3], 45);
+  return result;
+}
+
+/*****************************************************************************!
+ * Function : RandomJump
+ *  Advances InRandom by 2^128 draws.  Copying a generator and jumping the
+ *  original gives two streams that will never overlap in practice.
+ *****************************************************************************/
+void
+RandomJump
+(Random* InRandom)
+{
+  uint64_t                              s[4];
+  int                                   i, b;
+
+  memset(s, 0x00, sizeof(s));
+  for ( i = 0 ; i < 4 ; i++ ) {
+    for ( b = 0 ; b < 64 ; b++ ) {
+      if ( randomJump[i] & ((uint64_t)1 << b) ) {
+        s[0] ^= InRandom->s[0];
+        s[1] ^= InRandom->s[1];
+        s[2] ^= InRandom->s[2];
+        s[3] ^= InRandom->s[3];
+      }
+      RandomNext(InRandom);
+    }
+  }
+  memcpy(InRandom->s, s, sizeof(s));
+}
+
+/*****************************************************************************!
+ * Function : RandomBounded
+ *  Uniform on [0, InRange) without modulo bias.  Lemire's multiply and
+ *  shift, the division is only needed on the rare draws that land in the
+ *  biased low fraction.
+ *****************************************************************************/
+uint32_t
+RandomBounded
+(Random* InRandom, uint32_t InRange)
+{
+  uint64_t                              m;
+  uint32_t                              low, threshold;
+
+  if ( InRange == 0 ) {
+    return 0;
+  }
+  m = (RandomNext(InRandom) >> 32) * InRange;
+  low = (uint32_t)m;
+  if ( low < InRange ) {
+    threshold = -InRange % InRange;
+    while ( low < threshold ) {
+      m = (RandomNext(InRandom) >> 32) * InRange;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+
+/*****************************************************************************!
+ * Function : RandomBounded64
+ *  64 bit version of RandomBounded, for byte offsets.  Wide ranges reject
+ *  the draws below 2^64 mod InRange and reduce the rest, as the product
+ *  would need 128 bits, which 32 bit targets do not have.
+ *****************************************************************************/
+uint64_t
+RandomBounded64
+(Random* InRandom, uint64_t InRange)
+{
+  uint64_t                              x, threshold;
+
+  if ( InRange == 0 ) {
+    return 0;
+  }
+  if ( InRange <= UINT32_MAX ) {
+    return RandomBounded(InRandom, (uint32_t)InRange);
+  }
+  threshold = -InRange % InRange;
+  do {
+    x = RandomNext(InRandom);
+  } while ( x < threshold );
+  return x % InRange;
+}
+
+/*****************************************************************************!
+ * Function : RandomDouble
+ *  Uniform on (0, 1], safe to take the log of
+ *****************************************************************************/
+double
+RandomDouble
+(Random* InRandom)
+{
+  return ((RandomNext(InRandom) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/*****************************************************************************!
+ * Function : RandomGetTimeSeed
+ *  A seed for runs that did not ask for one
+ *****************************************************************************/
+uint64_t
+RandomGetTimeSeed
+()
+{
+  struct timespec                       now;
+  uint64_t                              seed;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  seed = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec ^ ((uint64_t)getpid() << 16);
+  return RandomSplitMix(&seed);
+}
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ * FILE NAME    : Random.h
+ * DATE         : January 25 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _random_h_
+#define _random_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : Random
+ *  xoshiro256** state.  Each worker owns one, there is no shared or locked
+ *  state, and streams started from one seed are 2^128 draws apart.
+ *****************************************************************************/
+struct _Random
+{
+  uint64_t                              s[4];
+};
+typedef struct _Random Random;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+void
+RandomInit
+(Random* InRandom, uint64_t InSeed);
+
+void
+RandomJump
+(Random* InRandom);
+
+uint64_t
+RandomNext
+(Random* InRandom);
+
+uint32_t
+RandomBounded
+(Random* InRandom, uint32_t InRange);
+
+uint64_t
+RandomBounded64
+(Random* InRandom, uint64_t InRange);
+
+double
+RandomDouble
+(Random* InRandom);
+
+uint64_t
+RandomGetTimeSeed
+();
+
+#endif // _random_h_
@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * FILE NAME    : RateLimiter.c
+ * DATE         : January 12 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "RateLimiter.h"
+#include "GeneralUtilities/MemoryManager.h"
+#include "TimeStamp.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static uint64_t
+RateLimiterGetStart
+(uint64_t* InNext, uint64_t InNow);
+
+/*****************************************************************************!
+ * Function : RateLimiterCreate
+ *****************************************************************************/
+RateLimiter*
+RateLimiterCreate
+(uint64_t InBytesPerSecond, uint64_t InOpsPerSecond)
+{
+  RateLimiter*                          limiter;
+
+  limiter = (RateLimiter*)GetMemory(sizeof(RateLimiter));
+  memset(limiter, 0x00, sizeof(RateLimiter));
+  pthread_mutex_init(&(limiter->lock), NULL);
+  limiter->bytesPerSecond = InBytesPerSecond;
+  limiter->opsPerSecond   = InOpsPerSecond;
+  limiter->bytesNext      = TimeStampGetMicroseconds();
+  limiter->opsNext        = limiter->bytesNext;
+  return limiter;
+}
+
+/*****************************************************************************!
+ * Function : RateLimiterDestroy
+ *****************************************************************************/
+void
+RateLimiterDestroy
+(RateLimiter* InLimiter)
+{
+  if ( NULL == InLimiter ) {
+    return;
+  }
+  pthread_mutex_destroy(&(InLimiter->lock));
+  FreeMemory(InLimiter);
+}
+
+/*****************************************************************************!
+ * Function : RateLimiterSetRates
+ *  Changes the rates of a running limiter.  Tokens owed at the old rates
+ *  are forgiven so a slower earlier rate does not hold up the new one.
+ *****************************************************************************/
+void
+RateLimiterSetRates
+(RateLimiter* InLimiter, uint64_t InBytesPerSecond, uint64_t InOpsPerSecond)
+{
+  uint64_t                              now;
+
+  pthread_mutex_lock(&(InLimiter->lock));
+  now = TimeStampGetMicroseconds();
+  InLimiter->bytesPerSecond = InBytesPerSecond;
+  InLimiter->opsPerSecond   = InOpsPerSecond;
+  InLimiter->bytesNext      = InLimiter->bytesNext > now ? now : InLimiter->bytesNext;
+  InLimiter->opsNext        = InLimiter->opsNext > now ? now : InLimiter->opsNext;
+  pthread_mutex_unlock(&(InLimiter->lock));
+}
+
+/*****************************************************************************!
+ * Function : RateLimiterGetStart
+ *  Drops credit older than the burst window and returns when the bucket next
+ *  has a token
+ *****************************************************************************/
+static uint64_t
+RateLimiterGetStart
+(uint64_t* InNext, uint64_t InNow)
+{
+  if ( *InNext + RATE_LIMITER_BURST < InNow ) {
+    *InNext = InNow - RATE_LIMITER_BURST;
+  }
+  return *InNext;
+}
+
+/*****************************************************************************!
+ * Function : RateLimiterGetDelay
+ *  Microseconds until the next operation may start, without taking a token
+ *****************************************************************************/
+uint64_t
+RateLimiterGetDelay
+(RateLimiter* InLimiter)
+{
+  uint64_t                              now, start, next;
+
+  pthread_mutex_lock(&(InLimiter->lock));
+  now = TimeStampGetMicroseconds();
+  start = 0;
+  if ( InLimiter->bytesPerSecond ) {
+    start = RateLimiterGetStart(&(InLimiter->bytesNext), now);
+  }
+  if ( InLimiter->opsPerSecond ) {
+    next = RateLimiterGetStart(&(InLimiter->opsNext), now);
+    start = next > start ? next : start;
+  }
+  pthread_mutex_unlock(&(InLimiter->lock));
+  return start > now ? start - now : 0;
+}
+
+/*****************************************************************************!
+ * Function : RateLimiterAcquire
+ *  Takes the tokens for one operation moving InBytes and returns how long the
+ *  caller has to wait before starting it.  The buckets advance on their own
+ *  timeline rather than from when the last operation finished, so the time
+ *  an operation takes does not lower the rate.
+ *****************************************************************************/
+uint64_t
+RateLimiterAcquire
+(RateLimiter* InLimiter, uint64_t InBytes)
+{
+  uint64_t                              now, start, next;
+
+  pthread_mutex_lock(&(InLimiter->lock));
+  now = TimeStampGetMicroseconds();
+  start = 0;
+  if ( InLimiter->bytesPerSecond ) {
+    start = RateLimiterGetStart(&(InLimiter->bytesNext), now);
+  }
+  if ( InLimiter->opsPerSecond ) {
+    next = RateLimiterGetStart(&(InLimiter->opsNext), now);
+    start = next > start ? next : start;
+  }
+  if ( InLimiter->bytesPerSecond ) {
+    InLimiter->bytesNext += InBytes * 1000000 / InLimiter->bytesPerSecond;
+  }
+  if ( InLimiter->opsPerSecond ) {
+    InLimiter->opsNext += 1000000 / InLimiter->opsPerSecond;
+  }
+  pthread_mutex_unlock(&(InLimiter->lock));
+  return start > now ? start - now : 0;
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************
+ * FILE NAME    : RateLimiter.h
+ * DATE         : January 12 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _ratelimiter_h_
+#define _ratelimiter_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <pthread.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Unused capacity is kept for at most this long (microseconds)
+#define RATE_LIMITER_BURST              100000
+
+/*****************************************************************************!
+ * Exported Type : RateLimiter
+ *  Token buckets for bytes and operations kept as the time each one next
+ *  has a token.  A bucket with a zero rate is not limited.
+ *****************************************************************************/
+struct _RateLimiter
+{
+  pthread_mutex_t                       lock;
+  uint64_t                              bytesPerSecond;
+  uint64_t                              opsPerSecond;
+  uint64_t                              bytesNext;
+  uint64_t                              opsNext;
+};
+typedef struct _RateLimiter RateLimiter;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+RateLimiter*
+RateLimiterCreate
+(uint64_t InBytesPerSecond, uint64_t InOpsPerSecond);
+
+void
+RateLimiterDestroy
+(RateLimiter* InLimiter);
+
+void
+RateLimiterSetRates
+(RateLimiter* InLimiter, uint64_t InBytesPerSecond, uint64_t InOpsPerSecond);
+
+uint64_t
+RateLimiterGetDelay
+(RateLimiter* InLimiter);
+
+uint64_t
+RateLimiterAcquire
+(RateLimiter* InLimiter, uint64_t InBytes);
+
+#endif // _ratelimiter_h_
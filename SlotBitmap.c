@@ -0,0 +1,480 @@
+/*****************************************************************************
+ * FILE NAME    : SlotBitmap.c
+ * DATE         : January 30 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "SlotBitmap.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static uint64_t
+SlotBitmapGetWord
+(SlotBitmap* InBitmap, uint64_t InWord, uint64_t InFirst, uint64_t InLast, bool InUsed);
+
+static uint64_t
+SlotBitmapGetNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode);
+
+static void
+SlotBitmapAddToNodes
+(SlotBitmap* InBitmap, uint64_t InSlot, uint64_t InDelta);
+
+static uint64_t
+SlotBitmapCountNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode, uint64_t InFirst, uint64_t InLast, bool InUsed);
+
+static int64_t
+SlotBitmapSelectNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode, uint64_t InFirst, uint64_t InLast, bool InUsed,
+ uint64_t InRank);
+
+static int
+SlotBitmapFindRange
+(SlotBitmap* InBitmap, uint64_t InSlot);
+
+static uint32_t
+SlotBitmapSelectInWord
+(uint64_t InWord, uint32_t InRank);
+
+/*****************************************************************************!
+ * Function : SlotBitmapCreate
+ *  Every slot starts free, the zero filled slot memory needs no clearing.
+ *  Levels are added above the groups until one node covers the bitmap.
+ *****************************************************************************/
+SlotBitmap*
+SlotBitmapCreate
+(uint64_t InSize)
+{
+  SlotBitmap*                           bitmap;
+  uint64_t                              counts[SLOT_BITMAP_LEVELS_MAX];
+  uint64_t                              sumCount;
+  uint64_t*                             sums;
+  int                                   level;
+
+  bitmap = (SlotBitmap*)GetMemory(sizeof(SlotBitmap));
+  memset(bitmap, 0x00, sizeof(SlotBitmap));
+  bitmap->size        = InSize;
+  bitmap->wordCount   = (InSize + SLOT_BITMAP_WORD_BITS - 1) / SLOT_BITMAP_WORD_BITS;
+  bitmap->groupCount  = (bitmap->wordCount + SLOT_BITMAP_GROUP_WORDS - 1) / SLOT_BITMAP_GROUP_WORDS;
+  bitmap->wordMemory  = SlotMemoryCreate(sizeof(uint64_t) * (bitmap->wordCount + 1));
+  bitmap->groupMemory = SlotMemoryCreate(sizeof(uint16_t) * (bitmap->groupCount + 1));
+  bitmap->words       = (uint64_t*)bitmap->wordMemory->base;
+  bitmap->groups      = (uint16_t*)bitmap->groupMemory->base;
+
+  counts[0] = bitmap->wordCount;
+  bitmap->spans[0] = SLOT_BITMAP_WORD_BITS;
+  sumCount = 0;
+  for ( level = 0 ; counts[level] > 1 && level + 1 < SLOT_BITMAP_LEVELS_MAX ; level++ ) {
+    counts[level + 1] = (counts[level] + SLOT_BITMAP_FANOUT - 1) / SLOT_BITMAP_FANOUT;
+    bitmap->spans[level + 1] = bitmap->spans[level] * SLOT_BITMAP_FANOUT;
+    if ( level + 1 > 1 ) {
+      sumCount += counts[level + 1];
+    }
+  }
+  bitmap->topLevel = level;
+
+  bitmap->sumMemory = SlotMemoryCreate(sizeof(uint64_t) * (sumCount + 1));
+  sums = (uint64_t*)bitmap->sumMemory->base;
+  for ( level = 2 ; level <= bitmap->topLevel ; level++ ) {
+    bitmap->sums[level] = sums;
+    sums += counts[level];
+  }
+  return bitmap;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapDestroy
+ *****************************************************************************/
+void
+SlotBitmapDestroy
+(SlotBitmap* InBitmap)
+{
+  if ( NULL == InBitmap ) {
+    return;
+  }
+  SlotMemoryDestroy(InBitmap->wordMemory);
+  SlotMemoryDestroy(InBitmap->groupMemory);
+  SlotMemoryDestroy(InBitmap->sumMemory);
+  if ( InBitmap->rangeCount ) {
+    FreeMemory(InBitmap->rangeFirst);
+    FreeMemory(InBitmap->rangeLast);
+    FreeMemory(InBitmap->rangeUsed);
+  }
+  FreeMemory(InBitmap);
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapGetResident
+ *****************************************************************************/
+uint64_t
+SlotBitmapGetResident
+(SlotBitmap* InBitmap)
+{
+  return SlotMemoryGetResident(InBitmap->wordMemory) + SlotMemoryGetResident(InBitmap->groupMemory) +
+         SlotMemoryGetResident(InBitmap->sumMemory);
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapAddRange
+ *  Keeps a running count for [InFirst, InLast), which must not overlap a
+ *  range already added.  Done before the workers start, the count starts
+ *  from whatever is already used.
+ *****************************************************************************/
+void
+SlotBitmapAddRange
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast)
+{
+  uint64_t*                             first;
+  uint64_t*                             last;
+  uint64_t*                             used;
+  int                                   i, n;
+
+  if ( InLast > InBitmap->size ) {
+    InLast = InBitmap->size;
+  }
+  if ( InFirst >= InLast ) {
+    return;
+  }
+  n = InBitmap->rangeCount;
+  first = (uint64_t*)GetMemory(sizeof(uint64_t) * (n + 1));
+  last  = (uint64_t*)GetMemory(sizeof(uint64_t) * (n + 1));
+  used  = (uint64_t*)GetMemory(sizeof(uint64_t) * (n + 1));
+
+  //! Kept in order of InFirst for the lookup in SlotBitmapFindRange
+  for ( i = n ; i > 0 && InBitmap->rangeFirst[i - 1] > InFirst ; i-- ) {
+    first[i] = InBitmap->rangeFirst[i - 1];
+    last[i]  = InBitmap->rangeLast[i - 1];
+    used[i]  = InBitmap->rangeUsed[i - 1];
+  }
+  first[i] = InFirst;
+  last[i]  = InLast;
+  used[i]  = SlotBitmapCountNode(InBitmap, InBitmap->topLevel, 0, InFirst, InLast, true);
+  if ( n ) {
+    memcpy(first, InBitmap->rangeFirst, sizeof(uint64_t) * i);
+    memcpy(last, InBitmap->rangeLast, sizeof(uint64_t) * i);
+    memcpy(used, InBitmap->rangeUsed, sizeof(uint64_t) * i);
+    FreeMemory(InBitmap->rangeFirst);
+    FreeMemory(InBitmap->rangeLast);
+    FreeMemory(InBitmap->rangeUsed);
+  }
+  InBitmap->rangeFirst = first;
+  InBitmap->rangeLast  = last;
+  InBitmap->rangeUsed  = used;
+  InBitmap->rangeCount = n + 1;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapSet
+ *  Marks InSlot used
+ *****************************************************************************/
+void
+SlotBitmapSet
+(SlotBitmap* InBitmap, uint64_t InSlot)
+{
+  uint64_t                              bit, old;
+
+  if ( InSlot >= InBitmap->size ) {
+    return;
+  }
+  bit = (uint64_t)1 << (InSlot % SLOT_BITMAP_WORD_BITS);
+  old = __atomic_fetch_or(&(InBitmap->words[InSlot / SLOT_BITMAP_WORD_BITS]), bit, __ATOMIC_RELAXED);
+  if ( !(old & bit) ) {
+    SlotBitmapAddToNodes(InBitmap, InSlot, 1);
+  }
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapClear
+ *  Marks InSlot free
+ *****************************************************************************/
+void
+SlotBitmapClear
+(SlotBitmap* InBitmap, uint64_t InSlot)
+{
+  uint64_t                              bit, old;
+
+  if ( InSlot >= InBitmap->size ) {
+    return;
+  }
+  bit = (uint64_t)1 << (InSlot % SLOT_BITMAP_WORD_BITS);
+  old = __atomic_fetch_and(&(InBitmap->words[InSlot / SLOT_BITMAP_WORD_BITS]), ~bit, __ATOMIC_RELAXED);
+  if ( old & bit ) {
+    SlotBitmapAddToNodes(InBitmap, InSlot, (uint64_t)-1);
+  }
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapTest
+ *****************************************************************************/
+bool
+SlotBitmapTest
+(SlotBitmap* InBitmap, uint64_t InSlot)
+{
+  uint64_t                              word;
+
+  if ( InSlot >= InBitmap->size ) {
+    return false;
+  }
+  word = __atomic_load_n(&(InBitmap->words[InSlot / SLOT_BITMAP_WORD_BITS]), __ATOMIC_RELAXED);
+  return (word >> (InSlot % SLOT_BITMAP_WORD_BITS)) & 1;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapCount
+ *  Used, or free, slots in [InFirst, InLast).  A registered range is its
+ *  running count, anything else is read from the count tree.
+ *****************************************************************************/
+uint64_t
+SlotBitmapCount
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast, bool InUsed)
+{
+  uint64_t                              used;
+  int                                   i;
+
+  if ( InLast > InBitmap->size ) {
+    InLast = InBitmap->size;
+  }
+  if ( InFirst >= InLast ) {
+    return 0;
+  }
+  i = SlotBitmapFindRange(InBitmap, InFirst);
+  if ( i >= 0 && InBitmap->rangeFirst[i] == InFirst && InBitmap->rangeLast[i] == InLast ) {
+    used = __atomic_load_n(&(InBitmap->rangeUsed[i]), __ATOMIC_RELAXED);
+    return InUsed ? used : (InLast - InFirst) - used;
+  }
+  return SlotBitmapCountNode(InBitmap, InBitmap->topLevel, 0, InFirst, InLast, InUsed);
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapSelect
+ *  A uniformly chosen used, or free, slot in [InFirst, InLast), -1 when
+ *  there is none.  A rank is drawn from the count and found by walking down
+ *  the count tree, skipping whole nodes by their counts, then bits by
+ *  clearing the lowest set bit, so the cost grows with the depth of the
+ *  tree rather than the size of the range.
+ *****************************************************************************/
+int64_t
+SlotBitmapSelect
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast, bool InUsed, Random* InRandom)
+{
+  uint64_t                              count;
+
+  count = SlotBitmapCount(InBitmap, InFirst, InLast, InUsed);
+  if ( count == 0 ) {
+    return -1;
+  }
+  if ( InLast > InBitmap->size ) {
+    InLast = InBitmap->size;
+  }
+
+  //! -1 when another thread changed a slot between the count and the walk
+  return SlotBitmapSelectNode(InBitmap, InBitmap->topLevel, 0, InFirst, InLast, InUsed,
+                              RandomBounded64(InRandom, count));
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapGetWord
+ *  Word InWord with the free slots set instead when InUsed is clear, and
+ *  the bits outside [InFirst, InLast) masked off
+ *****************************************************************************/
+static uint64_t
+SlotBitmapGetWord
+(SlotBitmap* InBitmap, uint64_t InWord, uint64_t InFirst, uint64_t InLast, bool InUsed)
+{
+  uint64_t                              word;
+  uint64_t                              low;
+
+  word = __atomic_load_n(&(InBitmap->words[InWord]), __ATOMIC_RELAXED);
+  if ( !InUsed ) {
+    word = ~word;
+  }
+  low = InWord * SLOT_BITMAP_WORD_BITS;
+  if ( InFirst > low ) {
+    word &= ~(uint64_t)0 << (InFirst - low);
+  }
+  if ( InLast < low + SLOT_BITMAP_WORD_BITS ) {
+    word &= ~(uint64_t)0 >> (SLOT_BITMAP_WORD_BITS - (InLast - low));
+  }
+  return word;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapGetNode
+ *  Used slots under node InNode of level InLevel
+ *****************************************************************************/
+static uint64_t
+SlotBitmapGetNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode)
+{
+  if ( InLevel == 0 ) {
+    return __builtin_popcountll(__atomic_load_n(&(InBitmap->words[InNode]), __ATOMIC_RELAXED));
+  }
+  if ( InLevel == 1 ) {
+    return __atomic_load_n(&(InBitmap->groups[InNode]), __ATOMIC_RELAXED);
+  }
+  return __atomic_load_n(&(InBitmap->sums[InLevel][InNode]), __ATOMIC_RELAXED);
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapAddToNodes
+ *  Applies a change of InDelta used slots at InSlot to every count above
+ *  its word, unsigned wrap around making -1 a decrement
+ *****************************************************************************/
+static void
+SlotBitmapAddToNodes
+(SlotBitmap* InBitmap, uint64_t InSlot, uint64_t InDelta)
+{
+  int                                   level, i;
+
+  __atomic_fetch_add(&(InBitmap->groups[InSlot / SLOT_BITMAP_GROUP_BITS]), (uint16_t)InDelta, __ATOMIC_RELAXED);
+  for ( level = 2 ; level <= InBitmap->topLevel ; level++ ) {
+    __atomic_fetch_add(&(InBitmap->sums[level][InSlot / InBitmap->spans[level]]), InDelta, __ATOMIC_RELAXED);
+  }
+  i = SlotBitmapFindRange(InBitmap, InSlot);
+  if ( i >= 0 ) {
+    __atomic_fetch_add(&(InBitmap->rangeUsed[i]), InDelta, __ATOMIC_RELAXED);
+  }
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapCountNode
+ *  Used, or free, slots under node InNode of level InLevel that lie in
+ *  [InFirst, InLast).  Nodes wholly inside are their count, only the two
+ *  edge nodes of each level are opened, InLast is within the bitmap.
+ *****************************************************************************/
+static uint64_t
+SlotBitmapCountNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode, uint64_t InFirst, uint64_t InLast, bool InUsed)
+{
+  uint64_t                              start, end, child, lastChild, used, count;
+
+  start = InNode * InBitmap->spans[InLevel];
+  end   = start + InBitmap->spans[InLevel];
+  if ( InFirst <= start && end <= InLast ) {
+    used = SlotBitmapGetNode(InBitmap, InLevel, InNode);
+    return InUsed ? used : InBitmap->spans[InLevel] - used;
+  }
+  if ( InLevel == 0 ) {
+    return __builtin_popcountll(SlotBitmapGetWord(InBitmap, InNode, InFirst, InLast, InUsed));
+  }
+  if ( InFirst > start ) {
+    start = InFirst;
+  }
+  if ( InLast < end ) {
+    end = InLast;
+  }
+  if ( start >= end ) {
+    return 0;
+  }
+  count = 0;
+  lastChild = (end - 1) / InBitmap->spans[InLevel - 1];
+  for ( child = start / InBitmap->spans[InLevel - 1] ; child <= lastChild ; child++ ) {
+    count += SlotBitmapCountNode(InBitmap, InLevel - 1, child, InFirst, InLast, InUsed);
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapSelectNode
+ *  The used, or free, slot of rank InRank among those under node InNode
+ *  that lie in [InFirst, InLast), -1 when the counts moved under the walk
+ *****************************************************************************/
+static int64_t
+SlotBitmapSelectNode
+(SlotBitmap* InBitmap, int InLevel, uint64_t InNode, uint64_t InFirst, uint64_t InLast, bool InUsed,
+ uint64_t InRank)
+{
+  uint64_t                              start, end, child, lastChild, n;
+  uint64_t                              word;
+
+  if ( InLevel == 0 ) {
+    word = SlotBitmapGetWord(InBitmap, InNode, InFirst, InLast, InUsed);
+    if ( InRank >= (uint64_t)__builtin_popcountll(word) ) {
+      return -1;
+    }
+    return (int64_t)(InNode * SLOT_BITMAP_WORD_BITS + SlotBitmapSelectInWord(word, (uint32_t)InRank));
+  }
+  start = InNode * InBitmap->spans[InLevel];
+  end   = start + InBitmap->spans[InLevel];
+  if ( InFirst > start ) {
+    start = InFirst;
+  }
+  if ( InLast < end ) {
+    end = InLast;
+  }
+  if ( start >= end ) {
+    return -1;
+  }
+  lastChild = (end - 1) / InBitmap->spans[InLevel - 1];
+  for ( child = start / InBitmap->spans[InLevel - 1] ; child <= lastChild ; child++ ) {
+    n = SlotBitmapCountNode(InBitmap, InLevel - 1, child, InFirst, InLast, InUsed);
+    if ( InRank < n ) {
+      return SlotBitmapSelectNode(InBitmap, InLevel - 1, child, InFirst, InLast, InUsed, InRank);
+    }
+    InRank -= n;
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapFindRange
+ *  The registered range holding InSlot, -1 when there is none
+ *****************************************************************************/
+static int
+SlotBitmapFindRange
+(SlotBitmap* InBitmap, uint64_t InSlot)
+{
+  int                                   low, high, middle;
+
+  low  = 0;
+  high = InBitmap->rangeCount;
+  while ( low < high ) {
+    middle = (low + high) / 2;
+    if ( InBitmap->rangeFirst[middle] <= InSlot ) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if ( low == 0 || InSlot >= InBitmap->rangeLast[low - 1] ) {
+    return -1;
+  }
+  return low - 1;
+}
+
+/*****************************************************************************!
+ * Function : SlotBitmapSelectInWord
+ *  Position of the set bit of rank InRank, counting from bit 0
+ *****************************************************************************/
+static uint32_t
+SlotBitmapSelectInWord
+(uint64_t InWord, uint32_t InRank)
+{
+  while ( InRank-- ) {
+    InWord &= InWord - 1;
+  }
+  return __builtin_ctzll(InWord);
+}
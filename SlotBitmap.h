@@ -0,0 +1,110 @@
+/*****************************************************************************
+ * FILE NAME    : SlotBitmap.h
+ * DATE         : January 30 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _slotbitmap_h_
+#define _slotbitmap_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "Random.h"
+#include "SlotMemory.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define SLOT_BITMAP_WORD_BITS           64
+
+//! Words summarised by one group count, 4096 slots
+#define SLOT_BITMAP_GROUP_WORDS         64
+#define SLOT_BITMAP_GROUP_BITS          (SLOT_BITMAP_WORD_BITS * SLOT_BITMAP_GROUP_WORDS)
+
+//! Each level of the count tree summarises 64 nodes of the one below, level
+//  0 being the words and level 1 the groups
+#define SLOT_BITMAP_FANOUT              64
+#define SLOT_BITMAP_LEVELS_MAX          12
+
+/*****************************************************************************!
+ * Exported Type : SlotBitmap
+ *  One bit per slot, set while the slot is used, so the free slots are the
+ *  clear bits.  groups[g] counts the used slots in words [g * 64, g * 64 +
+ *  64) and sums[l] counts them per 64 nodes of level l - 1, up to a single
+ *  node at topLevel, so a count or a selection only opens the nodes on the
+ *  edges of its range.  Registered ranges, the workers' slices, keep a
+ *  running count of their own.  Bits and counts are updated atomically as
+ *  neighbouring ranges may share a word.  All of it lives in slot memory,
+ *  so untouched parts of a large bitmap cost nothing.
+ *****************************************************************************/
+struct _SlotBitmap
+{
+  uint64_t*                             words;
+  uint16_t*                             groups;
+  uint64_t*                             sums[SLOT_BITMAP_LEVELS_MAX];
+  uint64_t                              spans[SLOT_BITMAP_LEVELS_MAX];
+  int                                   topLevel;
+  uint64_t                              size;
+  uint64_t                              wordCount;
+  uint64_t                              groupCount;
+  SlotMemory*                           wordMemory;
+  SlotMemory*                           groupMemory;
+  SlotMemory*                           sumMemory;
+  uint64_t*                             rangeFirst;
+  uint64_t*                             rangeLast;
+  uint64_t*                             rangeUsed;
+  int                                   rangeCount;
+};
+typedef struct _SlotBitmap SlotBitmap;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+SlotBitmap*
+SlotBitmapCreate
+(uint64_t InSize);
+
+void
+SlotBitmapDestroy
+(SlotBitmap* InBitmap);
+
+void
+SlotBitmapSet
+(SlotBitmap* InBitmap, uint64_t InSlot);
+
+void
+SlotBitmapClear
+(SlotBitmap* InBitmap, uint64_t InSlot);
+
+bool
+SlotBitmapTest
+(SlotBitmap* InBitmap, uint64_t InSlot);
+
+uint64_t
+SlotBitmapGetResident
+(SlotBitmap* InBitmap);
+
+void
+SlotBitmapAddRange
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast);
+
+uint64_t
+SlotBitmapCount
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast, bool InUsed);
+
+int64_t
+SlotBitmapSelect
+(SlotBitmap* InBitmap, uint64_t InFirst, uint64_t InLast, bool InUsed, Random* InRandom);
+
+#endif // _slotbitmap_h_
@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * FILE NAME    : SlotMemory.c
+ * DATE         : January 31 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "SlotMemory.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+//! Pages asked about per mincore() call when counting the resident ones
+#define SLOT_MEMORY_RESIDENT_CHUNK      4096
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static bool
+slotMemoryHugePages = false;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : SlotMemorySetHugePages
+ *  Applies to the mappings created afterwards
+ *****************************************************************************/
+void
+SlotMemorySetHugePages
+(bool InHugePages)
+{
+  slotMemoryHugePages = InHugePages;
+}
+
+/*****************************************************************************!
+ * Function : SlotMemoryGetHugePages
+ *****************************************************************************/
+bool
+SlotMemoryGetHugePages
+()
+{
+  return slotMemoryHugePages;
+}
+
+/*****************************************************************************!
+ * Function : SlotMemoryCreate
+ *  MAP_NORESERVE keeps a large, mostly untouched, set from being refused
+ *  under strict overcommit.  Huge pages are asked for with madvise rather
+ *  than MAP_HUGETLB, which would fault with SIGBUS once the reserved pool
+ *  ran out instead of falling back to small pages.  A size that does not
+ *  fit a size_t, as on a 32 bit system, is refused rather than truncated.
+ *****************************************************************************/
+SlotMemory*
+SlotMemoryCreate
+(uint64_t InSize)
+{
+  SlotMemory*                           memory;
+  long                                  pageSize;
+  void*                                 base;
+
+  pageSize = sysconf(_SC_PAGESIZE);
+  if ( InSize > (uint64_t)SIZE_MAX - pageSize ) {
+    fprintf(stderr, "Could not reserve %llu bytes for the slot set : %s\n",
+            (unsigned long long)InSize, strerror(ENOMEM));
+    exit(EXIT_FAILURE);
+  }
+  memory = (SlotMemory*)GetMemory(sizeof(SlotMemory));
+  memset(memory, 0x00, sizeof(SlotMemory));
+  memory->size = (InSize + pageSize - 1) / pageSize * pageSize;
+  if ( memory->size == 0 ) {
+    memory->size = pageSize;
+  }
+  base = mmap(NULL, (size_t)memory->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if ( base == MAP_FAILED ) {
+    fprintf(stderr, "Could not reserve %llu bytes for the slot set : %s\n",
+            (unsigned long long)memory->size, strerror(errno));
+    exit(EXIT_FAILURE);
+  }
+  memory->base = (uint8_t*)base;
+  if ( slotMemoryHugePages ) {
+    memory->hugePages = madvise(base, memory->size, MADV_HUGEPAGE) == 0;
+  }
+  return memory;
+}
+
+/*****************************************************************************!
+ * Function : SlotMemoryDestroy
+ *****************************************************************************/
+void
+SlotMemoryDestroy
+(SlotMemory* InMemory)
+{
+  if ( NULL == InMemory ) {
+    return;
+  }
+  munmap(InMemory->base, InMemory->size);
+  FreeMemory(InMemory);
+}
+
+/*****************************************************************************!
+ * Function : SlotMemoryGetResident
+ *  Bytes of the mapping currently backed by memory, 0 if it cannot be told.
+ *  Walks every page of the reservation, callers sample it rather than ask
+ *  on every report.
+ *****************************************************************************/
+uint64_t
+SlotMemoryGetResident
+(SlotMemory* InMemory)
+{
+  unsigned char                         pages[SLOT_MEMORY_RESIDENT_CHUNK];
+  uint64_t                              i, n, offset, pageCount, resident;
+  long                                  pageSize;
+
+  if ( NULL == InMemory ) {
+    return 0;
+  }
+  pageSize = sysconf(_SC_PAGESIZE);
+  pageCount = InMemory->size / pageSize;
+  resident = 0;
+  for ( offset = 0 ; offset < pageCount ; offset += n ) {
+    n = pageCount - offset < SLOT_MEMORY_RESIDENT_CHUNK ? pageCount - offset : SLOT_MEMORY_RESIDENT_CHUNK;
+    if ( mincore(InMemory->base + offset * pageSize, n * pageSize, pages) ) {
+      return 0;
+    }
+    for ( i = 0 ; i < n ; i++ ) {
+      if ( pages[i] & 1 ) {
+        resident += pageSize;
+      }
+    }
+  }
+  return resident;
+}
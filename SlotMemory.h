@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * FILE NAME    : SlotMemory.h
+ * DATE         : January 31 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _slotmemory_h_
+#define _slotmemory_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Type : SlotMemory
+ *  A zero filled anonymous mapping for the per slot tables.  Only address
+ *  space is reserved up front, pages are backed as they are first touched,
+ *  so a set sized for billions of slots costs what its used slots cost.
+ *  hugePages is set when transparent huge pages were requested for it.
+ *****************************************************************************/
+struct _SlotMemory
+{
+  uint8_t*                              base;
+  uint64_t                              size;
+  bool                                  hugePages;
+};
+typedef struct _SlotMemory SlotMemory;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+void
+SlotMemorySetHugePages
+(bool InHugePages);
+
+bool
+SlotMemoryGetHugePages
+();
+
+SlotMemory*
+SlotMemoryCreate
+(uint64_t InSize);
+
+void
+SlotMemoryDestroy
+(SlotMemory* InMemory);
+
+uint64_t
+SlotMemoryGetResident
+(SlotMemory* InMemory);
+
+#endif // _slotmemory_h_
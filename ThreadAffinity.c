@@ -0,0 +1,430 @@
+/*****************************************************************************
+ * FILE NAME    : ThreadAffinity.c
+ * DATE         : January 29 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "ThreadAffinity.h"
+#include "GeneralUtilities/MemoryManager.h"
+#include "GeneralUtilities/ANSIColors.h"
+#include "Log.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define THREAD_AFFINITY_IOPRIO_WHO_PROCESS      1
+#define THREAD_AFFINITY_IOPRIO_CLASS_SHIFT      13
+#define THREAD_AFFINITY_IOPRIO_LEVELS           8
+#define ThreadAffinityIOPrio(c, l)      (((c) << THREAD_AFFINITY_IOPRIO_CLASS_SHIFT) | (l))
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+//! Worker n runs on threadAffinityWorkerCPUs[n % count]
+static int
+threadAffinityWorkerCPUs[THREAD_AFFINITY_LIST_MAX];
+
+static int
+threadAffinityWorkerCPUCount = 0;
+
+static string
+threadAffinityWorkerCPUSpec = NULL;
+
+//! The server threads share the whole set
+static cpu_set_t
+threadAffinityServerCPUs;
+
+static bool
+threadAffinityServerCPUsSet = false;
+
+static string
+threadAffinityServerCPUSpec = NULL;
+
+//! Worker n gets threadAffinityWorkerIOPrio[n % count], ioprio_set values
+static int
+threadAffinityWorkerIOPrio[THREAD_AFFINITY_LIST_MAX];
+
+static int
+threadAffinityWorkerIOPrioCount = 0;
+
+static string
+threadAffinityWorkerIOPrioSpec = NULL;
+
+//! Threads register from their own context, serverinfo reads from the
+//  web socket thread
+static pthread_mutex_t
+threadAffinityMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static ThreadAffinityEntry*
+threadAffinityEntries = NULL;
+
+static int
+threadAffinityEntryCount = 0;
+
+static int
+threadAffinityEntrySize = 0;
+
+static string
+threadAffinityIOClassNames[] = { "none", "rt", "be", "idle" };
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static int
+ThreadAffinityParseCPUs
+(string InSpec, int* InCPUs);
+
+static void
+ThreadAffinityApply
+(string InName, cpu_set_t* InCPUs, int InIOPrio);
+
+static void
+ThreadAffinityFormatCPUs
+(cpu_set_t* InCPUs, char* InBuffer, int InSize);
+
+/*****************************************************************************!
+ * Function : ThreadAffinitySetWorkerCPUs
+ *  <cpu>[-<cpu>],... each worker is pinned to one of the CPUs in turn
+ *****************************************************************************/
+bool
+ThreadAffinitySetWorkerCPUs
+(string InSpec)
+{
+  int                                   count;
+
+  count = ThreadAffinityParseCPUs(InSpec, threadAffinityWorkerCPUs);
+  if ( count == 0 ) {
+    return false;
+  }
+  threadAffinityWorkerCPUCount = count;
+  if ( threadAffinityWorkerCPUSpec ) {
+    FreeMemory(threadAffinityWorkerCPUSpec);
+  }
+  threadAffinityWorkerCPUSpec = StringCopy(InSpec);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinitySetServerCPUs
+ *  <cpu>[-<cpu>],... the server threads may run on any of them
+ *****************************************************************************/
+bool
+ThreadAffinitySetServerCPUs
+(string InSpec)
+{
+  int                                   cpus[THREAD_AFFINITY_LIST_MAX];
+  int                                   i, count;
+
+  count = ThreadAffinityParseCPUs(InSpec, cpus);
+  if ( count == 0 ) {
+    return false;
+  }
+  CPU_ZERO(&threadAffinityServerCPUs);
+  for ( i = 0 ; i < count ; i++ ) {
+    CPU_SET(cpus[i], &threadAffinityServerCPUs);
+  }
+  threadAffinityServerCPUsSet = true;
+  if ( threadAffinityServerCPUSpec ) {
+    FreeMemory(threadAffinityServerCPUSpec);
+  }
+  threadAffinityServerCPUSpec = StringCopy(InSpec);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinitySetWorkerIOPriority
+ *  <class>[:<level>],... with class rt, be or idle and level 0 (highest) to
+ *  7, given to the workers in turn.  idle takes no level.
+ *****************************************************************************/
+bool
+ThreadAffinitySetWorkerIOPriority
+(string InSpec)
+{
+  int                                   values[THREAD_AFFINITY_LIST_MAX];
+  string                                spec;
+  string                                entry;
+  string                                next;
+  string                                level;
+  string                                end;
+  int                                   ioClass, ioLevel, count;
+
+  spec = StringCopy(InSpec);
+  count = 0;
+  for ( entry = spec ; entry ; entry = next ) {
+    next = strchr(entry, ',');
+    if ( next ) {
+      *next++ = 0x00;
+    }
+    level = strchr(entry, ':');
+    if ( level ) {
+      *level++ = 0x00;
+    }
+    if ( StringEqual(entry, "rt") ) {
+      ioClass = THREAD_AFFINITY_IOPRIO_RT;
+    } else if ( StringEqual(entry, "be") ) {
+      ioClass = THREAD_AFFINITY_IOPRIO_BE;
+    } else if ( StringEqual(entry, "idle") ) {
+      ioClass = THREAD_AFFINITY_IOPRIO_IDLE;
+    } else {
+      break;
+    }
+    ioLevel = ioClass == THREAD_AFFINITY_IOPRIO_IDLE ? 0 : 4;
+    if ( level ) {
+      if ( ioClass == THREAD_AFFINITY_IOPRIO_IDLE || *level == 0x00 ) {
+        break;
+      }
+      ioLevel = (int)strtol(level, &end, 10);
+      if ( *end != 0x00 || ioLevel < 0 || ioLevel >= THREAD_AFFINITY_IOPRIO_LEVELS ) {
+        break;
+      }
+    }
+    if ( count == THREAD_AFFINITY_LIST_MAX ) {
+      break;
+    }
+    values[count++] = ThreadAffinityIOPrio(ioClass, ioLevel);
+  }
+  FreeMemory(spec);
+  if ( entry ) {
+    return false;
+  }
+
+  memcpy(threadAffinityWorkerIOPrio, values, sizeof(int) * count);
+  threadAffinityWorkerIOPrioCount = count;
+  if ( threadAffinityWorkerIOPrioSpec ) {
+    FreeMemory(threadAffinityWorkerIOPrioSpec);
+  }
+  threadAffinityWorkerIOPrioSpec = StringCopy(InSpec);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityParseCPUs
+ *  Returns the number of CPUs in InSpec, 0 if it is malformed or names a
+ *  CPU this machine does not have
+ *****************************************************************************/
+static int
+ThreadAffinityParseCPUs
+(string InSpec, int* InCPUs)
+{
+  string                                s;
+  string                                end;
+  long                                  first, last, cpus;
+  int                                   count;
+
+  cpus = sysconf(_SC_NPROCESSORS_CONF);
+  if ( cpus > CPU_SETSIZE ) {
+    cpus = CPU_SETSIZE;
+  }
+  count = 0;
+  s = InSpec;
+  while ( true ) {
+    first = strtol(s, &end, 10);
+    if ( end == s || first < 0 ) {
+      return 0;
+    }
+    last = first;
+    if ( *end == '-' ) {
+      s = end + 1;
+      last = strtol(s, &end, 10);
+      if ( end == s || last < first ) {
+        return 0;
+      }
+    }
+    if ( last >= cpus || count + (last - first + 1) > THREAD_AFFINITY_LIST_MAX ) {
+      return 0;
+    }
+    for ( ; first <= last ; first++ ) {
+      InCPUs[count++] = (int)first;
+    }
+    if ( *end == 0x00 ) {
+      return count;
+    }
+    if ( *end != ',' ) {
+      return 0;
+    }
+    s = end + 1;
+  }
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityApplyServer
+ *  Called by a server thread as it starts
+ *****************************************************************************/
+void
+ThreadAffinityApplyServer
+(string InName)
+{
+  ThreadAffinityApply(InName, threadAffinityServerCPUsSet ? &threadAffinityServerCPUs : NULL, -1);
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityApplyWorker
+ *  Called by stress worker InWorker as it starts
+ *****************************************************************************/
+void
+ThreadAffinityApplyWorker
+(string InName, int InWorker)
+{
+  cpu_set_t                             cpus;
+  cpu_set_t*                            cpusPtr;
+  int                                   ioPrio;
+
+  cpusPtr = NULL;
+  if ( threadAffinityWorkerCPUCount ) {
+    CPU_ZERO(&cpus);
+    CPU_SET(threadAffinityWorkerCPUs[InWorker % threadAffinityWorkerCPUCount], &cpus);
+    cpusPtr = &cpus;
+  }
+  ioPrio = threadAffinityWorkerIOPrioCount ? threadAffinityWorkerIOPrio[InWorker % threadAffinityWorkerIOPrioCount] : -1;
+  ThreadAffinityApply(InName, cpusPtr, ioPrio);
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityApply
+ *  Applies to the calling thread and records what it ended up with, so
+ *  unpinned threads are reported too.  A failure is logged and the thread
+ *  carries on as it was.
+ *****************************************************************************/
+static void
+ThreadAffinityApply
+(string InName, cpu_set_t* InCPUs, int InIOPrio)
+{
+  ThreadAffinityEntry*                  entries;
+  ThreadAffinityEntry*                  entry;
+  cpu_set_t                             cpus;
+  pid_t                                 tid;
+  string                                error;
+  int                                   i, ioPrio;
+
+  tid = (pid_t)syscall(SYS_gettid);
+  error = NULL;
+  if ( InCPUs && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), InCPUs) ) {
+    error = "could not set the CPU affinity";
+  }
+  if ( NULL == error && InIOPrio >= 0 &&
+       syscall(SYS_ioprio_set, THREAD_AFFINITY_IOPRIO_WHO_PROCESS, tid, InIOPrio) ) {
+    error = errno == EPERM ? "not permitted to set the I/O priority" : "could not set the I/O priority";
+  }
+  if ( error ) {
+    LogAppend("%-24s : %s", InName, error);
+    fprintf(stderr, "%s%s : %s%s\n", ColorRed, InName, error, ColorReset);
+  }
+
+  pthread_mutex_lock(&threadAffinityMutex);
+  for ( i = 0 ; i < threadAffinityEntryCount ; i++ ) {
+    if ( StringEqual(threadAffinityEntries[i].name, InName) ) {
+      break;
+    }
+  }
+  if ( i == threadAffinityEntrySize ) {
+    threadAffinityEntrySize = threadAffinityEntrySize ? threadAffinityEntrySize * 2 : 16;
+    entries = (ThreadAffinityEntry*)GetMemory(sizeof(ThreadAffinityEntry) * threadAffinityEntrySize);
+    if ( threadAffinityEntries ) {
+      memcpy(entries, threadAffinityEntries, sizeof(ThreadAffinityEntry) * threadAffinityEntryCount);
+      FreeMemory(threadAffinityEntries);
+    }
+    threadAffinityEntries = entries;
+  }
+  entry = &(threadAffinityEntries[i]);
+  if ( i == threadAffinityEntryCount ) {
+    entry->name = StringCopy(InName);
+    threadAffinityEntryCount++;
+  }
+  entry->tid   = tid;
+  entry->error = error;
+
+  CPU_ZERO(&cpus);
+  pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+  ThreadAffinityFormatCPUs(&cpus, entry->cpus, sizeof(entry->cpus));
+  ioPrio = (int)syscall(SYS_ioprio_get, THREAD_AFFINITY_IOPRIO_WHO_PROCESS, tid);
+  if ( ioPrio < 0 ) {
+    ioPrio = 0;
+  }
+  entry->ioClass = (ioPrio >> THREAD_AFFINITY_IOPRIO_CLASS_SHIFT) & 0x03;
+  entry->ioLevel = ioPrio & ((1 << THREAD_AFFINITY_IOPRIO_CLASS_SHIFT) - 1);
+  pthread_mutex_unlock(&threadAffinityMutex);
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityFormatCPUs
+ *  Back to the <cpu>[-<cpu>],... form
+ *****************************************************************************/
+static void
+ThreadAffinityFormatCPUs
+(cpu_set_t* InCPUs, char* InBuffer, int InSize)
+{
+  int                                   cpu, last, n;
+
+  n = 0;
+  *InBuffer = 0x00;
+  for ( cpu = 0 ; cpu < CPU_SETSIZE && n < InSize ; cpu++ ) {
+    if ( !CPU_ISSET(cpu, InCPUs) ) {
+      continue;
+    }
+    for ( last = cpu ; last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, InCPUs) ; last++ ) {
+    }
+    if ( last == cpu ) {
+      n += snprintf(InBuffer + n, InSize - n, "%s%d", n ? "," : "", cpu);
+    } else {
+      n += snprintf(InBuffer + n, InSize - n, "%s%d-%d", n ? "," : "", cpu, last);
+    }
+    cpu = last;
+  }
+}
+
+/*****************************************************************************!
+ * Function : ThreadAffinityToJSON
+ *****************************************************************************/
+JSONOut*
+ThreadAffinityToJSON
+(string InName)
+{
+  JSONOut*                              object;
+  JSONOut*                              threads;
+  JSONOut*                              thread;
+  ThreadAffinityEntry*                  entry;
+  int                                   i;
+
+  threads = JSONOutCreateArray("threads");
+  pthread_mutex_lock(&threadAffinityMutex);
+  for ( i = 0 ; i < threadAffinityEntryCount ; i++ ) {
+    entry = &(threadAffinityEntries[i]);
+    thread = JSONOutCreateObject(NULL);
+    JSONOutObjectAddObjects(thread,
+                            JSONOutCreateString("name", entry->name),
+                            JSONOutCreateInt("tid", entry->tid),
+                            JSONOutCreateString("cpus", entry->cpus),
+                            JSONOutCreateString("ioclass", threadAffinityIOClassNames[entry->ioClass]),
+                            JSONOutCreateInt("iolevel", entry->ioLevel),
+                            JSONOutCreateString("error", entry->error ? entry->error : ""),
+                            NULL);
+    JSONOutArrayAddObject(threads, thread);
+  }
+  pthread_mutex_unlock(&threadAffinityMutex);
+
+  object = JSONOutCreateObject(InName);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("workercpus", threadAffinityWorkerCPUSpec ? threadAffinityWorkerCPUSpec : ""),
+                          JSONOutCreateString("servercpus", threadAffinityServerCPUSpec ? threadAffinityServerCPUSpec : ""),
+                          JSONOutCreateString("workerioprio", threadAffinityWorkerIOPrioSpec ? threadAffinityWorkerIOPrioSpec : ""),
+                          threads,
+                          NULL);
+  return object;
+}
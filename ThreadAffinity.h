@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * FILE NAME    : ThreadAffinity.h
+ * DATE         : January 29 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _threadaffinity_h_
+#define _threadaffinity_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdbool.h>
+#include <sys/types.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "JSONOut.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+//! Entries in a worker CPU or I/O priority list
+#define THREAD_AFFINITY_LIST_MAX        256
+
+//! The kernel's ioprio classes, glibc has no header for them
+#define THREAD_AFFINITY_IOPRIO_NONE     0
+#define THREAD_AFFINITY_IOPRIO_RT       1
+#define THREAD_AFFINITY_IOPRIO_BE       2
+#define THREAD_AFFINITY_IOPRIO_IDLE     3
+
+/*****************************************************************************!
+ * Exported Type : ThreadAffinityEntry
+ *  What a thread ended up with, read back after applying the settings.
+ *  error is the first failure, NULL if there was none.
+ *****************************************************************************/
+struct _ThreadAffinityEntry
+{
+  string                                name;
+  pid_t                                 tid;
+  char                                  cpus[128];
+  int                                   ioClass;
+  int                                   ioLevel;
+  string                                error;
+};
+typedef struct _ThreadAffinityEntry ThreadAffinityEntry;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+bool
+ThreadAffinitySetWorkerCPUs
+(string InSpec);
+
+bool
+ThreadAffinitySetServerCPUs
+(string InSpec);
+
+bool
+ThreadAffinitySetWorkerIOPriority
+(string InSpec);
+
+void
+ThreadAffinityApplyServer
+(string InName);
+
+void
+ThreadAffinityApplyWorker
+(string InName, int InWorker);
+
+JSONOut*
+ThreadAffinityToJSON
+(string InName);
+
+#endif // _threadaffinity_h_
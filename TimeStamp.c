@@ -0,0 +1,59 @@
+/*****************************************************************************
+ * FILE NAME    : TimeStamp.c
+ * DATE         : January 04 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "TimeStamp.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Function : TimeStampGetMicroseconds
+ *  Monotonic clock, safe to use for intervals across wall clock changes
+ *****************************************************************************/
+uint64_t
+TimeStampGetMicroseconds
+()
+{
+  struct timespec                       ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+/*****************************************************************************!
+ * Function : TimeStampComputeRate
+ *  Returns MB/s (10^6 bytes) which conveniently is bytes per microsecond
+ *****************************************************************************/
+double
+TimeStampComputeRate
+(uint64_t InBytes, uint64_t InMicroseconds)
+{
+  if ( InMicroseconds == 0 ) {
+    return 0.0;
+  }
+  return (double)InBytes / (double)InMicroseconds;
+}
@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * FILE NAME    : TimeStamp.h
+ * DATE         : January 04 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _timestamp_h_
+#define _timestamp_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+uint64_t
+TimeStampGetMicroseconds
+();
+
+double
+TimeStampComputeRate
+(uint64_t InBytes, uint64_t InMicroseconds);
+
+#endif // _timestamp_h_
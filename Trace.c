@@ -0,0 +1,461 @@
+/*****************************************************************************
+ * FILE NAME    : Trace.c
+ * DATE         : January 28 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "Trace.h"
+#include "GeneralUtilities/MemoryManager.h"
+#include "TimeStamp.h"
+#include "ThreadAffinity.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define TRACE_RING_MASK                 (TRACE_RING_SIZE - 1)
+
+//! Records read from a trace file at a time
+#define TRACE_READ_BATCH                256
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static string
+traceOpNames[TRACE_OP_COUNT] = { "create", "remove", "read", "overwrite", "append", "close", "verify",
+                                 "sync", "createempty", "stat", "rename", "setattr", "unlink" };
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static Trace*
+TraceAllocate
+(string InPath, FILE* InFile, int InRingCount);
+
+static void*
+TraceWriterThread
+(void* InParameters);
+
+static void
+TraceDrain
+(Trace* InTrace);
+
+static void*
+TraceReaderThread
+(void* InParameters);
+
+static bool
+TraceReadHeader
+(string InPath, FILE* InFile, TraceHeader* InHeader);
+
+/*****************************************************************************!
+ * Function : TraceCreate
+ *  Starts recording to InPath.  The rest of the header describes the run
+ *  so a replay can size its file set the same way.
+ *****************************************************************************/
+Trace*
+TraceCreate
+(string InPath, int InWorkers, uint32_t InMaxFiles, uint64_t InMaxFileSize, uint32_t InAppendFiles)
+{
+  Trace*                                trace;
+  FILE*                                 file;
+  struct timespec                       now;
+
+  //! A record has a byte for the worker
+  if ( InWorkers < 1 || InWorkers > 256 ) {
+    fprintf(stderr, "Could not create trace file %s : traces hold 1 to 256 workers\n", InPath);
+    return NULL;
+  }
+  file = fopen(InPath, "wb");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not create trace file %s : %s\n", InPath, strerror(errno));
+    return NULL;
+  }
+  trace = TraceAllocate(InPath, file, InWorkers);
+  clock_gettime(CLOCK_REALTIME, &now);
+  memcpy(trace->header.magic, TRACE_MAGIC, sizeof(trace->header.magic));
+  trace->header.version     = TRACE_VERSION;
+  trace->header.recordSize  = sizeof(TraceRecord);
+  trace->header.workers     = InWorkers;
+  trace->header.maxFiles    = InMaxFiles;
+  trace->header.appendFiles = InAppendFiles;
+  trace->header.maxFileSize = InMaxFileSize;
+  trace->header.startTime   = (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+  if ( fwrite(&(trace->header), sizeof(TraceHeader), 1, file) != 1 ) {
+    fprintf(stderr, "Could not write trace file %s : %s\n", InPath, strerror(errno));
+    fclose(file);
+    return NULL;
+  }
+  trace->running = true;
+  if ( pthread_create(&(trace->threadID), NULL, TraceWriterThread, trace) ) {
+    fprintf(stderr, "Could not start \"Trace Writer\"\n");
+    fclose(file);
+    return NULL;
+  }
+  return trace;
+}
+
+/*****************************************************************************!
+ * Function : TraceAllocate
+ *****************************************************************************/
+static Trace*
+TraceAllocate
+(string InPath, FILE* InFile, int InRingCount)
+{
+  Trace*                                trace;
+  int                                   i;
+  void*                                 rings;
+
+  trace = (Trace*)GetMemory(sizeof(Trace));
+  memset(trace, 0x00, sizeof(Trace));
+  trace->path      = StringCopy(InPath);
+  trace->file      = InFile;
+  trace->ringCount = InRingCount;
+  //! GetMemory only promises malloc alignment, not the cache line the
+  //  head and tail attributes ask for
+  if ( posix_memalign(&rings, TRACE_RING_ALIGNMENT, sizeof(TraceRing) * InRingCount) ) {
+    fprintf(stderr, "Could not allocate %d trace rings\n", InRingCount);
+    exit(EXIT_FAILURE);
+  }
+  trace->rings     = (TraceRing*)rings;
+  memset(trace->rings, 0x00, sizeof(TraceRing) * InRingCount);
+  for ( i = 0 ; i < InRingCount ; i++ ) {
+    trace->rings[i].records = (TraceRecord*)GetMemory(sizeof(TraceRecord) * TRACE_RING_SIZE);
+  }
+  trace->startTime = TimeStampGetMicroseconds();
+  return trace;
+}
+
+/*****************************************************************************!
+ * Function : TraceAdd
+ *  Called by worker InWorker after an operation that took InLatency
+ *  microseconds.  Never waits, a record that does not fit in the ring is
+ *  counted as dropped.
+ *****************************************************************************/
+void
+TraceAdd
+(Trace* InTrace, int InWorker, TraceOp InOp, uint32_t InSlot, uint64_t InOffset, uint64_t InSize,
+ uint64_t InLatency, int32_t InResult)
+{
+  TraceRing*                            ring;
+  TraceRecord*                          record;
+  uint64_t                              head, tail, start;
+
+  if ( NULL == InTrace || !__atomic_load_n(&(InTrace->running), __ATOMIC_RELAXED) ) {
+    return;
+  }
+  ring = &(InTrace->rings[InWorker]);
+  head = ring->head;
+  tail = __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE);
+  if ( head - tail >= TRACE_RING_SIZE ) {
+    __atomic_fetch_add(&(ring->dropped), 1, __ATOMIC_RELAXED);
+    return;
+  }
+  start = TimeStampGetMicroseconds() - InLatency;
+  record = &(ring->records[head & TRACE_RING_MASK]);
+  record->timestamp = start > InTrace->startTime ? start - InTrace->startTime : 0;
+  record->offset    = InOffset;
+  record->size      = InSize;
+  record->slot      = InSlot;
+  record->latency   = InLatency > UINT32_MAX ? UINT32_MAX : (uint32_t)InLatency;
+  record->result    = InResult;
+  record->op        = (uint8_t)InOp;
+  record->worker    = (uint8_t)InWorker;
+  record->reserved  = 0;
+  __atomic_store_n(&(ring->head), head + 1, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************!
+ * Function : TraceClose
+ *  Stops the writer after a last drain and closes the file.  The rings are
+ *  left allocated, a worker may still be adding a record.
+ *****************************************************************************/
+void
+TraceClose
+(Trace* InTrace)
+{
+  if ( NULL == InTrace || InTrace->reading || !InTrace->running ) {
+    return;
+  }
+  __atomic_store_n(&(InTrace->running), false, __ATOMIC_RELEASE);
+  pthread_join(InTrace->threadID, NULL);
+  fclose(InTrace->file);
+  InTrace->file = NULL;
+}
+
+/*****************************************************************************!
+ * Function : TraceWriterThread
+ *****************************************************************************/
+static void*
+TraceWriterThread
+(void* InParameters)
+{
+  Trace*                                trace;
+
+  trace = (Trace*)InParameters;
+  ThreadAffinityApplyServer("tracewriter");
+  while ( __atomic_load_n(&(trace->running), __ATOMIC_ACQUIRE) ) {
+    usleep(TRACE_WRITER_PERIOD);
+    TraceDrain(trace);
+  }
+  TraceDrain(trace);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : TraceDrain
+ *  Writes what each ring holds straight from the ring, in at most two
+ *  pieces when it wraps
+ *****************************************************************************/
+static void
+TraceDrain
+(Trace* InTrace)
+{
+  TraceRing*                            ring;
+  uint64_t                              head, tail, start, n;
+  int                                   i;
+
+  for ( i = 0 ; i < InTrace->ringCount ; i++ ) {
+    ring = &(InTrace->rings[i]);
+    tail = ring->tail;
+    head = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+    while ( tail < head ) {
+      start = tail & TRACE_RING_MASK;
+      n = head - tail;
+      if ( start + n > TRACE_RING_SIZE ) {
+        n = TRACE_RING_SIZE - start;
+      }
+      if ( fwrite(&(ring->records[start]), sizeof(TraceRecord), n, InTrace->file) != n ) {
+        fprintf(stderr, "Could not write trace file %s : %s\n", InTrace->path, strerror(errno));
+      }
+      tail += n;
+    }
+    __atomic_fetch_add(&(InTrace->records), tail - ring->tail, __ATOMIC_RELAXED);
+    __atomic_store_n(&(ring->tail), tail, __ATOMIC_RELEASE);
+  }
+  fflush(InTrace->file);
+}
+
+/*****************************************************************************!
+ * Function : TraceOpen
+ *  Opens a trace for replay.  A reader thread sorts the records into one
+ *  ring per recorded worker, so the file is streamed rather than loaded.
+ *****************************************************************************/
+Trace*
+TraceOpen
+(string InPath)
+{
+  Trace*                                trace;
+  FILE*                                 file;
+  TraceHeader                           header;
+
+  file = fopen(InPath, "rb");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not open trace file %s : %s\n", InPath, strerror(errno));
+    return NULL;
+  }
+  if ( !TraceReadHeader(InPath, file, &header) ) {
+    fclose(file);
+    return NULL;
+  }
+  trace = TraceAllocate(InPath, file, header.workers);
+  trace->header  = header;
+  trace->reading = true;
+  trace->running = true;
+  if ( pthread_create(&(trace->threadID), NULL, TraceReaderThread, trace) ) {
+    fprintf(stderr, "Could not start \"Trace Reader\"\n");
+    fclose(file);
+    return NULL;
+  }
+  return trace;
+}
+
+/*****************************************************************************!
+ * Function : TraceReaderThread
+ *  Waits for room rather than dropping, a replay has to see every record
+ *****************************************************************************/
+static void*
+TraceReaderThread
+(void* InParameters)
+{
+  Trace*                                trace;
+  TraceRing*                            ring;
+  TraceRecord                           records[TRACE_READ_BATCH];
+  size_t                                i, n;
+  uint64_t                              head;
+
+  trace = (Trace*)InParameters;
+  ThreadAffinityApplyServer("tracereader");
+  while ( (n = fread(records, sizeof(TraceRecord), TRACE_READ_BATCH, trace->file)) > 0 ) {
+    for ( i = 0 ; i < n ; i++ ) {
+      if ( records[i].worker >= trace->ringCount ) {
+        continue;
+      }
+      ring = &(trace->rings[records[i].worker]);
+      head = ring->head;
+      while ( head - __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE) >= TRACE_RING_SIZE ) {
+        usleep(1000);
+      }
+      ring->records[head & TRACE_RING_MASK] = records[i];
+      __atomic_store_n(&(ring->head), head + 1, __ATOMIC_RELEASE);
+      __atomic_fetch_add(&(trace->records), 1, __ATOMIC_RELAXED);
+    }
+  }
+  fclose(trace->file);
+  trace->file = NULL;
+  __atomic_store_n(&(trace->done), true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+/*****************************************************************************!
+ * Function : TraceNext
+ *  The next record for worker InWorker, false once its records are used up
+ *****************************************************************************/
+bool
+TraceNext
+(Trace* InTrace, int InWorker, TraceRecord* InRecord)
+{
+  TraceRing*                            ring;
+  uint64_t                              head;
+  bool                                  done;
+
+  ring = &(InTrace->rings[InWorker]);
+  while ( true ) {
+    //! done is set after the last record is added, so a head read after
+    //  seeing it is final
+    done = __atomic_load_n(&(InTrace->done), __ATOMIC_ACQUIRE);
+    head = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+    if ( ring->tail < head ) {
+      *InRecord = ring->records[ring->tail & TRACE_RING_MASK];
+      __atomic_store_n(&(ring->tail), ring->tail + 1, __ATOMIC_RELEASE);
+      return true;
+    }
+    if ( done ) {
+      return false;
+    }
+    usleep(1000);
+  }
+}
+
+/*****************************************************************************!
+ * Function : TraceGetDropped
+ *****************************************************************************/
+uint64_t
+TraceGetDropped
+(Trace* InTrace)
+{
+  uint64_t                              dropped;
+  int                                   i;
+
+  dropped = 0;
+  for ( i = 0 ; InTrace && i < InTrace->ringCount ; i++ ) {
+    dropped += __atomic_load_n(&(InTrace->rings[i].dropped), __ATOMIC_RELAXED);
+  }
+  return dropped;
+}
+
+/*****************************************************************************!
+ * Function : TraceGetOpName
+ *****************************************************************************/
+string
+TraceGetOpName
+(TraceOp InOp)
+{
+  if ( InOp < 0 || InOp >= TRACE_OP_COUNT ) {
+    return "unknown";
+  }
+  return traceOpNames[InOp];
+}
+
+/*****************************************************************************!
+ * Function : TraceReadHeader
+ *****************************************************************************/
+static bool
+TraceReadHeader
+(string InPath, FILE* InFile, TraceHeader* InHeader)
+{
+  if ( fread(InHeader, sizeof(TraceHeader), 1, InFile) != 1 ||
+       memcmp(InHeader->magic, TRACE_MAGIC, sizeof(InHeader->magic)) != 0 ) {
+    fprintf(stderr, "%s is not a trace file\n", InPath);
+    return false;
+  }
+  if ( InHeader->version != TRACE_VERSION || InHeader->recordSize != sizeof(TraceRecord) ) {
+    fprintf(stderr, "%s is a version %d trace, expected version %d\n", InPath, InHeader->version, TRACE_VERSION);
+    return false;
+  }
+  if ( InHeader->workers == 0 || InHeader->workers > 256 ) {
+    fprintf(stderr, "%s has %d workers\n", InPath, InHeader->workers);
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : TraceWriteCSV
+ *  One line per record, times in microseconds
+ *****************************************************************************/
+bool
+TraceWriteCSV
+(string InPath, FILE* InOutput)
+{
+  FILE*                                 file;
+  TraceHeader                           header;
+  TraceRecord                           records[TRACE_READ_BATCH];
+  TraceRecord*                          record;
+  size_t                                i, n;
+
+  file = fopen(InPath, "rb");
+  if ( NULL == file ) {
+    fprintf(stderr, "Could not open trace file %s : %s\n", InPath, strerror(errno));
+    return false;
+  }
+  if ( !TraceReadHeader(InPath, file, &header) ) {
+    fclose(file);
+    return false;
+  }
+  fprintf(InOutput, "timestamp,worker,op,slot,offset,size,latency,result\n");
+  while ( (n = fread(records, sizeof(TraceRecord), TRACE_READ_BATCH, file)) > 0 ) {
+    for ( i = 0 ; i < n ; i++ ) {
+      record = &(records[i]);
+      fprintf(InOutput, "%llu,%d,%s,%u,%llu,%llu,%u,%d\n",
+              (unsigned long long)record->timestamp, record->worker, TraceGetOpName((TraceOp)record->op),
+              record->slot, (unsigned long long)record->offset, (unsigned long long)record->size,
+              record->latency, record->result);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : TraceToJSON
+ *****************************************************************************/
+JSONOut*
+TraceToJSON
+(string InName, Trace* InTrace)
+{
+  JSONOut*                              object;
+
+  object = JSONOutCreateObject(InName);
+  JSONOutObjectAddObjects(object,
+                          JSONOutCreateString("path", InTrace->path),
+                          JSONOutCreateString("mode", InTrace->reading ? "replay" : "record"),
+                          JSONOutCreateLongLong("records", __atomic_load_n(&(InTrace->records), __ATOMIC_RELAXED)),
+                          JSONOutCreateLongLong("dropped", TraceGetDropped(InTrace)),
+                          NULL);
+  return object;
+}
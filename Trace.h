@@ -0,0 +1,183 @@
+/*****************************************************************************
+ * FILE NAME    : Trace.h
+ * DATE         : January 28 2021
+ * PROJECT      : NONE
+ * COPYRIGHT    : Copyright (C) 2021 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _trace_h_
+#define _trace_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/String.h"
+#include "JSONOut.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define TRACE_MAGIC                     "DSTRACE1"
+#define TRACE_VERSION                   1
+
+//! Records per ring, a power of two
+#define TRACE_RING_SIZE                 8192
+
+//! Cache line the ring head and tail are each kept on
+#define TRACE_RING_ALIGNMENT            64
+
+//! How often the writer drains the rings (microseconds)
+#define TRACE_WRITER_PERIOD             10000
+
+/*****************************************************************************!
+ * Exported Type : TraceOp
+ *  Never renumber, the values are stored in trace files
+ *****************************************************************************/
+enum _TraceOp
+{
+  TRACE_OP_CREATE                       = 0,
+  TRACE_OP_REMOVE                       = 1,
+  TRACE_OP_READ                         = 2,
+  TRACE_OP_OVERWRITE                    = 3,
+  TRACE_OP_APPEND                       = 4,
+  TRACE_OP_CLOSE                        = 5,
+  TRACE_OP_VERIFY                       = 6,
+  TRACE_OP_SYNC                         = 7,
+  TRACE_OP_CREATE_EMPTY                 = 8,
+  TRACE_OP_STAT                         = 9,
+  TRACE_OP_RENAME                       = 10,
+  TRACE_OP_SETATTR                      = 11,
+  TRACE_OP_UNLINK                       = 12,
+  TRACE_OP_COUNT
+};
+typedef enum _TraceOp TraceOp;
+
+/*****************************************************************************!
+ * Exported Type : TraceHeader
+ *  Start of a trace file, followed by TraceRecords to the end of the file.
+ *  Stored in host byte order.
+ *****************************************************************************/
+struct _TraceHeader
+{
+  char                                  magic[8];
+  uint32_t                              version;
+  uint32_t                              recordSize;
+  uint32_t                              workers;
+  uint32_t                              maxFiles;
+  uint32_t                              appendFiles;
+  uint32_t                              reserved;
+  uint64_t                              maxFileSize;
+  uint64_t                              startTime;
+};
+typedef struct _TraceHeader TraceHeader;
+
+/*****************************************************************************!
+ * Exported Type : TraceRecord
+ *  One operation.  timestamp is when it started, in microseconds from the
+ *  start of the trace.  offset is the target slot of a rename and the mode
+ *  of a setattr, 0 meaning the times were set.  result is 0 or a negative
+ *  error.
+ *****************************************************************************/
+struct _TraceRecord
+{
+  uint64_t                              timestamp;
+  uint64_t                              offset;
+  uint64_t                              size;
+  uint32_t                              slot;
+  uint32_t                              latency;
+  int32_t                               result;
+  uint8_t                               op;
+  uint8_t                               worker;
+  uint16_t                              reserved;
+};
+typedef struct _TraceRecord TraceRecord;
+
+/*****************************************************************************!
+ * Exported Type : TraceRing
+ *  Single producer, single consumer.  Recording, each worker is the only
+ *  producer of its ring and the writer thread the consumer.  Replaying, the
+ *  reader thread produces and the worker consumes.  head and tail are kept
+ *  on separate cache lines, so the rings are allocated TRACE_RING_ALIGNMENT
+ *  aligned.
+ *****************************************************************************/
+struct _TraceRing
+{
+  uint64_t                              head __attribute__((aligned(TRACE_RING_ALIGNMENT)));
+  uint64_t                              tail __attribute__((aligned(TRACE_RING_ALIGNMENT)));
+  uint64_t                              dropped;
+  TraceRecord*                          records;
+};
+typedef struct _TraceRing TraceRing;
+
+/*****************************************************************************!
+ * Exported Type : Trace
+ *  A trace being recorded to, or replayed from, path
+ *****************************************************************************/
+struct _Trace
+{
+  string                                path;
+  FILE*                                 file;
+  bool                                  reading;
+  TraceHeader                           header;
+  int                                   ringCount;
+  TraceRing*                            rings;
+  pthread_t                             threadID;
+  bool                                  running;
+  bool                                  done;
+  uint64_t                              startTime;
+  uint64_t                              records;
+};
+typedef struct _Trace Trace;
+
+/*****************************************************************************!
+ * Exported Data
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+Trace*
+TraceCreate
+(string InPath, int InWorkers, uint32_t InMaxFiles, uint64_t InMaxFileSize, uint32_t InAppendFiles);
+
+void
+TraceAdd
+(Trace* InTrace, int InWorker, TraceOp InOp, uint32_t InSlot, uint64_t InOffset, uint64_t InSize,
+ uint64_t InLatency, int32_t InResult);
+
+void
+TraceClose
+(Trace* InTrace);
+
+Trace*
+TraceOpen
+(string InPath);
+
+bool
+TraceNext
+(Trace* InTrace, int InWorker, TraceRecord* InRecord);
+
+uint64_t
+TraceGetDropped
+(Trace* InTrace);
+
+string
+TraceGetOpName
+(TraceOp InOp);
+
+bool
+TraceWriteCSV
+(string InPath, FILE* InOutput);
+
+JSONOut*
+TraceToJSON
+(string InName, Trace* InTrace);
+
+#endif // _trace_h_
@@ -29,6 +29,8 @@
 #include "DiskStressThread.h"
 #include "DiskInformation.h"
 #include "FileInfoBlock.h"
+#include "ThreadAffinity.h"
+#include "GeneralUtilities/MemoryManager.h"
 
 /*****************************************************************************!
  * Local Macros
@@ -119,6 +121,8 @@ UserInputServerThread
 {
   StringList*                           command;
   string                                userInputString;
+
+  ThreadAffinityApplyServer("userinput");
   while (true) {
     userInputString = linenoise(UserInputCommandPrompt);
     command = UserInputParseCommandLine(userInputString);
@@ -458,13 +462,13 @@ UserInputProcessCommandFile
 (StringList* InCommand)
 {
   string                                subCommand;
-  int                                   n;
+  uint64_t                              n;
   if ( NULL == InCommand ) {
     return;
   }
   if ( InCommand->stringCount == 1 ) {
     n = DiskStressGetFileCount();
-    printf("%sFiles Created : %s%s%d%s\n", ColorYellow, ColorReset, ColorGreen, n, ColorReset);
+    printf("%sFiles Created : %s%s%llu%s\n", ColorYellow, ColorReset, ColorGreen, (unsigned long long)n, ColorReset);
     return;
   }
   subCommand = InCommand->strings[1];
@@ -504,23 +508,25 @@ void
 UserInputProcessCommandMap
 (StringList* InCommand)
 {
-  int                                   mapSize;
+  int64_t                               mapSize;
   uint64_t*                             map;
-  int                                   i, n, j, k, m;
+  int64_t                               i, k, m;
+  int                                   j;
+  uint64_t                              n;
   bool                                  t;
-  int									fileSetSize;
+  int64_t								fileSetSize;
 
   FileInfoBlockSetGetMap(&mapSize, &map);
   fileSetSize = FileInfoBlockSetGetSize();
 
-  printf("Map Size : %d\n", fileSetSize);
+  printf("Map Size : %lld\n", (long long)fileSetSize);
   printf("      0 : ");
   fflush(stdout);
   k = 0;
   m = 0;
   for ( i = 0 ; i < mapSize ; i++ ) {
 	for ( j = 0 ; j < 64 ; j++ ) {
-	  n = 1 << j;
+	  n = (uint64_t)1 << j;
 	  t = map[i] & n ? true : false;
 	  printf("%c", t ? '@' : '.');
 	  fflush(stdout);
@@ -536,8 +542,9 @@ UserInputProcessCommandMap
 	m += 64;
 	printf("\n");
 	if ( i + 1 < mapSize ) {
-	  printf("%7d : ", m);
+	  printf("%7lld : ", (long long)m);
 	}
   }
+  FreeMemory(map);
 }
 
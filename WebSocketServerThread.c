@@ -41,6 +41,7 @@
 #include "Log.h"
 #include "FileInfoBlock.h"
 #include "GeneralUtilities/NumericTypes.h"
+#include "ThreadAffinity.h"
 
 /*****************************************************************************!
  * Local Macros
@@ -189,6 +190,7 @@ void*
 WebSocketServerThread
 (void* InParameters)
 {
+  ThreadAffinityApplyServer("websocket");
   mg_mgr_init(&WebSocketManager, NULL);
   WebSocketConnection = mg_bind(&WebSocketManager, WebSocketPortAddress, WebSocketServerEventHandler);
   if ( NULL == WebSocketConnection ) {
@@ -450,6 +452,7 @@ WebSocketCreateServerInfoSection
                           JSONOutCreateInt("upminutes", minutes),
                           JSONOutCreateInt("upseconds", seconds),
                           JSONOutCreateInt("elapsedtime", elapsedSeconds),
+                          ThreadAffinityToJSON("affinity"),
                           NULL);
   return jsonout;
 
@@ -579,14 +582,17 @@ WebSocketCreateFileInfoSection
 ()
 {
   JSONOut*                              fileInfo;
-  char                                  s1[32], s2[32], s3[32], s4[32];
+  char                                  s1[32], s2[32], s3[32], s4[32], s5[32], s6[32], s7[32];
 
   fileInfo = JSONOutCreateObject("fileinfo");
   JSONOutObjectAddObjects(fileInfo,
                           JSONOutCreateString("size",      ConvertLongLongToCommaString(DiskStressGetFileSize(), s1)),
-                          JSONOutCreateString("count",     ConvertIntToCommaString(DiskStressGetFileCount(), s2)),
-                          JSONOutCreateString("created",   ConvertIntToCommaString(DiskStressThreadGetFilesCreatedCount(), s3)),
-                          JSONOutCreateString("destroyed", ConvertIntToCommaString(DiskStressThreadGetFilesRemovedCount(), s4)),
+                          JSONOutCreateString("count",     ConvertLongLongToCommaString(DiskStressGetFileCount(), s2)),
+                          JSONOutCreateString("created",   ConvertLongLongToCommaString(DiskStressThreadGetFilesCreatedCount(), s3)),
+                          JSONOutCreateString("destroyed", ConvertLongLongToCommaString(DiskStressThreadGetFilesRemovedCount(), s4)),
+                          JSONOutCreateString("overwritten", ConvertLongLongToCommaString(DiskStressThreadGetOverwriteCount(), s5)),
+                          JSONOutCreateString("bytesoverwritten", ConvertLongLongToCommaString(DiskStressThreadGetBytesOverwritten(), s6)),
+                          JSONOutCreateString("overwritelatency", ConvertLongLongToCommaString(DiskStressThreadGetOverwriteLatency(), s7)),
                           NULL);
   return fileInfo;
 }
@@ -606,12 +612,14 @@ WebSocketHandleInit
   JSONOut*                              sizeInfo;
   JSONOut*                              serverInfo;
   JSONOut*                              stressInfo;
+  JSONOut*                              config;
   char                                  s1[32], s2[32];
 
   sizeInfo = JSONOutCreateObject("filesizeinfo");
   JSONOutObjectAddObjects(sizeInfo,
                           JSONOutCreateString("maxfiles",    ConvertLongLongToCommaString(DiskStressThreadGetMaxFiles(),s1)),
                           JSONOutCreateLongLong("maxfilesint", DiskStressThreadGetMaxFiles()),
+                          JSONOutCreateInt("mapcells", FileInfoBlockSetGetMapCells()),
                           JSONOutCreateString("maxfilesize", ConvertLongLongToCommaString(DiskStressThreadGetMaxFileSize(), s2)),
                           NULL);
 
@@ -620,8 +628,9 @@ WebSocketHandleInit
   serverInfo = WebSocketCreateServerInfoSection();
   diskInfo = DiskInformationToJSON();
   stressInfo = DiskStressThreadStressInfoToJSON();
+  config = DiskStressThreadConfigToJSON();
   body = JSONOutCreateObject("body");
-  JSONOutObjectAddObjects(body, serverInfo, diskInfo, fileInfo, sizeInfo, stressInfo, NULL);
+  JSONOutObjectAddObjects(body, serverInfo, diskInfo, fileInfo, sizeInfo, stressInfo, config, NULL);
   JSONOutObjectAddObjects(object,
                           JSONOutCreateString("packettype", "response"),
                           JSONOutCreateInt("packetid", JSONIFGetInt(InJSONDoc, "packetid")),
@@ -1,29 +1,64 @@
+ArrivalSchedule.o: ArrivalSchedule.c ArrivalSchedule.h \
+ GeneralUtilities/String.h Random.h
+BlockTarget.o: BlockTarget.c BlockTarget.h GeneralUtilities/String.h \
+ JSONOut.h GeneralUtilities/MemoryManager.h
+Checksum.o: Checksum.c Checksum.h
 DiskInformation.o: DiskInformation.c DiskInformation.h JSONOut.h \
  GeneralUtilities/String.h GeneralUtilities/NumericTypes.h
 DiskStressThread.o: DiskStressThread.c DiskStressThread.h \
  GeneralUtilities/String.h JSONOut.h GeneralUtilities/ANSIColors.h \
  UserInputServerThread.h FileInfoBlock.h GeneralUtilities/MemoryManager.h \
- DiskInformation.h Log.h
+ DiskInformation.h Log.h TimeStamp.h IOURingEngine.h IOURing.h \
+ LatencyHistogram.h FileSizeDistribution.h RateLimiter.h \
+ ArrivalSchedule.h BlockTarget.h Checksum.h FileNamespace.h Random.h \
+ Trace.h ThreadAffinity.h SlotBitmap.h SlotMemory.h
 FileInfoBlock.o: FileInfoBlock.c FileInfoBlock.h \
- GeneralUtilities/String.h JSONOut.h GeneralUtilities/MemoryManager.h
+ GeneralUtilities/String.h JSONOut.h BlockTarget.h Checksum.h FileNamespace.h SlotBitmap.h Random.h SlotMemory.h \
+ GeneralUtilities/MemoryManager.h TimeStamp.h
+FileNamespace.o: FileNamespace.c FileNamespace.h GeneralUtilities/String.h \
+ GeneralUtilities/MemoryManager.h
+FileSizeDistribution.o: FileSizeDistribution.c FileSizeDistribution.h \
+ GeneralUtilities/String.h JSONOut.h Random.h \
+ GeneralUtilities/MemoryManager.h
 HTTPServerThread.o: HTTPServerThread.c HTTPServerThread.h \
  GeneralUtilities/String.h GeneralUtilities/ANSIColors.h \
  WebSocketServerThread.h RPiBaseModules/mongoose.h \
- GeneralUtilities/MemoryManager.h Log.h
+ GeneralUtilities/MemoryManager.h Log.h ThreadAffinity.h
+IOURing.o: IOURing.c IOURing.h GeneralUtilities/MemoryManager.h
+IOURingEngine.o: IOURingEngine.c IOURingEngine.h IOURing.h FileInfoBlock.h \
+ GeneralUtilities/String.h JSONOut.h BlockTarget.h Checksum.h FileNamespace.h SlotBitmap.h Random.h SlotMemory.h \
+ GeneralUtilities/MemoryManager.h TimeStamp.h
+JobFile.o: JobFile.c JobFile.h GeneralUtilities/String.h \
+ GeneralUtilities/MemoryManager.h
 JSONIF.o: JSONIF.c RPiBaseModules/json.h GeneralUtilities/String.h \
  GeneralUtilities/MemoryManager.h JSONIF.h
 JSONOut.o: JSONOut.c JSONOut.h GeneralUtilities/String.h \
  GeneralUtilities/MemoryManager.h
+LatencyHistogram.o: LatencyHistogram.c LatencyHistogram.h \
+ GeneralUtilities/String.h JSONOut.h
 Log.o: Log.c Log.h GeneralUtilities/String.h \
  GeneralUtilities/MemoryManager.h
 main.o: main.c main.h UserInputServerThread.h WebSocketServerThread.h \
  GeneralUtilities/String.h DiskStressThread.h JSONOut.h \
- HTTPServerThread.h DiskInformation.h GeneralUtilities/MemoryManager.h \
- GeneralUtilities/ANSIColors.h GeneralUtilities/NumericTypes.h Log.h
+ HTTPServerThread.h DiskInformation.h JobFile.h Trace.h ThreadAffinity.h \
+ SlotMemory.h GeneralUtilities/MemoryManager.h GeneralUtilities/ANSIColors.h \
+ GeneralUtilities/NumericTypes.h Log.h
+Random.o: Random.c Random.h
+RateLimiter.o: RateLimiter.c RateLimiter.h GeneralUtilities/MemoryManager.h \
+ TimeStamp.h
+SlotBitmap.o: SlotBitmap.c SlotBitmap.h Random.h SlotMemory.h \
+ GeneralUtilities/MemoryManager.h
+SlotMemory.o: SlotMemory.c SlotMemory.h GeneralUtilities/MemoryManager.h
+ThreadAffinity.o: ThreadAffinity.c ThreadAffinity.h GeneralUtilities/String.h \
+ JSONOut.h GeneralUtilities/MemoryManager.h GeneralUtilities/ANSIColors.h Log.h
+TimeStamp.o: TimeStamp.c TimeStamp.h
+Trace.o: Trace.c Trace.h GeneralUtilities/String.h JSONOut.h \
+ GeneralUtilities/MemoryManager.h TimeStamp.h ThreadAffinity.h
 UserInputServerThread.o: UserInputServerThread.c UserInputServerThread.h \
  GeneralUtilities/String.h RPiBaseModules/linenoise.h HTTPServerThread.h \
  GeneralUtilities/ANSIColors.h DiskStressThread.h JSONOut.h \
- DiskInformation.h FileInfoBlock.h
+ DiskInformation.h FileInfoBlock.h BlockTarget.h Checksum.h FileNamespace.h SlotBitmap.h Random.h SlotMemory.h \
+ ThreadAffinity.h GeneralUtilities/MemoryManager.h
 WebConnection.o: WebConnection.c WebConnection.h \
  RPiBaseModules/mongoose.h GeneralUtilities/MemoryManager.h \
  GeneralUtilities/String.h
@@ -31,4 +66,5 @@ WebSocketServerThread.o: WebSocketServerThread.c WebSocketServerThread.h \
  GeneralUtilities/String.h GeneralUtilities/ANSIColors.h \
  DiskStressThread.h JSONOut.h RPiBaseModules/mongoose.h WebConnection.h \
  JSONIF.h RPiBaseModules/json.h GeneralUtilities/MemoryManager.h \
- DiskInformation.h Log.h FileInfoBlock.h GeneralUtilities/NumericTypes.h
+ DiskInformation.h Log.h FileInfoBlock.h BlockTarget.h Checksum.h FileNamespace.h SlotBitmap.h Random.h SlotMemory.h \
+ GeneralUtilities/NumericTypes.h ThreadAffinity.h
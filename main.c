@@ -14,6 +14,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <pthread.h>
+#include <errno.h>
 
 /*****************************************************************************!
  * Local Headers
@@ -24,6 +25,10 @@
 #include "DiskStressThread.h"
 #include "HTTPServerThread.h"
 #include "DiskInformation.h"
+#include "JobFile.h"
+#include "Trace.h"
+#include "ThreadAffinity.h"
+#include "SlotMemory.h"
 #include "GeneralUtilities/String.h"
 #include "GeneralUtilities/MemoryManager.h"
 #include "GeneralUtilities/ANSIColors.h"
@@ -40,6 +45,15 @@
 static string
 mainProgramName = "diskstress";
 
+//! Job file keys that are options without an argument
+static string
+mainJobFileFlags[] = { "direct", "verify", "replay-fast", NULL };
+
+//! Job file keys a phase may change, the rest are fixed for the run
+static string
+mainJobFilePhaseKeys[] = { "readpct", "overwritepct", "overwritesize", "hotset", "high", "low",
+                           "timesleep", "rate-mbps", "rate-iops", NULL };
+
 /*****************************************************************************!
  * Local Functions
  *****************************************************************************/
@@ -51,6 +65,14 @@ void
 MainProcessCommandLine
 (int argc, char** argv);
 
+void
+MainProcessJobFile
+(string InPath);
+
+bool
+MainJobFileKeyIn
+(string InKey, string* InKeys);
+
 /*****************************************************************************!
  * Function : main
  *****************************************************************************/
@@ -90,6 +112,8 @@ MainProcessCommandLine
   string                                command;
   int									n;
   bool									b;
+  unsigned long long                    files;
+  char*                                 end;
 
   //! Process the help request before all others
   for (i = 1; i < argc; i++) {
@@ -140,7 +164,12 @@ MainProcessCommandLine
 		MainDisplayHelp();
 		exit(EXIT_FAILURE);
 	  }
-	  DiskStressThreadSetMaxFileSize((uint64_t)n);
+	  if ( !DiskStressThreadSetMaxFileSize((uint64_t)n) ) {
+		fprintf(stderr, "%s\"%s\"%s  %sis not a valid file size%s\n",
+						ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+		MainDisplayHelp();
+		exit(EXIT_FAILURE);
+	  }
 	  continue;
 	}
 
@@ -151,14 +180,16 @@ MainProcessCommandLine
 		MainDisplayHelp();
 		exit(EXIT_FAILURE);
 	  }
-	  n = GetIntValueFromString(&b, argv[i]);
-	  if ( !b ) {
+	  //! Slot counts can go past what an int holds
+	  errno = 0;
+	  files = strtoull(argv[i], &end, 10);
+	  if ( errno || end == argv[i] || *end != 0x00 || *argv[i] == '-' ) {
 		fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
 						ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
 		MainDisplayHelp();
 		exit(EXIT_FAILURE);
 	  }
-	  DiskStressThreadSetMaxFiles((uint64_t)n);
+	  DiskStressThreadSetMaxFiles((uint64_t)files);
 	  continue;
 	}
 
@@ -187,6 +218,368 @@ MainProcessCommandLine
 	  continue;
 	}
 
+    if ( StringEqualsOneOf(command, "-S", "--sizedist", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a size distribution%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetSizeDistribution(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid size distribution%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-b", "--blocksize", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadValidateWriteBlockSize((uint32_t)n) ) {
+        fprintf(stderr, "%s%s%s %smust be between %s%d%s %sand %s%d%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow,
+                ColorGreen, DiskStressThreadGetWriteBlockSizeMin(), ColorReset,
+                ColorYellow, ColorGreen, DiskStressThreadGetWriteBlockSizeMax(), ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetWriteBlockSize((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-D", "--direct", NULL) ) {
+      DiskStressThreadSetDirectIO(true);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-v", "--verify", NULL) ) {
+      DiskStressThreadSetVerify(true);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-r", "--readpct", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadValidateReadPercent(n) ) {
+        fprintf(stderr, "%s%s%s %smust be between %s0%s %sand %s100%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow,
+                ColorGreen, ColorReset, ColorYellow, ColorGreen, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetReadPercent(n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-R", "--readsize", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetReadSize((uint64_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-P", "--overwritepct", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 || n > 100 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sis not a valid percentage%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetOverwritePercent(n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-B", "--overwritesize", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 1 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetOverwriteSize((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-H", "--hotset", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a hot set%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetHotSet(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid hot set%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-a", "--append", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetAppendChunk((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-O", "--appendfiles", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 1 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sis not a valid number of files%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetAppendFiles(n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-s", "--sync", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a sync policy%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetSyncPolicy(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid sync policy%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-M", "--rate-mbps", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetRateMBps((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-I", "--rate-iops", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetRateIOPS((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-A", "--arrival", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an arrival schedule%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetArrival(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid arrival schedule%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-e", "--engine", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an engine name%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetEngine(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid engine%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-q", "--iodepth", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadValidateIODepth((uint32_t)n) ) {
+        fprintf(stderr, "%s%s%s %smust be between %s1%s %sand %s%d%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorGreen, ColorReset,
+                ColorYellow, ColorGreen, DiskStressThreadGetIODepthMax(), ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetIODepth((uint32_t)n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-W", "--workers", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an integer%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadValidateWorkerCount(n) ) {
+        fprintf(stderr, "%s%s%s %smust be between %s1%s %sand %s%d%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorGreen, ColorReset,
+                ColorYellow, ColorGreen, DiskStressThreadGetWorkerCountMax(), ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetWorkerCount(n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-C", "--cpus", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a CPU list%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !ThreadAffinitySetWorkerCPUs(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid CPU list%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-n", "--server-cpus", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a CPU list%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !ThreadAffinitySetServerCPUs(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid CPU list%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-p", "--ioprio", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an I/O priority list%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !ThreadAffinitySetWorkerIOPriority(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid I/O priority list%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-G", "--hugepages", NULL) ) {
+      SlotMemorySetHugePages(true);
+      continue;
+    }
+
     if ( StringEqualsOneOf(command, "-o", "--low", NULL) ) {
       i++;
       if ( i == argc ) {
@@ -230,15 +623,285 @@ MainProcessCommandLine
         MainDisplayHelp();
         exit(EXIT_FAILURE);
       }
-      DiskStressThreadSetDirectory(argv[i]);      
+      if ( !DiskStressThreadSetDirectory(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid directory list%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-T", "--target", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a device or image file name%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetTarget(argv[i], false);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-N", "--image", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires an image file name%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetTarget(argv[i], true);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-Z", "--release", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires discard or zero%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetTargetRelease(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not discard or zero%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-F", "--fanout", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a fan out%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetFanout(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid fan out%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-g", "--seed", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a seed%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetSeed(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s  %sdoes not appear to be an unsigned integer%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-x", "--metadata", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires on or an operation mix%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( !DiskStressThreadSetMetadata(argv[i]) ) {
+        fprintf(stderr, "%s\"%s\"%s %sis not a valid operation mix%s\n", ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-u", "--duration", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a number of seconds%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      n = GetIntValueFromString(&b, argv[i]);
+      if ( !b || n < 0 ) {
+        fprintf(stderr, "%s\"%s\"%s  %sis not a number of seconds%s\n",
+                ColorRed, argv[i], ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetDuration(n);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-j", "--job", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a filename%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      MainProcessJobFile(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-k", "--trace", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a filename%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetTrace(argv[i]);
       continue;
     }
+
+    if ( StringEqualsOneOf(command, "-y", "--replay", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a filename%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      DiskStressThreadSetReplay(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-Y", "--replay-fast", NULL) ) {
+      DiskStressThreadSetReplayFast(true);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-c", "--trace2csv", NULL) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s\"%s\"%s %srequires a filename%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
+        MainDisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      exit(TraceWriteCSV(argv[i], stdout) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
     fprintf(stderr, "%s\"%s\"%s %sis not a valid command%s\n", ColorRed, command, ColorReset, ColorYellow, ColorReset);
     MainDisplayHelp();
     exit(EXIT_FAILURE);
   }
 }
 
+/*****************************************************************************!
+ * Function : MainProcessJobFile
+ *  Each section of the job file is turned back into command line options,
+ *  key = value becoming --key value, and run through MainProcessCommandLine
+ *  in file order.  A phase is the settings in force after its section, so
+ *  phases build on each other.
+ *****************************************************************************/
+void
+MainProcessJobFile
+(string InPath)
+{
+  JobFile*                              jobFile;
+  JobFileSection*                       section;
+  JobFileEntry*                         entry;
+  char**                                args;
+  int                                   argCount;
+  int                                   i, j, n;
+  int                                   duration;
+  bool                                  b, openPhase;
+
+  jobFile = JobFileLoad(InPath);
+  if ( NULL == jobFile ) {
+    exit(EXIT_FAILURE);
+  }
+  DiskStressThreadSetJobFile(InPath);
+  openPhase = false;
+
+  for ( i = 0 ; i < jobFile->sectionCount ; i++ ) {
+    section = &(jobFile->sections[i]);
+    if ( section->phase && openPhase ) {
+      fprintf(stderr, "%s%s:%d%s %sonly the last phase can leave out its duration%s\n",
+              ColorRed, InPath, section->line, ColorReset, ColorYellow, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+    args = (char**)GetMemory(sizeof(char*) * (section->entryCount * 2 + 1));
+    args[0] = InPath;
+    argCount = 1;
+    duration = -1;
+
+    for ( j = 0 ; j < section->entryCount ; j++ ) {
+      entry = &(section->entries[j]);
+      if ( StringEqualsOneOf(entry->key, "job", "help", "trace2csv", NULL) ) {
+        fprintf(stderr, "%s%s:%d%s %s%s can not be used in a job file%s\n",
+                ColorRed, InPath, entry->line, ColorReset, ColorYellow, entry->key, ColorReset);
+        exit(EXIT_FAILURE);
+      }
+      if ( section->phase && StringEqual(entry->key, "duration") ) {
+        n = GetIntValueFromString(&b, entry->value);
+        if ( !b || n < 0 ) {
+          fprintf(stderr, "%s%s:%d%s %s\"%s\" is not a number of seconds%s\n",
+                  ColorRed, InPath, entry->line, ColorReset, ColorYellow, entry->value, ColorReset);
+          exit(EXIT_FAILURE);
+        }
+        duration = n;
+        continue;
+      }
+      if ( section->phase && !MainJobFileKeyIn(entry->key, mainJobFilePhaseKeys) ) {
+        fprintf(stderr, "%s%s:%d%s %s%s can not change between phases%s\n",
+                ColorRed, InPath, entry->line, ColorReset, ColorYellow, entry->key, ColorReset);
+        exit(EXIT_FAILURE);
+      }
+      if ( MainJobFileKeyIn(entry->key, mainJobFileFlags) ) {
+        if ( JobFileIsFalse(entry->value) ) {
+          continue;
+        }
+        if ( !JobFileIsTrue(entry->value) ) {
+          fprintf(stderr, "%s%s:%d%s %s%s is on or off%s\n",
+                  ColorRed, InPath, entry->line, ColorReset, ColorYellow, entry->key, ColorReset);
+          exit(EXIT_FAILURE);
+        }
+      }
+      args[argCount] = (char*)GetMemory(strlen(entry->key) + 3);
+      sprintf(args[argCount++], "--%s", entry->key);
+      if ( !MainJobFileKeyIn(entry->key, mainJobFileFlags) && *entry->value ) {
+        args[argCount++] = StringCopy(entry->value);
+      }
+    }
+
+    MainProcessCommandLine(argCount, args);
+    for ( j = 1 ; j < argCount ; j++ ) {
+      FreeMemory(args[j]);
+    }
+    FreeMemory(args);
+
+    if ( !section->phase ) {
+      continue;
+    }
+    if ( duration < 0 ) {
+      duration = 0;
+      openPhase = true;
+    }
+    if ( !DiskStressThreadAddPhase(section->name, duration) ) {
+      fprintf(stderr, "%s%s:%d%s %stoo many phases%s\n",
+              ColorRed, InPath, section->line, ColorReset, ColorYellow, ColorReset);
+      exit(EXIT_FAILURE);
+    }
+  }
+  DiskStressThreadEndJobFile();
+  JobFileDestroy(jobFile);
+}
+
+/*****************************************************************************!
+ * Function : MainJobFileKeyIn
+ *****************************************************************************/
+bool
+MainJobFileKeyIn
+(string InKey, string* InKeys)
+{
+  int                                   i;
+
+  for ( i = 0 ; InKeys[i] ; i++ ) {
+    if ( StringEqual(InKey, InKeys[i]) ) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /*****************************************************************************!
  * Function : MainDisplayHelp
  *****************************************************************************/
@@ -252,8 +915,25 @@ MainDisplayHelp
 
   fprintf(stdout, "        %s-l, --logfile %s  : %sSpecify the log file name%s\n", 
 				  ColorGreen, ColorReset, ColorYellow, ColorReset);
-  fprintf(stdout, "        %s-d, --directory %s  : %sSpecify the file base directory%s\n", 
+  fprintf(stdout, "        %s-j, --job         %s: %sRead the options from a job file, [global] and [phase <name>] sections\n"
+                  "                             of <long option> = <value> lines, a phase can set duration = <seconds>%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-u, --duration    %s: %sStop after this many seconds, 0 runs until stopped (default 0)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-k, --trace       %s: %sRecord every operation to a binary trace file%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-y, --replay      %s: %sReplay the operations in a trace file at their original times%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-Y, --replay-fast %s: %sReplay as fast as possible instead%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-c, --trace2csv   %s: %sWrite a trace file to standard output as CSV and exit%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-d, --directory %s  : %sSpecify the file base directory, a comma separated list\n"
+                  "                             drives each directory with its own files and workers%s\n", 
 				  ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-F, --fanout      %s: %sSpread the files over subdirectories, <levels>:<width>,\n"
+                  "                             2:256 is two levels of 256 directories (default flat)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
 
 
   fprintf(stdout, "        %s-w, --webdir    %s  : %sSpecify the www files base directory%s\n", 
@@ -262,6 +942,67 @@ MainDisplayHelp
 		          ColorGreen, ColorReset, ColorYellow, ColorReset);
   fprintf(stdout, "        %s-m, --maxfilesize %s: %sSpecify the maximum size of files created%s\n",
 		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-S, --sizedist    %s: %sSpecify the file size distribution, replaces --maxfilesize\n"
+                  "                             fixed:<size>, uniform:<min>-<max>, lognormal:<median>,<sigma>,\n"
+                  "                             bimodal:<small>,<large>,<large percent> or table:<size>:<weight>,...%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-b, --blocksize   %s: %sSpecify the size of each write call in bytes (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetWriteBlockSize(), ColorReset);
+  fprintf(stdout, "        %s-D, --direct      %s: %sWrite files with O_DIRECT, bypassing the page cache%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-v, --verify      %s: %sWrite a checksummed pattern and read each file back before removing it%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-r, --readpct     %s: %sSpecify the percentage of operations that read an existing file (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetReadPercent(), ColorReset);
+  fprintf(stdout, "        %s-R, --readsize    %s: %sSpecify the bytes read at a random offset, 0 reads the whole file (default 0)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-P, --overwritepct%s: %sSpecify the percentage of operations that overwrite part of an existing file (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetOverwritePercent(), ColorReset);
+  fprintf(stdout, "        %s-B, --overwritesize%s: %sSpecify the bytes rewritten by each overwrite (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetOverwriteSize(), ColorReset);
+  fprintf(stdout, "        %s-H, --hotset      %s: %sSend a share of the overwrites to a share of the files,\n"
+                  "                             <percent of overwrites>:<percent of files> (default uniform)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-a, --append      %s: %sGrow files by appends of this many bytes instead of writing them in one go (default 0)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-O, --appendfiles %s: %sSpecify the number of files each worker grows at once (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetAppendFiles(), ColorReset);
+  fprintf(stdout, "        %s-x, --metadata    %s: %sCreate, stat, rename, chmod/utime and unlink empty files instead of writing data,\n"
+                  "                             on or <create>:<stat>:<rename>:<setattr>:<unlink> weights (default 30:30:10:10:20)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-s, --sync        %s: %sSpecify the sync policy, none, fsync, fdatasync, osync, odsync,\n"
+                  "                             everyn:<files> or everyms:<milliseconds> (default none)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-M, --rate-mbps   %s: %sLimit reads and writes to this many MB/s, replaces --timesleep%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-I, --rate-iops   %s: %sLimit creates, removes and reads to this many per second, replaces --timesleep%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-A, --arrival     %s: %sStart operations on an open loop schedule, poisson:<ops/s> or fixed:<ops/s>%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-T, --target      %s: %sUse an existing block device or image file as a flat address space instead of files%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-N, --image       %s: %sUse an image file as the target, created sparse if it does not exist%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-Z, --release     %s: %sSpecify what a delete does to a target extent, discard or zero (default discard)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-e, --engine      %s: %sSpecify the I/O engine, sync or iouring (default sync)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-q, --iodepth     %s: %sSpecify the number of io_uring operations in flight (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetIODepth(), ColorReset);
+  fprintf(stdout, "        %s-W, --workers     %s: %sSpecify the number of stress worker threads (default %d)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetWorkerCount(), ColorReset);
+  fprintf(stdout, "        %s-C, --cpus        %s: %sPin the workers to CPUs, <cpu>[-<cpu>],... each worker takes\n"
+                  "                             the next CPU in the list (default unpinned)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-n, --server-cpus %s: %sKeep the web, input and monitor threads on a CPU list (default unpinned)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-p, --ioprio      %s: %sWorker I/O priorities, <class>[:<level>],... with class rt, be or idle\n"
+                  "                             and level 0-7, each worker takes the next entry (default inherited)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-G, --hugepages   %s: %sBack the slot set with transparent huge pages (default off)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
+  fprintf(stdout, "        %s-g, --seed        %s: %sSeed the workers' random number generators, the seed used is logged (default from the clock)%s\n",
+		          ColorGreen, ColorReset, ColorYellow, ColorReset);
   fprintf(stdout, "        %s-t, --timesleep   %s: %sSpecifies the number of milliseconds sleep between file creates and destroys (default %d)%s\n",
 		          ColorGreen, ColorReset, ColorYellow, DiskStressThreadGetSleepPeriod(), ColorReset);
   fprintf(stdout, "        %s-o, --low         %s: %sSpecify the low file percentage (default %d)%s\n",
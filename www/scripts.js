@@ -227,7 +227,7 @@ WebSocketIFHandleResponseInit
   WebSocketIFHandleStressInfoPacket(InPacket.stressinfo);
   clearTimeout(GetRuntimeInfoID);
   GetRuntimeInfoID = setTimeout(CBWebSocketIFGetRuntimeInfo, RuntimeInfoReadPeriod);
-  CreateBlockGrid(InPacket.filesizeinfo.maxfilesint);
+  CreateBlockGrid(InPacket.filesizeinfo.mapcells);
 }
 
 /*****************************************************************************!
@@ -306,7 +306,10 @@ WebSocketIFHandleFileInfoPacket
     { "name" : "FileInfoTotalFiles", "field" : "count" },
     { "name" : "FileInfoTotalSize", "field" : "size" },
 	{ "name" : "FileInfoCreateFiles", "field" : "created" },
-	{ "name" : "FileInfoRemovedFiles", "field" : "destroyed" }
+	{ "name" : "FileInfoRemovedFiles", "field" : "destroyed" },
+	{ "name" : "FileInfoOverwrites", "field" : "overwritten" },
+	{ "name" : "FileInfoBytesOverwritten", "field" : "bytesoverwritten" },
+	{ "name" : "FileInfoOverwriteLatency", "field" : "overwritelatency" }
   ];
   
   for (i = 0; i < elements.length; i++) {